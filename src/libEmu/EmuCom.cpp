@@ -1,4 +1,17 @@
 #include "EmuCom.h"
 
+#include <chrono>
+#include <thread>
+
 EmuCom::EmuCom() {}
 EmuCom::~EmuCom() {}
+
+void EmuCom::writeBlock32(const uint32_t *buf, uint32_t length) {
+    for (uint32_t i=0; i<length; i++)
+        this->write32(buf[i]);
+}
+
+void EmuCom::waitEmpty() {
+    while (!this->isEmpty())
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+}
@@ -94,6 +94,7 @@ void Fei4Emu::executeLoop() {
                     {
                         case 1:
     //                        printf("recieved a RdRegister command\n");
+                            handleRdRegister(chipid, address);
                             break;
                         case 2:
     //                        printf("recieved a WrRegister command\n");
@@ -263,6 +264,14 @@ void Fei4Emu::handleWrRegister(uint32_t chipid, uint32_t address, uint32_t value
     m_feCfg->cfg[address] = value;
 }
 
+void Fei4Emu::handleRdRegister(uint32_t chipid, uint32_t address) {
+    // answer with an address and a value record, bit 15 is only set for shift register reads
+    if (address >= Fei4Cfg::numRegs)
+        return;
+    addAddressRecord(address, false);
+    addValueRecord(m_feCfg->cfg[address]);
+}
+
 void Fei4Emu::handleWrFrontEnd(uint32_t chipid, uint32_t bitstream[21]) {
     // write the bitstream to our Shift Register buffer (eventually should take into consideration chipid)
     // use Fei4Cfg::Colpr_Mode to determine which dc to loop over
@@ -866,6 +866,34 @@ void Rd53aEmu::triggerAsync2( const uint32_t tag, const unsigned coreCol, const
 
 //____________________________________________________________________________________________________
 void Rd53aEmu::doWrReg( Rd53aEmu* emu ) {
+  while( emu->commandStream.empty() ) emu->retrieve();
+
+  if( cmdTo5bitPair( emu->commandStream.at(0) ).first & 0x1 ) {
+    // Big data: six words to the same address, 22 symbols in 11 frames
+    while( emu->commandStream.size() < 11 ) emu->retrieve();
+    std::array<uint8_t, 22> symbols;
+    for( unsigned i = 0; i < 11; i++ ) {
+      std::pair<uint8_t, uint8_t> bp = cmdTo5bitPair( emu->commandStream.at(i) );
+      symbols[2*i]   = bp.first;
+      symbols[2*i+1] = bp.second;
+    }
+    popCmd( emu, 11 );
+
+    uint32_t address = ( symbols[1] << 4 ) + ( symbols[2] >> 1 );
+    uint32_t bits = symbols[2] & 0x1;
+    unsigned nBits = 1;
+    for( unsigned i = 3; i < 22; i++ ) {
+      bits = ( bits << 5 ) | symbols[i];
+      nBits += 5;
+      if( nBits >= 16 ) {
+        nBits -= 16;
+        emu->m_pool->enqueue( &Rd53aEmu::writeRegAsync, emu, static_cast<uint16_t>( bits >> nBits ), address );
+        bits &= ( 1 << nBits ) - 1;
+      }
+    }
+    return;
+  }
+
   std::array<uint32_t, 3> input=readIDAddrData( emu, Rd53aEmu::Commands::WrReg );
 
   emu->m_pool->enqueue( &Rd53aEmu::writeRegAsync, emu, input[2], input[1] );
@@ -940,7 +968,11 @@ void Rd53aEmu::writeRegAsync( Rd53aEmu* emu, const uint16_t data, const uint32_t
 
 #undef pixel1
 #undef pixel2
-            
+
+            // Next pixel pair of the double column
+            if( AUTOROW ) {
+                emu->m_feCfg->PixRegionRow.write( ( ROW + 1 ) % Rd53aPixelCfg::n_Row );
+            }
         }
     }
     else { // configure the global register
@@ -54,6 +54,27 @@ void RingBuffer::write32(uint32_t word)
 //    sem_post(&read_sem);
 }
 
+void RingBuffer::writeBlock32(const uint32_t *buf, uint32_t length)
+{
+    // same as write32, but the lock is taken and the reader woken up once per block
+    std::unique_lock<std::mutex> lk(mtx);
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint32_t next = (write_index + element_size >= ringbuffer_size) ? 0 : write_index + element_size;
+        if (next == read_index)
+        {
+            // buffer is full, let the reader catch up
+            cv.notify_all();
+            cv.wait(lk, [&] { return next != read_index; });
+        }
+        memcpy(&buffer[write_index], &buf[i], element_size);
+        write_index = next;
+    }
+
+    // notify the cv that a read/write has occured
+    cv.notify_all();
+}
+
 uint32_t RingBuffer::read32()
 {
     uint32_t word;
@@ -150,3 +171,10 @@ void RingBuffer::dump()
         std::cout << "[" << i << "]\t\t0x" << std::hex << (uint32_t) *((uint32_t*) &buffer[i * element_size]) << std::dec << std::endl;
     }
 }
+
+void RingBuffer::waitEmpty()
+{
+    // every read notifies the cv
+    std::unique_lock<std::mutex> lk(mtx);
+    cv.wait(lk, [&] { return read_index == write_index; });
+}
@@ -7,9 +7,12 @@ class EmuCom {
     public:
         virtual uint32_t getCurSize() = 0;
         virtual bool isEmpty() = 0;
+        // Blocks until the other side read everything
+        virtual void waitEmpty();
         virtual uint32_t read32() = 0;
         virtual uint32_t readBlock32(uint32_t *buf, uint32_t length) = 0;
         virtual void write32(uint32_t) = 0;
+        virtual void writeBlock32(const uint32_t *buf, uint32_t length);
     protected:
         EmuCom();
         ~EmuCom();
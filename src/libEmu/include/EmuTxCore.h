@@ -28,6 +28,7 @@ class EmuTxCore : virtual public TxCore {
         EmuCom* getCom() {return m_com;}
 
         void writeFifo(uint32_t value);
+        void writeFifoBlock(const uint32_t *words, size_t length) {m_com->writeBlock32(words, length);}
         void releaseFifo() {this->writeFifo(0x0);} // Add some padding
         
         void setCmdEnable(uint32_t value) {}
@@ -53,6 +54,13 @@ class EmuTxCore : virtual public TxCore {
             bool rtn = m_com->isEmpty();
             return rtn;
         }
+        void wait(uint64_t token) override {
+            if (m_fenceDone >= token)
+                return;
+            uint64_t pending = m_fenceSubmitted;
+            m_com->waitEmpty();
+            this->fenceDone(pending);
+        }
         bool isTrigDone() {
             bool rtn = !trigProcRunning && m_com->isEmpty();
             return rtn;
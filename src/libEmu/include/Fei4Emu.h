@@ -34,6 +34,7 @@ class Fei4Emu {
         void handleTrigger();
         void handleWrFrontEnd(uint32_t chipid, uint32_t bitstream[21]);
         void handleWrRegister(uint32_t chipid, uint32_t address, uint32_t value);
+        void handleRdRegister(uint32_t chipid, uint32_t address);
         void handleRunMode(uint32_t chipid, int command);
         void handleGlobalPulse(uint32_t chipid);
 
@@ -39,11 +39,13 @@ class RingBuffer : public EmuCom {
 
 		// the main functionality of the class - write to and read from the ring buffer
 		virtual void write32(uint32_t word);
+		virtual void writeBlock32(const uint32_t *buf, uint32_t length);
 		virtual uint32_t read32();
 		virtual uint32_t readBlock32(uint32_t *buf, uint32_t length);
 
 		// useful utility functions
 		virtual bool isEmpty();
+		virtual void waitEmpty();
 		virtual uint32_t getCurSize();
 		virtual void dump();
 	private:
@@ -25,8 +25,8 @@ void Fe65p2GlobalFeedback::feedbackBinary(unsigned channel, double sign, bool la
         doneMap[channel] = true;
     }
 
-    // Unlock the mutex to let the scan proceed
-    keeper->mutexMap[channel].unlock();
+    // Let the scan proceed with this channel
+    fbChannel.post(channel);
 
 }
 
@@ -51,8 +51,7 @@ void Fe65p2GlobalFeedback::feedback(unsigned channel, double sign, bool last) {
     //    localStep[channel] = 4;
 
     // Unlock the mutex to let the scan proceed
-    std::cout << "unlock" << std::endl;
-    keeper->mutexMap[channel].unlock();
+    fbChannel.post(channel);
 
 }
 
@@ -78,19 +77,20 @@ void Fe65p2GlobalFeedback::end() {
 void Fe65p2GlobalFeedback::execPart1() {
     g_stat->set(this, cur);
     unsigned ch = 0;
-    keeper->mutexMap[ch].try_lock();
+    fbChannel.expect(ch);
     m_done = doneMap[ch];
     
 }
 
 void Fe65p2GlobalFeedback::execPart2() {
     unsigned ch = 0; // TODO hardcoded on ch0
-    keeper->mutexMap[ch].lock();
-    std::cout << "---> Received Feedback for Fe " << ch << " with value " << values[ch] << std::endl;
-    
-    dynamic_cast<Fe65p2*>(keeper->feList[ch])->setValue(m_reg, (uint16_t) values[ch]);
-    keeper->globalFe<Fe65p2>()->setValue(m_reg, (uint16_t) values[ch]);
-    keeper->globalFe<Fe65p2>()->configureGlobal();
+    while (fbChannel.next(ch)) {
+        std::cout << "---> Received Feedback for Fe " << ch << " with value " << values[ch] << std::endl;
+
+        dynamic_cast<Fe65p2*>(keeper->feList[ch])->setValue(m_reg, (uint16_t) values[ch]);
+        keeper->globalFe<Fe65p2>()->setValue(m_reg, (uint16_t) values[ch]);
+        keeper->globalFe<Fe65p2>()->configureGlobal();
+    }
     
     cur++;
 }
@@ -23,11 +23,12 @@ void Fe65p2PixelFeedback::feedback(unsigned channel, Histo2d *h) {
         std::cout << __PRETTY_FUNCTION__ 
             << " --> ERROR : Wrong type of feedback histogram on channel " << channel << std::endl;
         doneMap[channel] = true;
+        delete h;
     } else {
         fbHistoMap[channel] = h;
     }
 
-    keeper->mutexMap[channel].unlock();
+    fbChannel.post(channel);
 }
 
 void Fe65p2PixelFeedback::setPixel(unsigned channel, unsigned col, unsigned row, unsigned val) {
@@ -116,14 +117,15 @@ void Fe65p2PixelFeedback::end() {
 void Fe65p2PixelFeedback::execPart1() {
     g_stat->set(this, cur);
     unsigned ch = 0; // hardcoded TODO
-    keeper->mutexMap[ch].try_lock();
+    fbChannel.expect(ch);
     this->writePixelCfg(ch);
 }
 
 void Fe65p2PixelFeedback::execPart2() {
     unsigned ch = 0;
-    keeper->mutexMap[ch].lock();
-    this->addFeedback(ch);
+    while (fbChannel.next(ch)) {
+        this->addFeedback(ch);
+    }
 
     // Execute last step twice to get full range
     if (step == 1 && oldStep == 1)
@@ -40,6 +40,8 @@ void Fe65p2TriggerLoop::end() {
 
 void Fe65p2TriggerLoop::execPart1() {
     //std::cout << " Trigger Loop" << std::endl;
+    // The previous stage may still be read out
+    LoopActionBase::waitDrained();
     // Enable Trigger
     g_tx->setTrigEnable(0x1);
 
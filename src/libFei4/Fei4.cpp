@@ -8,6 +8,9 @@
 
 #include "AllChips.h"
 #include "Fei4.h"
+#include <algorithm>
+
+std::array<std::atomic<unsigned>, Fei4PixelCfg::n_Bits> Fei4::broadcastLoads{};
 
 bool fei4_registered =
 StdDict::registerFrontEnd("FEI4B",
@@ -68,6 +71,7 @@ void Fei4::init(HwController *arg_core, unsigned arg_txChannel, unsigned arg_rxC
 
 void Fei4::configure() {
     this->configureGlobal();
+    this->resetPixelShadow();
     this->configurePixels();
 }
 
@@ -78,9 +82,10 @@ void Fei4::configureGlobal() {
     uint16_t tmp = getValue(&Fei4::Vthin_Coarse);
     writeRegister(&Fei4::Vthin_Coarse, 255);
 
-    for (unsigned i=0; i<numRegs; i++) {
-        wrRegister(chipId, i, cfg[i]);
-    }
+    RegisterTransaction trans;
+    for (unsigned i=0; i<numRegs; i++)
+        trans.add(i);
+    this->commit(trans);
 
     // Request all Service Records
     writeRegister(&Fei4::ReadErrorReq, 0x1);
@@ -94,6 +99,29 @@ void Fei4::configureGlobal() {
 }
 
 void Fei4::configurePixels(unsigned lsb, unsigned msb) {
+    // Latches overwritten by a broadcast since our last write
+    for (unsigned bit=lsb; bit<msb; bit++) {
+        if (m_broadcastLoadsSeen[bit] != broadcastLoads[bit])
+            m_pixShadowValid[bit] = false;
+    }
+
+    // Find the DC/latch combinations which changed
+    std::array<unsigned, Fei4PixelCfg::n_DC> dirty;
+    bool any = false;
+    for (unsigned dc=0; dc<Fei4PixelCfg::n_DC; dc++) {
+        dirty[dc] = 0;
+        for (unsigned bit=lsb; bit<msb; bit++) {
+            uint32_t *stream = getCfg(bit, dc);
+            std::array<uint32_t, Fei4PixelCfg::n_Words> &shadow = m_pixShadow[bit][dc];
+            if (!m_pixShadowValid[bit] || !std::equal(shadow.begin(), shadow.end(), stream)) {
+                dirty[dc] |= 1 << bit;
+                any = true;
+            }
+        }
+    }
+    if (!any)
+        return;
+
     // Increase threshold
     uint16_t tmp = getValue(&Fei4::Vthin_Coarse);
     writeRegister(&Fei4::Vthin_Coarse, 255);
@@ -101,18 +129,33 @@ void Fei4::configurePixels(unsigned lsb, unsigned msb) {
     // Write Pixel Mask
     writeRegister(&Fei4::Colpr_Mode, 0x0);
     for (unsigned dc=0; dc<Fei4PixelCfg::n_DC; dc++) {
+        if (dirty[dc] == 0)
+            continue;
         writeRegister(&Fei4::Colpr_Addr, dc);
         for (unsigned bit=lsb; bit<msb; bit++) {
-            wrFrontEnd(chipId, getCfg(bit, dc));
-            loadIntoPixel(1 << bit);
-            while(core->isCmdEmpty() == 0);
+            if (!(dirty[dc] & (1 << bit)))
+                continue;
+            uint32_t *stream = getCfg(bit, dc);
+            wrFrontEnd(chipId, stream);
+            copyIntoLatches(1 << bit);
+            std::copy(stream, stream+Fei4PixelCfg::n_Words, m_pixShadow[bit][dc].begin());
+            core->fence();
         }
     }
+    for (unsigned bit=lsb; bit<msb; bit++) {
+        m_pixShadowValid[bit] = true;
+        m_broadcastLoadsSeen[bit] = broadcastLoads[bit];
+    }
+
     // Set actual threshold
     setValue(&Fei4::Vthin_Coarse, tmp);
     writeRegister(&Fei4::Vthin_Coarse);
 }
 
+void Fei4::resetPixelShadow() {
+    m_pixShadowValid.fill(false);
+}
+
 void Fei4::initMask(enum MASK_STAGE mask) {
     uint32_t bitstream[21];
     for(unsigned i=0; i<21; i++)
@@ -127,6 +170,10 @@ void Fei4::initMask(uint32_t mask) {
     wrFrontEnd(chipId, bitstream);
 }
 
+void Fei4::writeMask(uint32_t *bitstream) {
+    wrFrontEnd(chipId, bitstream);
+}
+
 void Fei4::shiftMask() {
     this->loadIntoShiftReg(0x1);
     this->loadIntoPixel(0x1);
@@ -154,6 +201,21 @@ void Fei4::loadIntoShiftReg(unsigned pixel_latch) {
 }
 
 void Fei4::loadIntoPixel(unsigned pixel_latch) {
+    this->copyIntoLatches(pixel_latch);
+
+    // Whatever was in the shift register is now in these latches
+    for (unsigned bit=0; bit<Fei4PixelCfg::n_Bits; bit++) {
+        if (pixel_latch & (1 << bit)) {
+            if (chipId == 8) {
+                broadcastLoads[bit]++;
+            } else {
+                m_pixShadowValid[bit] = false;
+            }
+        }
+    }
+}
+
+void Fei4::copyIntoLatches(unsigned pixel_latch) {
     // Select Pixel latch to copy into SR
     writeRegister(&Fei4::Pixel_latch_strobe, pixel_latch);
 
@@ -204,7 +266,7 @@ void Fei4::dummyCmd() {
     writeRegister(&Fei4::Colpr_Addr, Fei4PixelCfg::n_DC-1);
     uint32_t bitstream[21] = {0};
     wrFrontEnd(chipId, bitstream);
-    while(core->isCmdEmpty() == 0);
+    core->fence();
 }
 
 void Fei4::shiftByOne() {
@@ -237,7 +299,63 @@ void Fei4::wrGR16(unsigned int mOffset, unsigned int bOffset, unsigned int mask,
     return;
 }
 
+void Fei4::commit(RegisterTransaction &trans) {
+    std::vector<uint32_t> words;
+    for (unsigned addr : trans.addresses()) {
+        uint32_t buf[2];
+        Fei4Cmd::genWrRegister(chipId, addr, cfg[addr], buf);
+        words.insert(words.end(), buf, buf+2);
+    }
+    if (!words.empty())
+        core->writeFifoBlock(words.data(), words.size());
+    core->releaseFifo();
+    trans.clear();
+}
+
+std::vector<unsigned> Fei4::getReadbackRegisters() {
+    std::vector<unsigned> addrs;
+    for (unsigned addr=1; addr<numRegs; addr++)
+        addrs.push_back(addr);
+    return addrs;
+}
+
+void Fei4::requestRegisters(const std::vector<unsigned> &addrs) {
+    std::vector<uint32_t> words;
+    for (unsigned addr : addrs)
+        words.push_back(Fei4Cmd::genRdRegister(chipId, addr));
+    if (!words.empty())
+        core->writeFifoBlock(words.data(), words.size());
+    core->releaseFifo();
+}
+
+void Fei4::decodeRegisters(const std::vector<uint32_t> &words, unsigned &pos,
+        const std::vector<unsigned> &rxChannels,
+        std::map<unsigned, std::map<unsigned, uint16_t>> &values) {
+    // Records carry their channel, an address record is followed by the
+    // value record on the same channel
+    for (; pos < words.size(); pos++) {
+        uint32_t addr = words[pos];
+        if ((addr & 0x00FF0000) != 0x00EA0000)
+            continue;
+        unsigned channel = addr >> 26;
+        unsigned next = pos+1;
+        while (next < words.size() && (words[next] >> 26) != channel)
+            next++;
+        if (next == words.size())
+            return;
+        uint32_t value = words[next];
+        // Bit 15 marks shift register reads
+        if ((value & 0x00FF0000) == 0x00EC0000 && !(addr & 0x8000))
+            values[channel][addr & 0x7FFF] = value & 0xFFFF;
+    }
+}
+
 void Fei4::writeNamedRegister(std::string name, uint16_t reg_value) {
     std::cout << __PRETTY_FUNCTION__ << " : " << name << " -> " << reg_value << std::endl;
-    writeRegister(regMap[name], reg_value);
+    Fei4Register Fei4GlobalCfg::*ref = Fei4GlobalCfg::findReg(name);
+    if (ref == nullptr) {
+        std::cerr << "#ERROR# Unknown register " << name << std::endl;
+        return;
+    }
+    writeRegister(ref, reg_value);
 }
@@ -69,5 +69,5 @@ void Fei4AnalogScan::preScan() {
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Lat, (255-triggerDelay)-5);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::PlsrDAC, 300);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::CalPulseWidth, 20); // Longer than max ToT 
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
 }
@@ -30,6 +30,15 @@ void Fei4Analysis::init() {
         algorithms[i]->connect(output);
         algorithms[i]->init(scan);
     }
+    // Feedback is only known after init
+    algoQueue.resize(algorithms.size());
+    algoBusy.assign(algorithms.size(), false);
+    algoOrder.clear();
+    for (unsigned i=0; i<algorithms.size(); i++) {
+        algoOrder.push_back(i);
+    }
+    std::stable_partition(algoOrder.begin(), algoOrder.end(),
+            [this](unsigned i) { return algorithms[i]->hasFeedback(); });
     histogrammerDone = false;
 }
 
@@ -78,16 +87,69 @@ void Fei4Analysis::process() {
 }
 
 void Fei4Analysis::process_core() {
-    while(!input->empty()) {
-        auto h = input->popData();
-        if (h != NULL) {
-            for (unsigned i=0; i<algorithms.size(); i++) {
-                algorithms[i]->processHistogram(&*h);
+    // Queue each histogram for the algorithms consuming its type
+    unsigned nWork = 0;
+    {
+        std::lock_guard<std::mutex> lk(algoMutex);
+        while(!input->empty()) {
+            std::shared_ptr<HistogramBase> h = input->popData();
+            if (h != NULL) {
+                for (unsigned i=0; i<algorithms.size(); i++) {
+                    if (algorithms[i]->consumes(h->getType()))
+                        algoQueue[i].push_back(h);
+                }
+            }
+        }
+        for (unsigned i=0; i<algorithms.size(); i++) {
+            if (!algoQueue[i].empty())
+                nWork++;
+        }
+    }
+
+    // One runner per algorithm with work, this thread is one of them
+    std::vector<std::future<void>> runners;
+    for (unsigned n=1; n<nWork; n++) {
+        runners.push_back(algoPool().enqueue([this] { this->runAlgorithms(); }));
+    }
+    this->runAlgorithms();
+    for (auto &runner : runners) {
+        runner.get();
+    }
+}
+
+// Keeps taking the next histogram of the highest priority idle algorithm
+// until no algorithm is left with work that is not already being run
+void Fei4Analysis::runAlgorithms() {
+    while (true) {
+        unsigned algo = algorithms.size();
+        std::shared_ptr<HistogramBase> h;
+        {
+            std::lock_guard<std::mutex> lk(algoMutex);
+            for (unsigned i : algoOrder) {
+                if (!algoBusy[i] && !algoQueue[i].empty()) {
+                    algo = i;
+                    break;
+                }
             }
+            if (algo == algorithms.size())
+                return;
+            algoBusy[algo] = true;
+            h = algoQueue[algo].front();
+            algoQueue[algo].pop_front();
+        }
+        algorithms[algo]->processHistogram(&*h);
+        {
+            std::lock_guard<std::mutex> lk(algoMutex);
+            algoBusy[algo] = false;
         }
     }
 }
 
+ThreadPool& Fei4Analysis::algoPool() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
 void Fei4Analysis::end() {
     std::cout << __PRETTY_FUNCTION__ << std::endl;
     for (unsigned i=0; i<algorithms.size(); i++) {
@@ -422,7 +484,7 @@ void TotAnalysis::processHistogram(HistogramBase *h) {
                 sign = 0;
                 last = true;
             }
-            globalFb->feedbackBinary(channel, sign, last);
+            globalFb->send(GlobalFeedbackBase::Binary, channel, sign, last);
         }
 
         if (pixelFb != NULL) {
@@ -441,7 +503,7 @@ void TotAnalysis::processHistogram(HistogramBase *h) {
                 fbHisto->setBin(i, sign);
             }
 
-            pixelFb->feedback(channel, fbHisto);
+            pixelFb->send(PixelFeedbackBase::StepDown, channel, std::unique_ptr<Histo2d>(fbHisto));
         }
 
         output->pushData(std::move(meanTotMap));
@@ -468,6 +530,7 @@ void ScurveFitter::init(ScanBase *s) {
     scan = s;
     n_count = 1;
     vcalLoop = 0;
+    adaptiveVcal = false;
     injections = 50;
     useScap = true;
     useLcap = true;
@@ -483,6 +546,7 @@ void ScurveFitter::init(ScanBase *s) {
                 l->type() != typeid(StdDataLoop*) &&
                 l->type() != typeid(Fei4DcLoop*) &&
                 l->type() != typeid(Fe65p2QcLoop*) &&
+                l->hasFixedSteps() &&
                 l->type() != tmpVcalLoop3->type() &&
                 l->type() != tmpVcalLoop2->type() &&
                 l->type() != tmpVcalLoop->type()) {
@@ -490,7 +554,8 @@ void ScurveFitter::init(ScanBase *s) {
             loopMax.push_back((unsigned)l->getMax());
         } else {
             unsigned cnt = (l->getMax() - l->getMin())/l->getStep();
-            if (l->type() == tmpVcalLoop3->type() ||
+            if (!l->hasFixedSteps() ||
+                l->type() == tmpVcalLoop3->type() ||
                 l->type() == tmpVcalLoop2->type() ||
                 l->type() == tmpVcalLoop->type()) {
                 cnt++; // Parameter loop interval is inclusive
@@ -502,7 +567,11 @@ void ScurveFitter::init(ScanBase *s) {
         // Vcal Loop
         if (l->type() == tmpVcalLoop->type() ||
                 l->type() == tmpVcalLoop2->type() ||
-                l->type() == tmpVcalLoop3->type()) {
+                l->type() == tmpVcalLoop3->type() ||
+                !l->hasFixedSteps()) {
+            // A loop which decides its steps on the data can only be the
+            // vcal loop here
+            adaptiveVcal = !l->hasFixedSteps();
             vcalLoop = n;
             vcalMax = l->getMax();
             vcalMin = l->getMin();
@@ -543,6 +612,11 @@ void ScurveFitter::init(ScanBase *s) {
 
     }
 
+    // Number of vcal steps is only known at the end of each iteration
+    if (adaptiveVcal && fb != nullptr) {
+        throw std::runtime_error("ScurveFitter: pixel feedback needs a vcal loop with a fixed number of steps");
+    }
+
     for (unsigned i=vcalMin; i<=vcalMax; i+=vcalStep) {
         x.push_back(i);
     }
@@ -581,132 +655,24 @@ void ScurveFitter::processHistogram(HistogramBase *h) {
     }
     medCnt[medIdent]++;
 
-    for(unsigned col=1; col<=nCol; col++) {
-        for (unsigned row=1; row<=nRow; row++) {
-            unsigned bin = hh->binNum(col, row);
-            if (hh->getBin(bin) != 0) {
-                // Select correct output containe
-                unsigned ident = bin;
-                unsigned offset = nCol*nRow;
-                unsigned vcal = hh->getStat().get(vcalLoop);
-                //std::cout << "VCAL = " << vcal << std::endl;
-                // Determine identifier
-                std::string name = "Scurve";
-                name += "-" + std::to_string(col) + "-" + std::to_string(row);
-                // Check for other loops
-                for (unsigned n=0; n<loops.size(); n++) {
-                    ident += hh->getStat().get(loops[n])+offset;
-                    offset += loopMax[n];
-                    name += "-" + std::to_string(hh->getStat().get(loops[n]));
-                }
-
-                // Check if Histogram exists
-                if (histos[ident] == NULL) {
-                    Histo1d *hhh = new Histo1d(name, vcalBins+1, vcalMin-((double)vcalStep/2.0), vcalMax+((double)vcalStep/2.0), typeid(this));
-                    hhh->setXaxisTitle("Vcal");
-                    hhh->setYaxisTitle("Occupancy");
-                    histos[ident].reset(hhh);
-                    innerCnt[ident] = 0;
-                }
-                if (sCurve[outerIdent] == NULL) {
-                    Histo2d *hhh = new Histo2d("sCurve-" + std::to_string(outerIdent), vcalBins+1, vcalMin-((double)vcalStep/2.0), vcalMax+((double)vcalStep/2.0), injections-1, 0.5, injections-0.5, typeid(this));
-                    hhh->setXaxisTitle("Vcal");
-                    hhh->setYaxisTitle("Occupancy");
-                    hhh->setZaxisTitle("Number of pixels");
-                    sCurve[outerIdent].reset(hhh);
-                }
-
-                // Add up Histograms
-                histos[ident]->fill(vcal, hh->getBin(bin));
-                sCurve[outerIdent]->fill(vcal, hh->getBin(bin));
-                innerCnt[ident]++;
-
-                // Got all data, finish up Analysis
-                // TODO This requires the loop to run from low to high and a hit in the last bin
-                if (vcal == vcalMax) {
-                    // Scale histos
-                    //histos[ident]->scale(1.0/(double)injections);
-                    lm_status_struct status;
-                    lm_control_struct control;
-                    control = lm_control_float;
-                    //control.verbosity = 3;
-                    control.verbosity = 0;
-                    const unsigned n_par = 3;
-                    //double par[n_par] = {((vcalMax-vcalMin)/2.0)+vcalMin,  5 , (double) injections};
-                    double par[n_par] = {((vcalMax-vcalMin)/2.0)+vcalMin,  0.05*(((vcalMax-vcalMin)/2.0)+vcalMin)  , (double) injections};
-                    std::chrono::high_resolution_clock::time_point start;
-                    std::chrono::high_resolution_clock::time_point end;
-                    start = std::chrono::high_resolution_clock::now();
-                    lmcurve(n_par, par, vcalBins, &x[0], histos[ident]->getData(), scurveFct, &control, &status);
-                    end = std::chrono::high_resolution_clock::now();
-                    std::chrono::microseconds fitTime = std::chrono::duration_cast<std::chrono::microseconds>(end-start);
-                    if (thrMap[outerIdent] == NULL) {
-                        Histo2d *hh2 = new Histo2d("ThresholdMap-" + std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
-                        hh2->setXaxisTitle("Column");
-                        hh2->setYaxisTitle("Row");
-                        hh2->setZaxisTitle("Threshold [e]");
-                        thrMap[outerIdent].reset(hh2);
-                        hh2 = new Histo2d("NoiseMap-"+std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
-                        hh2->setXaxisTitle("Column");
-                        hh2->setYaxisTitle("Row");
-                        hh2->setZaxisTitle("Noise [e]");
-
-                        sigMap[outerIdent].reset(hh2);
-
-                        Histo1d *hh1 = new Histo1d("Chi2Dist-"+std::to_string(outerIdent), 51, -0.025, 2.525, typeid(this));
-                        hh1->setXaxisTitle("Fit Chi/ndf");
-                        hh1->setYaxisTitle("Number of Pixels");
-                        chiDist[outerIdent].reset(hh1);
-
-                        hh2 = new Histo2d("Chi2Map-"+std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
-                        hh2->setXaxisTitle("Column");
-                        hh2->setYaxisTitle("Row");
-                        hh2->setZaxisTitle("Chi2");
-                        chi2Map[outerIdent].reset(hh2);     
-
-                        hh2 = new Histo2d("StatusMap-"+std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
-                        hh2->setXaxisTitle("Column");
-                        hh2->setYaxisTitle("Row");
-                        hh2->setZaxisTitle("Fit Status");
-                        statusMap[outerIdent].reset(hh2);
-
-                        hh1 = new Histo1d("StatusDist-"+std::to_string(outerIdent), 11, -0.5, 10.5, typeid(this));
-                        hh1->setXaxisTitle("Fit Status ");
-                        hh1->setYaxisTitle("Number of Pixels");
-                        statusDist[outerIdent].reset(hh1);
-
-                        hh1 = new Histo1d("TimePerFitDist-"+std::to_string(outerIdent), 201, -1, 401, typeid(this));
-                        hh1->setXaxisTitle("Fit Time [us]");
-                        hh1->setYaxisTitle("Number of Pixels");
-                        timeDist[outerIdent].reset(hh1);
-                    }
+    unsigned vcal = hh->getStat().get(vcalLoop);
+    if (vcal >= vcalMin && vcal <= vcalMax) {
+        this->accumulate(hh, outerIdent, vcal);
+    }
 
-                    double chi2= status.fnorm/(double)status.nfev;
-
-                    if (par[0] > vcalMin && par[0] < vcalMax && par[1] > 0 && par[1] < (vcalMax-vcalMin) && par[1] >= 0 
-                            && chi2 < 2.5 && chi2 > 1e-6) {
-                        FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(bookie->getFe(channel));
-                        thrMap[outerIdent]->setBin(bin, feCfg->toCharge(par[0], useScap, useLcap));
-                        // Reudce effect of vcal offset on this, don't want to probe at low vcal
-                        sigMap[outerIdent]->setBin(bin, feCfg->toCharge(par[0]+par[1], useScap, useLcap)-feCfg->toCharge(par[0], useScap, useLcap));
-                        chiDist[outerIdent]->fill(status.fnorm/(double)status.nfev);
-                        timeDist[outerIdent]->fill(fitTime.count());
-                        chi2Map[outerIdent]->setBin(bin, chi2 );
-                        statusMap[outerIdent]->setBin(bin, status.outcome);
-                        statusDist[outerIdent]->fill(status.outcome);
-
-                    } else {
-                        n_failedfit++;
-                           // std::cout << "Col(" << col << ") Row(" << row << ") Threshold(" << thrMap[outerIdent]->getBin(bin) << ") Chi2(" << chi2 << ") Status(" << status.outcome << ") Entries(" 
-                           //     << histos[ident]->getEntries() << ") Mean(" << histos[ident]->getMean() << ")" << std::endl;
-                    }
-                    if (row == nRow/2 && col%10 == 0) {
-                        output->pushData(std::move(histos[ident]));
-                    }
-                    histos[ident].reset(nullptr);
-                }
-            }
-        }
+    // All histograms of this outer loop iteration arrived, in whatever order
+    // the loops ran. An adaptive vcal loop does not have a fixed number of
+    // steps, its iterations are complete once the next one started.
+    if (adaptiveVcal) {
+        std::vector<unsigned> done;
+        for (auto &cube : occCube) {
+            if (cube.first != outerIdent)
+                done.push_back(cube.first);
+        }
+        for (unsigned ident : done)
+            this->completeIteration(ident);
+    } else if (medCnt[medIdent] == n_count && occCube.find(outerIdent) != occCube.end()) {
+        this->completeIteration(outerIdent);
     }
 
     // Finished full vcal loop, if feedback loop provide TDAC feedback
@@ -763,11 +729,324 @@ void ScurveFitter::processHistogram(HistogramBase *h) {
         }
         prevOuter = outerIdent;
         std::cout << "[" << this->channel << "] --> Sending feedback #" << outerIdent << std::endl;
-        fb->feedback(this->channel, step[outerIdent].get());
+        // The steps of earlier iterations are still needed here, the loop gets a copy
+        fb->send(PixelFeedbackBase::StepDown, this->channel, std::unique_ptr<Histo2d>(new Histo2d(step[outerIdent].get())));
+    }
+}
+
+// Fit every pixel which saw hits and drop the cube
+void ScurveFitter::completeIteration(unsigned outerIdent) {
+    unsigned nBins = vcalBins+1;
+    uint32_t *cube = &occCube[outerIdent][0];
+
+    // Only the points which were measured are fitted
+    fitIdx.clear();
+    fitX.clear();
+    const std::vector<bool> &seen = visited[outerIdent];
+    for (unsigned n=0; n<vcalBins; n++) {
+        if (seen[n]) {
+            fitIdx.push_back(n);
+            fitX.push_back(x[n]);
+        }
+    }
+    if (fitIdx.size() < 3) {
+        std::cout << "[" << channel << "] Only " << fitIdx.size() << " vcal points in iteration "
+            << outerIdent << ", not fitted" << std::endl;
+        occCube.erase(outerIdent);
+        cubeSuffix.erase(outerIdent);
+        visited.erase(outerIdent);
+        return;
+    }
+
+    for (unsigned bin=0; bin<nCol*nRow; bin++) {
+        uint32_t *data = cube + bin*nBins;
+        if (std::any_of(data, data+nBins, [](uint32_t hits) { return hits != 0; })) {
+            FitJob job;
+            job.bin = bin;
+            job.data = data;
+            pending.push_back(job);
+        }
+    }
+    this->fitPending(outerIdent);
+    occCube.erase(outerIdent);
+    cubeSuffix.erase(outerIdent);
+    visited.erase(outerIdent);
+}
+
+void ScurveFitter::fitData(const FitJob &job, double *y) const {
+    for (unsigned n=0; n<fitIdx.size(); n++)
+        y[n] = job.data[fitIdx[n]];
+}
+
+void ScurveFitter::accumulate(Histo2d *hh, unsigned outerIdent, unsigned vcal) {
+    unsigned vcalBin = (vcal-vcalMin)/vcalStep;
+    unsigned nBins = vcalBins+1;
+
+    // Allocate the accumulation cube once per outer loop iteration
+    if (occCube[outerIdent].empty()) {
+        occCube[outerIdent].assign(nCol*nRow*nBins, 0);
+        std::string suffix = "";
+        for (unsigned n=0; n<loops.size(); n++) {
+            suffix += "-" + std::to_string(hh->getStat().get(loops[n]));
+        }
+        cubeSuffix[outerIdent] = suffix;
+        visited[outerIdent].assign(nBins, false);
+    }
+    visited[outerIdent][vcalBin] = true;
+    if (sCurve[outerIdent] == NULL) {
+        Histo2d *hhh = new Histo2d("sCurve-" + std::to_string(outerIdent), vcalBins+1, vcalMin-((double)vcalStep/2.0), vcalMax+((double)vcalStep/2.0), injections-1, 0.5, injections-0.5, typeid(this));
+        hhh->setXaxisTitle("Vcal");
+        hhh->setYaxisTitle("Occupancy");
+        hhh->setZaxisTitle("Number of pixels");
+        sCurve[outerIdent].reset(hhh);
+    }
+
+    // Add up occupancy, histogram bins are stored column by column.
+    // sCurve gets one entry per pixel with hits, as before the cube.
+    uint32_t *cube = &occCube[outerIdent][0];
+    const double *occ = hh->getData();
+    for (unsigned col=0; col<nCol; col++) {
+        const double *occRow = occ + col*nRow;
+        uint32_t *cubeRow = cube + (col*nRow)*nBins + vcalBin;
+        for (unsigned row=0; row<nRow; row++) {
+            if (occRow[row] != 0) {
+                cubeRow[row*nBins] += occRow[row];
+                sCurve[outerIdent]->fill(vcal, occRow[row]);
+            }
+        }
     }
 }
 
+void ScurveFitter::loadConfig(json &j) {
+    if (!j["fitter"].empty()) {
+        std::string fitter = j["fitter"];
+        useLmmin = (fitter != "scurvefit");
+    }
+    if (!j["fixNorm"].empty()) {
+        fixNorm = j["fixNorm"];
+    }
+}
+
+// Runs on the worker threads, only touches its own slice of the job list
+void ScurveFitter::fitPixels(unsigned first, unsigned last) {
+    unsigned nBins = this->nFitPoints();
+    if (useLmmin) {
+        for (unsigned i=first; i<last; i++) {
+            this->fitSingle(pending[i]);
+        }
+        return;
+    }
+
+    // Dedicated fitter, advances ScurveFit::lanes pixels at a time
+    ScurveFit::Control control = ScurveFit::defaultControl;
+    control.fixNorm = fixNorm;
+    const unsigned lanes = ScurveFit::lanes;
+    std::vector<double> y(lanes*nBins);
+    double par[lanes*ScurveFit::n_par];
+    ScurveFit::Status status[lanes];
+    for (unsigned i=first; i<last; i+=lanes) {
+        unsigned nl = std::min(lanes, last-i);
+        std::chrono::high_resolution_clock::time_point start;
+        std::chrono::high_resolution_clock::time_point end;
+        start = std::chrono::high_resolution_clock::now();
+        for (unsigned l=0; l<nl; l++) {
+            this->fitData(pending[i+l], &y[l*nBins]);
+            ScurveFit::guess(nBins, &fitX[0], &y[l*nBins], injections, &par[l*ScurveFit::n_par]);
+        }
+        ScurveFit::fitBatch(nl, nBins, &fitX[0], &y[0], par, control, status);
+        end = std::chrono::high_resolution_clock::now();
+        long fitTime = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/nl;
+        for (unsigned l=0; l<nl; l++) {
+            FitJob &job = pending[i+l];
+            for (unsigned n=0; n<ScurveFit::n_par; n++) {
+                job.par[n] = par[l*ScurveFit::n_par+n];
+            }
+            job.chi2 = status[l].chi2;
+            job.outcome = status[l].outcome;
+            job.fitTime = fitTime;
+        }
+    }
+}
+
+void ScurveFitter::fitSingle(FitJob &job) {
+    unsigned nBins = this->nFitPoints();
+    std::vector<double> y(nBins);
+    this->fitData(job, &y[0]);
+    std::chrono::high_resolution_clock::time_point start;
+    std::chrono::high_resolution_clock::time_point end;
+    start = std::chrono::high_resolution_clock::now();
+    if (useLmmin) {
+        lm_status_struct status;
+        lm_control_struct control;
+        control = lm_control_float;
+        //control.verbosity = 3;
+        control.verbosity = 0;
+        const unsigned n_par = 3;
+        job.par[0] = ((vcalMax-vcalMin)/2.0)+vcalMin;
+        job.par[1] = 0.05*(((vcalMax-vcalMin)/2.0)+vcalMin);
+        job.par[2] = (double) injections;
+        lmcurve(n_par, job.par, nBins, &fitX[0], &y[0], scurveFct, &control, &status);
+        job.chi2 = status.fnorm/(double)status.nfev;
+        job.outcome = status.outcome;
+    } else {
+        ScurveFit::Control control = ScurveFit::defaultControl;
+        control.fixNorm = fixNorm;
+        ScurveFit::Status status;
+        ScurveFit::guess(nBins, &fitX[0], &y[0], injections, job.par);
+        ScurveFit::fit(nBins, &fitX[0], &y[0], job.par, control, status);
+        job.chi2 = status.chi2;
+        job.outcome = status.outcome;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    job.fitTime = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
+}
+
+void ScurveFitter::fitPending(unsigned outerIdent) {
+    if (pending.empty())
+        return;
+
+    // Split into several batches per worker to even out the load
+    unsigned nWorkers = std::max(1u, std::thread::hardware_concurrency());
+    unsigned batchSize = std::max(256u, (unsigned)pending.size()/(4*nWorkers)+1);
+    if (pending.size() <= batchSize) {
+        this->fitPixels(0, pending.size());
+    } else {
+        // Runs on a pool thread itself, so batches are claimed by whoever
+        // gets to them first and only batches already running are waited
+        // for. Helpers starting after the last batch was claimed do nothing.
+        struct Batches {
+            unsigned size;
+            unsigned total;
+            std::atomic<unsigned> next;
+            unsigned done;
+            std::mutex mtx;
+            std::condition_variable cv;
+        };
+        std::shared_ptr<Batches> b(new Batches);
+        b->size = batchSize;
+        b->total = (pending.size()+batchSize-1)/batchSize;
+        b->next = 0;
+        b->done = 0;
+        auto work = [this, b] {
+            unsigned i;
+            while ((i = b->next++) < b->total) {
+                unsigned first = i*b->size;
+                unsigned last = std::min((unsigned)pending.size(), first+b->size);
+                this->fitPixels(first, last);
+                std::lock_guard<std::mutex> lk(b->mtx);
+                if (++b->done == b->total)
+                    b->cv.notify_all();
+            }
+        };
+        for (unsigned n=1; n<std::min(nWorkers, b->total); n++) {
+            Fei4Analysis::algoPool().enqueue(work);
+        }
+        work();
+        std::unique_lock<std::mutex> lk(b->mtx);
+        b->cv.wait(lk, [&b] { return b->done == b->total; });
+    }
+
+    // Fill results sequentially, histograms are not thread safe
+    this->createResultMaps(outerIdent);
+    FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(bookie->getFe(channel));
+    for (FitJob &job : pending) {
+        unsigned bin = job.bin;
+        const double *par = job.par;
+        double chi2 = job.chi2;
+
+        if (par[0] > vcalMin && par[0] < vcalMax && par[1] > 0 && par[1] < (vcalMax-vcalMin) && par[1] >= 0 
+                && chi2 < 2.5 && chi2 > 1e-6) {
+            thrMap[outerIdent]->setBin(bin, feCfg->toCharge(par[0], useScap, useLcap));
+            // Reudce effect of vcal offset on this, don't want to probe at low vcal
+            sigMap[outerIdent]->setBin(bin, feCfg->toCharge(par[0]+par[1], useScap, useLcap)-feCfg->toCharge(par[0], useScap, useLcap));
+            chiDist[outerIdent]->fill(chi2);
+            timeDist[outerIdent]->fill(job.fitTime);
+            chi2Map[outerIdent]->setBin(bin, chi2);
+            statusMap[outerIdent]->setBin(bin, job.outcome);
+            statusDist[outerIdent]->fill(job.outcome);
+        } else {
+            n_failedfit++;
+        }
+        unsigned col = (bin/nRow)+1;
+        unsigned row = (bin%nRow)+1;
+        if (row == nRow/2 && col%10 == 0) {
+            output->pushData(this->makeScurveHisto(outerIdent, bin));
+        }
+    }
+    pending.clear();
+}
+
+std::unique_ptr<Histo1d> ScurveFitter::makeScurveHisto(unsigned outerIdent, unsigned bin) {
+    unsigned col = (bin/nRow)+1;
+    unsigned row = (bin%nRow)+1;
+    std::string name = "Scurve-" + std::to_string(col) + "-" + std::to_string(row) + cubeSuffix[outerIdent];
+    std::unique_ptr<Histo1d> hhh(new Histo1d(name, vcalBins+1, vcalMin-((double)vcalStep/2.0), vcalMax+((double)vcalStep/2.0), typeid(this)));
+    hhh->setXaxisTitle("Vcal");
+    hhh->setYaxisTitle("Occupancy");
+    const uint32_t *data = &occCube[outerIdent][bin*(vcalBins+1)];
+    for (unsigned n=0; n<=vcalBins; n++) {
+        if (data[n] != 0)
+            hhh->fill(x[n], data[n]);
+    }
+    return hhh;
+}
+
+void ScurveFitter::createResultMaps(unsigned outerIdent) {
+    if (thrMap[outerIdent] != NULL)
+        return;
+
+    Histo2d *hh2 = new Histo2d("ThresholdMap-" + std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
+    hh2->setXaxisTitle("Column");
+    hh2->setYaxisTitle("Row");
+    hh2->setZaxisTitle("Threshold [e]");
+    thrMap[outerIdent].reset(hh2);
+    hh2 = new Histo2d("NoiseMap-"+std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
+    hh2->setXaxisTitle("Column");
+    hh2->setYaxisTitle("Row");
+    hh2->setZaxisTitle("Noise [e]");
+
+    sigMap[outerIdent].reset(hh2);
+
+    Histo1d *hh1 = new Histo1d("Chi2Dist-"+std::to_string(outerIdent), 51, -0.025, 2.525, typeid(this));
+    hh1->setXaxisTitle("Fit Chi/ndf");
+    hh1->setYaxisTitle("Number of Pixels");
+    chiDist[outerIdent].reset(hh1);
+
+    hh2 = new Histo2d("Chi2Map-"+std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
+    hh2->setXaxisTitle("Column");
+    hh2->setYaxisTitle("Row");
+    hh2->setZaxisTitle("Chi2");
+    chi2Map[outerIdent].reset(hh2);     
+
+    hh2 = new Histo2d("StatusMap-"+std::to_string(outerIdent), nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this));
+    hh2->setXaxisTitle("Column");
+    hh2->setYaxisTitle("Row");
+    hh2->setZaxisTitle("Fit Status");
+    statusMap[outerIdent].reset(hh2);
+
+    statusDist[outerIdent] = this->makeStatusDist(outerIdent);
+
+    hh1 = new Histo1d("TimePerFitDist-"+std::to_string(outerIdent), 201, -1, 401, typeid(this));
+    hh1->setXaxisTitle("Fit Time [us]");
+    hh1->setYaxisTitle("Number of Pixels");
+    timeDist[outerIdent].reset(hh1);
+}
+
+std::unique_ptr<Histo1d> ScurveFitter::makeStatusDist(unsigned outerIdent) {
+    std::unique_ptr<Histo1d> hh1(new Histo1d("StatusDist-"+std::to_string(outerIdent), 11, -0.5, 10.5, typeid(this)));
+    hh1->setXaxisTitle("Fit Status ");
+    hh1->setYaxisTitle("Number of Pixels");
+    return hh1;
+}
+
 void ScurveFitter::end() {
+    while (adaptiveVcal && !occCube.empty()) {
+        this->completeIteration(occCube.begin()->first);
+    }
+    // Iterations which never completed are not fitted
+    occCube.clear();
+    cubeSuffix.clear();
+    visited.clear();
 
     if (fb != nullptr) {
         std::cout << " Tuned to ==> " << thrTarget << std::endl;
@@ -845,6 +1124,89 @@ void ScurveFitter::end() {
 
 }
 
+void ScurveMoments::loadConfig(json &j) {
+    ScurveFitter::loadConfig(j);
+    if (!j["fallbackFit"].empty()) {
+        fallbackFit = j["fallbackFit"];
+    }
+}
+
+// Extra bin for the pixels taken from the moments (status -1)
+std::unique_ptr<Histo1d> ScurveMoments::makeStatusDist(unsigned outerIdent) {
+    std::unique_ptr<Histo1d> hh1(new Histo1d("StatusDist-"+std::to_string(outerIdent), 12, -1.5, 10.5, typeid(this)));
+    hh1->setXaxisTitle("Fit Status ");
+    hh1->setYaxisTitle("Number of Pixels");
+    return hh1;
+}
+
+void ScurveMoments::fitPixels(unsigned first, unsigned last) {
+    for (unsigned i=first; i<last; i++) {
+        FitJob &job = pending[i];
+        std::chrono::high_resolution_clock::time_point start;
+        std::chrono::high_resolution_clock::time_point end;
+        start = std::chrono::high_resolution_clock::now();
+        bool good = this->estimate(job);
+        end = std::chrono::high_resolution_clock::now();
+        job.fitTime = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
+        if (!good && fallbackFit) {
+            this->fitSingle(job);
+        }
+    }
+}
+
+// Threshold is the 50% crossing, noise the rms of the bin-to-bin differences.
+// Returns false if the s-curve does not look like one.
+bool ScurveMoments::estimate(FitJob &job) {
+    unsigned nPoints = this->nFitPoints();
+    std::vector<double> y(nPoints);
+    this->fitData(job, &y[0]);
+    const double half = 0.5*injections;
+
+    job.outcome = -1;
+    job.par[2] = injections;
+    job.par[0] = 0;
+    job.par[1] = 0;
+    job.chi2 = 0;
+
+    double sum = 0;
+    double sumAbs = 0;
+    double sumX = 0;
+    double sumX2 = 0;
+    double sumW2 = 0;
+    unsigned cross = 0;
+    for (unsigned n=0; n+1<nPoints; n++) {
+        double d = y[n+1]-y[n];
+        double xm = 0.5*(fitX[n]+fitX[n+1]);
+        double w = fitX[n+1]-fitX[n];
+        sum += d;
+        sumAbs += fabs(d);
+        sumX += d*xm;
+        sumX2 += d*xm*xm;
+        sumW2 += d*w*w;
+        if (cross == 0 && y[n] < half && y[n+1] >= half)
+            cross = n+1;
+    }
+    // Needs a rising edge of about the number of injections within the range
+    if (cross == 0 || sum < half)
+        return false;
+
+    double dy = y[cross]-y[cross-1];
+    job.par[0] = fitX[cross-1] + (half-y[cross-1])/dy*(fitX[cross]-fitX[cross-1]);
+    double mean = sumX/sum;
+    // Sheppard's correction for the finite vcal steps, each difference
+    // with the width of its own step
+    double var = sumX2/sum - mean*mean - sumW2/sum/12.0;
+    // Within one bin the differences carry no width information
+    double minSig = 0.1*vcalStep;
+    job.par[1] = (var > minSig*minSig) ? sqrt(var) : minSig;
+    job.chi2 = ScurveFit::chi2(nPoints, &fitX[0], &y[0], job.par);
+
+    // Many steps down, the curve is too noisy for the moments
+    if (sumAbs > 1.5*sum)
+        return false;
+    return (job.chi2 < 2.5 && job.chi2 > 1e-6);
+}
+
 void OccGlobalThresholdTune::init(ScanBase *s) {
     std::shared_ptr<LoopActionBase> tmpVthinFb(new Fei4GlobalFeedback(&Fei4::Vthin_Fine));
     std::shared_ptr<LoopActionBase> tmpVthinFb2(new Fe65p2GlobalFeedback(&Fe65p2::Vthin1Dac));
@@ -962,7 +1324,7 @@ void OccGlobalThresholdTune::processHistogram(HistogramBase *h) {
             done = true;
         }
 
-        fb->feedback(this->channel, sign, done);
+        fb->send(GlobalFeedbackBase::StepDown, this->channel, sign, done);
         output->pushData(std::move(occMaps[ident]));
         output->pushData(std::move(occDists[ident]));
         innerCnt[ident] = 0;
@@ -1064,9 +1426,12 @@ void OccPixelThresholdTune::processHistogram(HistogramBase *h) {
         std::unique_ptr<Histo1d> occDist(new Histo1d(name2, injections-1, 0.5, injections-0.5, typeid(this)));
         occDist->setXaxisTitle("Occupancy");
         occDist->setYaxisTitle("Number of Pixels");
+        bool deviation = fb->wantsDeviation();
         for (unsigned i=0; i<fbHisto->size(); i++) {
             double occ = occMaps[ident]->getBin(i);
-            if ((occ/(double)injections) > 0.7) {
+            if (deviation) {
+                fbHisto->setBin(i, TdacModel::deviation(occ, injections));
+            } else if ((occ/(double)injections) > 0.7) {
                 fbHisto->setBin(i, -1);
             } else if ((occ/(double)injections) < 0.3) {
                 fbHisto->setBin(i, +1);
@@ -1079,7 +1444,7 @@ void OccPixelThresholdTune::processHistogram(HistogramBase *h) {
         std::cout << "[" << channel << "] Mean Occupancy: " << mean/(nCol*nRow*(double)injections) << std::endl;
         std::cout << "[" << channel << "] RMS: " << occDist->getStdDev() << std::endl;
 
-        fb->feedback(this->channel, fbHisto);
+        fb->send(PixelFeedbackBase::StepDown, this->channel, std::unique_ptr<Histo2d>(fbHisto));
         output->pushData(std::move(occMaps[ident]));
         output->pushData(std::move(occDist));
         innerCnt[ident] = 0;
@@ -1379,9 +1744,9 @@ void NoiseTuning::processHistogram(HistogramBase *h) {
             }
             std::cout << "[" << channel << "] Number of pixel with hits: " << numOfHits << std::endl;
             if (numOfHits < 10) { // TODO not hardcode this value
-                globalFb->feedbackStep(channel, -1, false);
+                globalFb->send(GlobalFeedbackBase::Step, channel, -1, false);
             } else {
-                globalFb->feedbackStep(channel, 0, true);
+                globalFb->send(GlobalFeedbackBase::Step, channel, 0, true);
             }
         }
 
@@ -1399,7 +1764,7 @@ void NoiseTuning::processHistogram(HistogramBase *h) {
             }
             std::cout << "[" << channel << "] Number of pixel without hits: " << pixelWoHits << std::endl;
 
-            pixelFb->feedbackStep(channel, fbHisto);
+            pixelFb->send(PixelFeedbackBase::Step, channel, std::unique_ptr<Histo2d>(fbHisto));
         }
         output->pushData(std::move(occMaps[ident]));
         occMaps[ident] = NULL;
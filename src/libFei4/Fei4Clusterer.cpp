@@ -0,0 +1,102 @@
+#include "Fei4Clusterer.h"
+
+#include <algorithm>
+
+Fei4Clusterer::Fei4Clusterer() {
+    gap = 1;
+    nCol = 0;
+    nRow = 0;
+    generation = 0;
+}
+
+void Fei4Clusterer::resize(unsigned col, unsigned row) {
+    if (col <= nCol && row <= nRow)
+        return;
+    nCol = std::max(col, nCol);
+    nRow = std::max(row, nRow);
+    label.assign(nCol*nRow, 0);
+    stamp.assign(nCol*nRow, 0);
+    generation = 0;
+}
+
+uint32_t Fei4Clusterer::find(uint32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+void Fei4Clusterer::unite(uint32_t a, uint32_t b) {
+    a = this->find(a);
+    b = this->find(b);
+    // Earliest hit stays the root, clusters come out in hit order
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+void Fei4Clusterer::cluster(Fei4Event &event) {
+    event.clusters.clear();
+    event.nClusters = 0;
+    event.clusterGap = gap;
+    if (event.hits.empty())
+        return;
+
+    hits.clear();
+    unsigned maxCol = 0;
+    unsigned maxRow = 0;
+    for (auto &hit : event.hits) {
+        hits.push_back(&hit);
+        maxCol = std::max(maxCol, (unsigned)hit.col);
+        maxRow = std::max(maxRow, (unsigned)hit.row);
+    }
+    this->resize(maxCol+1, maxRow+1);
+
+    generation++;
+    if (generation == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+
+    unsigned n = hits.size();
+    parent.resize(n);
+    for (unsigned i=0; i<n; i++)
+        parent[i] = i;
+
+    // Look for already entered hits in the window around every hit, the
+    // own pixel is included to merge repeated hits
+    int reach = gap+1;
+    for (unsigned i=0; i<n; i++) {
+        int col = hits[i]->col;
+        int row = hits[i]->row;
+        int col0 = std::max(col-reach, 0);
+        int col1 = std::min(col+reach, (int)nCol-1);
+        int row0 = std::max(row-reach, 0);
+        int row1 = std::min(row+reach, (int)nRow-1);
+        for (int c=col0; c<=col1; c++) {
+            for (int r=row0; r<=row1; r++) {
+                unsigned cell = c*nRow + r;
+                if (stamp[cell] == generation)
+                    this->unite(i, label[cell]);
+            }
+        }
+        unsigned cell = col*nRow + row;
+        stamp[cell] = generation;
+        label[cell] = i;
+    }
+
+    // Size, length, width and charge are accumulated while filling
+    clusterIdx.assign(n, -1);
+    for (unsigned i=0; i<n; i++) {
+        uint32_t root = this->find(i);
+        if (clusterIdx[root] < 0) {
+            clusterIdx[root] = event.clusters.size();
+            event.clusters.push_back(Fei4Cluster());
+        }
+        event.clusters[clusterIdx[root]].addHit(hits[i]);
+    }
+    event.nClusters = event.clusters.size();
+}
@@ -8,6 +8,8 @@
 
 #include "Fei4Cmd.h"
 
+#include <vector>
+
 Fei4Cmd::Fei4Cmd() {
     verbose = false;
     core = NULL;
@@ -52,24 +54,36 @@ void Fei4Cmd::cal() {
 
 void Fei4Cmd::wrRegister(int chipId, int address, int value) {
     if (verbose) std::cout << __PRETTY_FUNCTION__ << " : Addr " << address << ", Value 0x" << std::hex << value << std::dec << std::endl ;
-    core->writeFifo(0x005A0800+((chipId<<6)&0x3C0)+(address&0x3F));
-    core->writeFifo((value<<16)&0xFFFF0000);
+    uint32_t buf[2];
+    Fei4Cmd::genWrRegister(chipId, address, value, buf);
+    core->writeFifoBlock(buf, 2);
     core->releaseFifo();
 }
 
+void Fei4Cmd::genWrRegister(int chipId, int address, int value, uint32_t buf[2]) {
+    buf[0] = 0x005A0800+((chipId<<6)&0x3C0)+(address&0x3F);
+    buf[1] = (value<<16)&0xFFFF0000;
+}
+
 void Fei4Cmd::rdRegister(int chipId, int address) {
     if (verbose) std::cout << __PRETTY_FUNCTION__ << std::endl;
-    core->writeFifo(0x005A0400+((chipId<<6)&0x3C0)+(address&0x3F));
+    core->writeFifo(Fei4Cmd::genRdRegister(chipId, address));
     core->releaseFifo();
 }
 
+uint32_t Fei4Cmd::genRdRegister(int chipId, int address) {
+    return 0x005A0400+((chipId<<6)&0x3C0)+(address&0x3F);
+}
+
 void Fei4Cmd::wrFrontEnd(int chipId, uint32_t *bitstream) {
     if (verbose) std::cout << __PRETTY_FUNCTION__ << std::endl;
-    core->writeFifo(0x005A1000+((chipId<<6)&0x3C0));
+    uint32_t buf[22];
+    buf[0] = 0x005A1000+((chipId<<6)&0x3C0);
     //Flipping the order in order to send bit 671-0, and not bit 31-0, 63-21, etc.
     for(int i = 20 ; i>=0 ; i--) {
-        core->writeFifo(bitstream[i]);	
+        buf[21-i] = bitstream[i];
     }
+    core->writeFifoBlock(buf, 22);
     core->releaseFifo();
 }
 
@@ -94,10 +108,13 @@ void Fei4Cmd::globalPulse(int chipId, unsigned width) {
 
 void Fei4Cmd::calTrigger(int delay) {
     if (verbose) std::cout << __PRETTY_FUNCTION__ << std::endl;
-    core->writeFifo(0x00001640);
+    std::vector<uint32_t> buf;
+    buf.reserve(delay/32+2);
+    buf.push_back(0x00001640);
     for (int i = 0; i<delay/32; i++){
-        core->writeFifo(0x00000000);
+        buf.push_back(0x00000000);
     }
-    core->writeFifo(0x1D000000>>delay%32);
+    buf.push_back(0x1D000000>>delay%32);
+    core->writeFifoBlock(buf.data(), buf.size());
     core->releaseFifo();
 }
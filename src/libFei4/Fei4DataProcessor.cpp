@@ -1,6 +1,7 @@
 #include "AllProcessors.h"
 #include "Fei4DataProcessor.h"
 #include "LoopStatus.h"
+#include "MultiController.h"
 
 #include <iostream>
 
@@ -27,6 +28,7 @@ void Fei4DataProcessor::init() {
     std::cout << __PRETTY_FUNCTION__ << std::endl;
     for(std::map<unsigned, ClipBoard<EventDataBase> >::iterator it = outMap->begin(); it != outMap->end(); ++it) {
         activeChannels.push_back(it->first);
+        ctrlChannels[MultiController::ctrlOf(it->first)].push_back(it->first);
     }
     scanDone = false;
 }
@@ -84,13 +86,19 @@ void Fei4DataProcessor::process_core() {
         if (curInV == nullptr)
             continue;
 
+        // Only the channels of the controller the data came from
+        auto ctrlIt = ctrlChannels.find(curInV->ctrl);
+        if (ctrlIt == ctrlChannels.end())
+            continue;
+        const std::vector<unsigned> &channels = ctrlIt->second;
+
         // Create Output Container
         std::map<unsigned, std::unique_ptr<Fei4Data>> curOut;
         std::map<unsigned, int> events;
-        for (unsigned i=0; i<activeChannels.size(); i++) {
-            curOut[activeChannels[i]].reset(new Fei4Data());
-            curOut[activeChannels[i]]->lStat = curInV->stat;
-            events[activeChannels[i]] = 0;
+        for (unsigned i=0; i<channels.size(); i++) {
+            curOut[channels[i]].reset(new Fei4Data());
+            curOut[channels[i]]->lStat = curInV->stat;
+            events[channels[i]] = 0;
         }
 
         unsigned size = curInV->size();
@@ -103,7 +111,7 @@ void Fei4DataProcessor::process_core() {
             for (unsigned i=0; i<words; i++) {
                 uint32_t value = curIn->buf[i];
                 uint32_t header = ((value & 0x00FF0000) >> 16);
-                unsigned channel = ((value & 0xFC000000) >> 26);
+                unsigned channel = MultiController::globalOf(curInV->ctrl, (value & 0xFC000000) >> 26);
                 unsigned type = ((value &0x03000000) >> 24);
                 if (type == 0x1) {
                     tag[channel] = unsigned(value & 0x00FFFFFF);
@@ -164,8 +172,8 @@ void Fei4DataProcessor::process_core() {
             }
             delete curIn;
         }
-        for (unsigned i=0; i<activeChannels.size(); i++) {
-            outMap->at(activeChannels[i]).pushData(std::move(curOut[activeChannels[i]]));
+        for (unsigned i=0; i<channels.size(); i++) {
+            outMap->at(channels[i]).pushData(std::move(curOut[channels[i]]));
         }
         //Cleanup
         dataCnt++;
@@ -52,8 +52,10 @@ void Fei4DcLoop::execPart1() {
         std::cout << __PRETTY_FUNCTION__ << " --> " << m_col << std::endl;
     g_stat->set(this, m_col);
     // Address col
-    keeper->globalFe<Fei4>()->writeRegister(&Fei4::Colpr_Addr, m_col);
-    while(!g_tx->isCmdEmpty());
+    m_programs.run(g_fe, g_tx, m_col, [&]() {
+        keeper->globalFe<Fei4>()->writeRegister(&Fei4::Colpr_Addr, m_col);
+    });
+    g_tx->fence();
 }
 
 void Fei4DcLoop::execPart2() {
@@ -67,5 +67,5 @@ void Fei4DigitalScan::preScan() {
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Lat, 255-triggerDelay-4);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::DigHitIn_Sel, 0x1);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Vthin_Coarse, 200);
-    while(g_tx->isCmdEmpty() == 0);
+    g_tx->fence();
 }
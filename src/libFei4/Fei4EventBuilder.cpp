@@ -0,0 +1,194 @@
+// #################################
+// # Project: Yarr
+// # Description: Merges the events of several FEs into module events
+// # Comment: Events are matched by tag, L1ID and BCID inside a bounded
+// #          reorder window, the per FE data is handed on unchanged
+// ################################
+
+#include "Fei4EventBuilder.h"
+
+#include <chrono>
+#include <iostream>
+
+Fei4EventBuilder::Fei4EventBuilder() : DataProcessor() {
+    inMap = nullptr;
+    outMap = nullptr;
+    output = nullptr;
+    allMask = 0;
+    window = 8192;
+    head = 0;
+    tail = 0;
+    nComplete = 0;
+    nIncomplete = 0;
+}
+
+Fei4EventBuilder::~Fei4EventBuilder() {
+}
+
+void Fei4EventBuilder::addChannel(unsigned ch, unsigned colOffset, unsigned rowOffset) {
+    if (channels.size() == 64) {
+        std::cerr << "#ERROR# Event builder can not merge more than 64 channels, ignoring channel " << ch << std::endl;
+        return;
+    }
+    allMask |= (uint64_t)1 << channels.size();
+    channels.push_back({ch, colOffset, rowOffset, 0});
+}
+
+void Fei4EventBuilder::init() {
+    scanDone = false;
+    slots.clear();
+    slots.resize(window);
+    head = 0;
+    tail = 0;
+    pending.clear();
+    pending.reserve(window*2);
+    for (auto &c : channels)
+        c.next = 0;
+    curOut.reset();
+    nComplete = 0;
+    nIncomplete = 0;
+}
+
+void Fei4EventBuilder::run() {
+    thread_ptr.reset(new std::thread(&Fei4EventBuilder::process, this));
+}
+
+void Fei4EventBuilder::join() {
+    if (thread_ptr->joinable()) thread_ptr->join();
+}
+
+void Fei4EventBuilder::process() {
+    while (true) {
+        // Data pushed before scanDone was set is picked up by this last round
+        bool done = scanDone;
+        process_core();
+        if (done)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    this->flush();
+    std::cout << __PRETTY_FUNCTION__ << ": built " << nComplete << " complete and "
+        << nIncomplete << " incomplete module events" << std::endl;
+}
+
+void Fei4EventBuilder::process_core() {
+    // One container per FE in turn, so a backlog on one link does not push
+    // the events of the others out of the window
+    bool more = true;
+    while (more) {
+        more = false;
+        for (unsigned i=0; i<channels.size(); i++) {
+            ClipBoard<EventDataBase> &in = inMap->at(channels[i].rx);
+            if (in.empty())
+                continue;
+            std::unique_ptr<EventDataBase> d = in.popData();
+            if (d == nullptr)
+                continue;
+            more = true;
+            Fei4Data *data = dynamic_cast<Fei4Data*>(d.get());
+            if (data != nullptr) {
+                for (auto &event : data->events)
+                    this->add(i, event, data->lStat);
+            }
+            outMap->at(channels[i].rx).pushData(std::move(d));
+        }
+    }
+    if (curOut != nullptr)
+        output->pushData(std::move(curOut));
+}
+
+void Fei4EventBuilder::add(unsigned idx, Fei4Event &event, const LoopStatus &stat) {
+    uint64_t key = ((uint64_t)event.tag << 32) | ((uint64_t)event.l1id << 16) | event.bcid;
+    uint64_t bit = (uint64_t)1 << idx;
+    Channel &c = channels[idx];
+
+    // The links deliver the events in the same order, so the slot after the
+    // last one of this FE usually matches without a lookup
+    uint64_t seq = tail;
+    Slot *s = &slots[c.next % window];
+    if (c.next >= head && c.next < tail && s->used && s->key == key && !(s->chMask & bit)) {
+        seq = c.next;
+    } else {
+        auto it = pending.find(key);
+        if (it != pending.end()) {
+            s = &slots[it->second % window];
+            if (s->chMask & bit) {
+                // Seen on this FE already, the counters wrapped around
+                this->publish(it->second);
+                this->advance();
+            } else {
+                seq = it->second;
+            }
+        }
+    }
+
+    if (seq == tail) {
+        if (tail - head == window) {
+            this->publish(head);
+            this->advance();
+        }
+        tail++;
+        s = &slots[seq % window];
+        s->used = true;
+        s->key = key;
+        s->chMask = 0;
+        s->stat = stat;
+        s->event.tag = event.tag;
+        s->event.l1id = event.l1id;
+        s->event.bcid = event.bcid;
+        pending[key] = seq;
+    } else {
+        s = &slots[seq % window];
+    }
+
+    s->chMask |= bit;
+    c.next = seq+1;
+    for (auto &hit : event.hits)
+        s->event.addHit(hit.row + c.rowOffset, hit.col + c.colOffset, hit.tot);
+
+    if (s->chMask == allMask) {
+        this->publish(seq);
+        this->advance();
+    }
+}
+
+// Filed under the loop status of the container which opened the slot
+void Fei4EventBuilder::publish(uint64_t seq) {
+    Slot &s = slots[seq % window];
+    const LoopStatus &stat = s.stat;
+    if (s.chMask == allMask) {
+        nComplete++;
+    } else {
+        nIncomplete++;
+    }
+
+    // Module events of different loop iterations go into separate containers
+    if (curOut == nullptr || !(curOut->lStat == stat)) {
+        if (curOut != nullptr)
+            output->pushData(std::move(curOut));
+        curOut.reset(new Fei4Data());
+        curOut->lStat = stat;
+    }
+    curOut->events.push_back(std::move(s.event));
+    curOut->curEvent = &curOut->events.back();
+
+    s.event = Fei4Event();
+    s.used = false;
+    pending.erase(s.key);
+}
+
+void Fei4EventBuilder::advance() {
+    while (head < tail && !slots[head % window].used)
+        head++;
+}
+
+void Fei4EventBuilder::flush() {
+    // Whatever is still waiting will not be completed anymore
+    for (uint64_t seq=head; seq<tail; seq++) {
+        if (slots[seq % window].used)
+            this->publish(seq);
+    }
+    head = tail;
+    if (curOut != nullptr)
+        output->pushData(std::move(curOut));
+}
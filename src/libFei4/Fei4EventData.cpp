@@ -1,4 +1,5 @@
 #include "Fei4EventData.h"
+#include "Fei4Clusterer.h"
 
 #include <fstream>
 #include <iostream>
@@ -27,48 +28,11 @@ void Fei4Event::fromFileBinary(std::fstream &handle) {
     }
 }
 
-void Fei4Event::doClustering() {
-    // No hits = no cluster
-    if (nHits == 0)
-        return ;
-    // Create "copy" of hits
-    std::list<Fei4Hit*> unclustered;
-    for (auto &&hit : hits) {
-        unclustered.push_back(&hit);
-    }
-    
-    // Create first cluster and add first hit
-    clusters.push_back(Fei4Cluster());
-    clusters.back().addHit(unclustered.front());
-    unclustered.erase(unclustered.begin());
-
-    int gap = 1;
-
-    // Loop over vector of unclustered hits until empty
-    while (!unclustered.empty()) {
-        // Loop over hits in cluster, increases as we go
-        for (unsigned i=0; i<clusters.back().nHits; i++) {
-            Fei4Hit tHit = *clusters.back().hits[i];
-            // Loop over unclustered hits
-            for (auto j = unclustered.begin() ; j != unclustered.end(); ++j) {
-                if ((abs((int)(tHit.col) - (int)(*j)->col) <= (1+gap))
-                 && (abs((int)(tHit.row) - (int)(*j)->row) <= (1+gap))) {
-                    // If not more than 1 pixel gap, add to cluster
-                    clusters.back().addHit(*j);
-                    unclustered.erase(j--);
-                }
-            }
-        }
-        // Still hits to be clustered, create new cluster
-        if (!unclustered.empty()) {
-            clusters.push_back(Fei4Cluster());
-            clusters.back().addHit(unclustered.front());
-            unclustered.erase(unclustered.begin());
-        }
-    }
-    // All clustered
-        
-    
+void Fei4Event::doClustering(unsigned gap) {
+    // Every thread keeps its own grid, sized by the largest event seen
+    static thread_local Fei4Clusterer clusterer;
+    clusterer.setGap(gap);
+    clusterer.cluster(*this);
 }
 
 void Fei4Data::toFile(std::string filename) {
@@ -10,6 +10,158 @@
 
 #include <fstream>
 
+#include "NameHash.h"
+
+namespace {
+    struct RegDef {
+        const char *name;
+        uint32_t hash;
+        Fei4Register Fei4GlobalCfg::*ref;
+        unsigned addr;
+        unsigned bOffset;
+        unsigned bits;
+        uint16_t value;
+        bool msbRight;
+    };
+
+    constexpr RegDef def(const char *name, Fei4Register Fei4GlobalCfg::*ref, unsigned addr, unsigned bOffset, unsigned bits, uint16_t value, bool msbRight=false) {
+        return {name, NameHash::hash(name), ref, addr, bOffset, bits, value, msbRight};
+    }
+
+    // Name, address, offset, size and default of every field, see page 118
+    // FE-I4B Manual
+    constexpr RegDef regDefs[] = {
+        // 1
+        def("SME", &Fei4GlobalCfg::SME, 1, 0x8, 1, 0),
+        def("EventLimit", &Fei4GlobalCfg::EventLimit, 1, 0x0, 8, 0, true),
+        // 2
+        def("Trig_Count", &Fei4GlobalCfg::Trig_Count, 2, 0xC, 4, 1),
+        def("Conf_AddrEnable", &Fei4GlobalCfg::Conf_AddrEnable, 2, 0xB, 1, 1),
+        // 3
+        def("ErrorMask_0", &Fei4GlobalCfg::ErrorMask_0, 3, 0x0, 16, 0x4600),
+        // 4
+        def("ErrorMask_1", &Fei4GlobalCfg::ErrorMask_1, 4, 0x0, 16, 0x0040),
+        // 5
+        def("PrmpVbp_R", &Fei4GlobalCfg::PrmpVbp_R, 5, 0x8, 8, 43, true),
+        def("BufVgOpAmp", &Fei4GlobalCfg::BufVgOpAmp, 5, 0x0, 8, 160, true),
+        // 6
+        def("PrmpVbp", &Fei4GlobalCfg::PrmpVbp, 6, 0x0, 8, 43, true),
+        // 7
+        def("TDACVbp", &Fei4GlobalCfg::TDACVbp, 7, 0x8, 8, 150, true),
+        def("DisVbn", &Fei4GlobalCfg::DisVbn, 7, 0x0, 8, 40, true),
+        // 8
+        def("Amp2Vbn", &Fei4GlobalCfg::Amp2Vbn, 8, 0x8, 8, 79, true),
+        def("Amp2VbpFol", &Fei4GlobalCfg::Amp2VbpFol, 8, 0x0, 8, 26, true),
+        // 9
+        def("Amp2Vbp", &Fei4GlobalCfg::Amp2Vbp, 9, 0x0, 8, 85, true),
+        // 10
+        def("FDACVbn", &Fei4GlobalCfg::FDACVbn, 10, 0x8, 8, 30, true),
+        def("Amp2Vbpff", &Fei4GlobalCfg::Amp2Vbpff, 10, 0x0, 8, 50, true),
+        // 11
+        def("PrmpVbnFol", &Fei4GlobalCfg::PrmpVbnFol, 11, 0x8, 8, 106, true),
+        def("PrmpVbp_L", &Fei4GlobalCfg::PrmpVbp_L, 11, 0x0, 8, 43, true),
+        // 12
+        def("PrmpVbpf", &Fei4GlobalCfg::PrmpVbpf, 12, 0x8, 8, 40, true),
+        def("PrmpVbnLCC", &Fei4GlobalCfg::PrmpVbnLCC, 12, 0x0, 8, 0, true),
+        // 13
+        def("S1", &Fei4GlobalCfg::S1, 13, 0xF, 1, 0),
+        def("S0", &Fei4GlobalCfg::S0, 13, 0xE, 1, 0),
+        def("Pixel_latch_strobe", &Fei4GlobalCfg::Pixel_latch_strobe, 13, 0x1, 13, 0, true),
+        // 14
+        def("LVDSDrvIref", &Fei4GlobalCfg::LVDSDrvIref, 14, 0x8, 8, 171, true),
+        def("GADCCompBias", &Fei4GlobalCfg::GADCCompBias, 14, 0x0, 8, 100, true),
+        // 15
+        def("PllIbias", &Fei4GlobalCfg::PllIbias, 15, 0x8, 8, 88, true),
+        def("LVDSDrvVos", &Fei4GlobalCfg::LVDSDrvVos, 15, 0x0, 8, 105, true),
+        // 16
+        def("TempSensIbias", &Fei4GlobalCfg::TempSensIbias, 16, 0x8, 8, 0, true),
+        def("PllIcp", &Fei4GlobalCfg::PllIcp, 16, 0x0, 8, 28, true),
+        // 17
+        def("PlsrIDACRamp", &Fei4GlobalCfg::PlsrIDACRamp, 17, 0x0, 8, 213, true),
+        // 18
+        def("VrefDigTune", &Fei4GlobalCfg::VrefDigTune, 18, 0x8, 8, 110, true),
+        def("PlsrVgOpAmp", &Fei4GlobalCfg::PlsrVgOpAmp, 18, 0x0, 8, 255, true),
+        // 19
+        def("PlsrDACbias", &Fei4GlobalCfg::PlsrDACbias, 19, 0x8, 8, 96, true),
+        def("VrefAnTune", &Fei4GlobalCfg::VrefAnTune, 19, 0x0, 8, 50, true),
+        // 20
+        def("Vthin_Coarse", &Fei4GlobalCfg::Vthin_Coarse, 20, 0x8, 8, 0, true),
+        def("Vthin_Fine", &Fei4GlobalCfg::Vthin_Fine, 20, 0x0, 8, 150, true),
+        // 21
+        def("HitLD", &Fei4GlobalCfg::HitLD, 21, 0xC, 1, 0),
+        def("DJO", &Fei4GlobalCfg::DJO, 21, 0xB, 1, 0),
+        def("DigHitIn_Sel", &Fei4GlobalCfg::DigHitIn_Sel, 21, 0xA, 1, 0),
+        def("PlsrDAC", &Fei4GlobalCfg::PlsrDAC, 21, 0x0, 10, 54, true),
+        // 22
+        def("Colpr_Mode", &Fei4GlobalCfg::Colpr_Mode, 22, 0x8, 2, 0, true),
+        def("Colpr_Addr", &Fei4GlobalCfg::Colpr_Addr, 22, 0x2, 6, 0, true),
+        // 23
+        def("DisableColCnfg0", &Fei4GlobalCfg::DisableColCnfg0, 23, 0x0, 16, 0),
+        // 24
+        def("DisableColCnfg1", &Fei4GlobalCfg::DisableColCnfg1, 24, 0x0, 16, 0),
+        // 25
+        def("Trig_Lat", &Fei4GlobalCfg::Trig_Lat, 25, 0x8, 8, 210),
+        def("DisableColCnfg2", &Fei4GlobalCfg::DisableColCnfg2, 25, 0x0, 8, 0),
+        // 26
+        def("CMDcnt12", &Fei4GlobalCfg::CMDcnt12, 26, 0x3, 13, 0),
+        def("CalPulseWidth", &Fei4GlobalCfg::CalPulseWidth, 26, 0x3, 8, 10),
+        def("CalPulseDelay", &Fei4GlobalCfg::CalPulseDelay, 26, 0xB, 5, 0),
+        def("StopModeConfig", &Fei4GlobalCfg::StopModeConfig, 26, 0x2, 1, 0),
+        def("HitDiscCnfg", &Fei4GlobalCfg::HitDiscCnfg, 26, 0x0, 2, 0),
+        // 27
+        def("PLL_Enable", &Fei4GlobalCfg::PLL_Enable, 27, 0xF, 1, 1),
+        def("EFS", &Fei4GlobalCfg::EFS, 27, 0xE, 1, 0),
+        def("StopClkPulse", &Fei4GlobalCfg::StopClkPulse, 27, 0xD, 1, 0),
+        def("ReadErrorReq", &Fei4GlobalCfg::ReadErrorReq, 27, 0xC, 1, 0),
+        def("GADC_En", &Fei4GlobalCfg::GADC_En, 27, 0xA, 1, 0),
+        def("SRRead", &Fei4GlobalCfg::SRRead, 27, 0x9, 1, 0),
+        def("HitOr", &Fei4GlobalCfg::HitOr, 27, 0x5, 1, 0),
+        def("CalEn", &Fei4GlobalCfg::CalEn, 27, 0x4, 1, 0),
+        def("SRClr", &Fei4GlobalCfg::SRClr, 27, 0x3, 1, 0),
+        def("Latch_Enable", &Fei4GlobalCfg::Latch_Enable, 27, 0x2, 1, 0),
+        def("SR_Clock", &Fei4GlobalCfg::SR_Clock, 27, 0x1, 1, 0),
+        def("M13", &Fei4GlobalCfg::M13, 27, 0x0, 1, 0),
+        // 28
+        def("LVDSDrvSet06", &Fei4GlobalCfg::LVDSDrvSet06, 28, 0xF, 1, 1),
+        def("EN_40M", &Fei4GlobalCfg::EN_40M, 28, 0x9, 1, 1),
+        def("EN_80M", &Fei4GlobalCfg::EN_80M, 28, 0x8, 1, 0),
+        def("CLK1_S0", &Fei4GlobalCfg::CLK1_S0, 28, 0x7, 1, 0),
+        def("CLK1_S1", &Fei4GlobalCfg::CLK1_S1, 28, 0x6, 1, 0),
+        def("CLK1_S2", &Fei4GlobalCfg::CLK1_S2, 28, 0x5, 1, 0),
+        def("CLK0_S0", &Fei4GlobalCfg::CLK0_S0, 28, 0x4, 1, 0),
+        def("CLK0_S1", &Fei4GlobalCfg::CLK0_S1, 28, 0x3, 1, 0),
+        def("CLK0_S2", &Fei4GlobalCfg::CLK0_S2, 28, 0x2, 1, 1),
+        def("EN_160", &Fei4GlobalCfg::EN_160, 28, 0x1, 1, 1),
+        def("EN_320", &Fei4GlobalCfg::EN_320, 28, 0x0, 1, 0),
+        // 29
+        def("No8b10b", &Fei4GlobalCfg::No8b10b, 29, 0xD, 1, 0),
+        def("Clk2Out", &Fei4GlobalCfg::Clk2Out, 29, 0xC, 1, 0),
+        def("EmptyRecordCnfg", &Fei4GlobalCfg::EmptyRecordCnfg, 29, 0x4, 8, 0),
+        def("LVDSDrvEn", &Fei4GlobalCfg::LVDSDrvEn, 29, 0x2, 1, 1),
+        def("LVDSDrvSet30", &Fei4GlobalCfg::LVDSDrvSet30, 29, 0x1, 1, 1),
+        def("LVDSDrvSet12", &Fei4GlobalCfg::LVDSDrvSet12, 29, 0x0, 1, 1),
+        // 30
+        def("TmpSensDiodeSel", &Fei4GlobalCfg::TmpSensDiodeSel, 30, 0xE, 2, 0),
+        def("TmpSensDisable", &Fei4GlobalCfg::TmpSensDisable, 30, 0xD, 1, 0),
+        def("IleakRange", &Fei4GlobalCfg::IleakRange, 30, 0xC, 1, 0),
+        // 31
+        def("PlsrRiseUpTau", &Fei4GlobalCfg::PlsrRiseUpTau, 31, 0xD, 3, 7),
+        def("PlsrPwr", &Fei4GlobalCfg::PlsrPwr, 31, 0xC, 1, 1),
+        def("PlsrDelay", &Fei4GlobalCfg::PlsrDelay, 31, 0x6, 6, 2, true),
+        def("ExtDigCalSW", &Fei4GlobalCfg::ExtDigCalSW, 31, 0x5, 1, 0),
+        def("ExtAnaCalSW", &Fei4GlobalCfg::ExtAnaCalSW, 31, 0x4, 1, 0),
+        def("GADCSel", &Fei4GlobalCfg::GADCSel, 31, 0x0, 3, 0),
+        // 32
+        def("SELB0", &Fei4GlobalCfg::SELB0, 32, 0x0, 16, 0),
+        // 33
+        def("SELB1", &Fei4GlobalCfg::SELB1, 33, 0x0, 16, 0),
+        // 34
+        def("SELB2", &Fei4GlobalCfg::SELB2, 34, 0x8, 8, 0),
+        def("PrmpVbpMsbEn", &Fei4GlobalCfg::PrmpVbpMsbEn, 34, 0x4, 1, 0),
+    };
+    constexpr auto regOrder = NameHash::order(regDefs);
+}
+
 Fei4GlobalCfg::Fei4GlobalCfg() {
     this->init();
 }
@@ -21,138 +173,22 @@ void Fei4GlobalCfg::init() {
         cfg[i] = 0;
 
     // Initialize fields with default config
-    // 1
-    SME.initReg(cfg, 0, 1, 0x8, 1); regMap["SME"] = &Fei4GlobalCfg::SME;
-    EventLimit.initReg(cfg, 0, 1 , 0x0, 8, true); regMap["EventLimit"] = &Fei4GlobalCfg::EventLimit;
-    // 2
-    Trig_Count.initReg(cfg, 1, 2, 0xC, 4); regMap["Trig_Count"] = &Fei4GlobalCfg::Trig_Count;
-    Conf_AddrEnable.initReg(cfg, 1, 2, 0xB, 1); regMap["Conf_AddrEnable"] = &Fei4GlobalCfg::Conf_AddrEnable;
-    // 3
-    ErrorMask_0.initReg(cfg, 0x4600, 3, 0x0, 16); regMap["ErrorMask_0"] = &Fei4GlobalCfg::ErrorMask_0;
-    // 4
-    ErrorMask_1.initReg(cfg, 0x0040, 4, 0x0, 16); regMap["ErrorMask_1"] = &Fei4GlobalCfg::ErrorMask_1;
-    // 5
-    PrmpVbp_R.initReg(cfg, 43, 5, 0x8, 8, true); regMap["PrmpVbp_R"] = &Fei4GlobalCfg::PrmpVbp_R;
-    BufVgOpAmp.initReg(cfg, 160, 5, 0x0, 8, true); regMap["BufVgOpAmp"] = &Fei4GlobalCfg::BufVgOpAmp;
-    // 6
-    PrmpVbp.initReg(cfg, 43, 6, 0x0 , 8, true); regMap["PrmpVbp"] = &Fei4GlobalCfg::PrmpVbp;
-    // 7
-    TDACVbp.initReg(cfg, 150, 7, 0x8, 8, true); regMap["TDACVbp"] = &Fei4GlobalCfg::TDACVbp;
-    DisVbn.initReg(cfg, 40, 7, 0x0, 8, true); regMap["DisVbn"] = &Fei4GlobalCfg::DisVbn;
-    // 8
-    Amp2Vbn.initReg(cfg, 79, 8, 0x8, 8, true); regMap["Amp2Vbn"] = &Fei4GlobalCfg::Amp2Vbn;
-    Amp2VbpFol.initReg(cfg, 26, 8, 0x0, 8, true); regMap["Amp2VbpFol"] = &Fei4GlobalCfg::Amp2VbpFol;
-    // 9
-    Amp2Vbp.initReg(cfg, 85, 9, 0x0, 8, true); regMap["Amp2Vbp"] = &Fei4GlobalCfg::Amp2Vbp;
-    // 10
-    FDACVbn.initReg(cfg, 30, 10, 0x8, 8, true); regMap["FDACVbn"] = &Fei4GlobalCfg::FDACVbn;
-    Amp2Vbpff.initReg(cfg, 50, 10, 0x0, 8, true); regMap["Amp2Vbpff"] = &Fei4GlobalCfg::Amp2Vbpff;
-    // 11
-    PrmpVbnFol.initReg(cfg, 106, 11, 0x8, 8, true); regMap["PrmpVbnFol"] = &Fei4GlobalCfg::PrmpVbnFol; 
-    PrmpVbp_L.initReg(cfg, 43, 11, 0x0, 8, true); regMap["PrmpVbp_L"] = &Fei4GlobalCfg::PrmpVbp_L;
-    // 12
-    PrmpVbpf.initReg(cfg, 40, 12, 0x8, 8, true); regMap["PrmpVbpf"] = &Fei4GlobalCfg::PrmpVbpf;
-    PrmpVbnLCC.initReg(cfg, 0, 12, 0x0, 8, true); regMap["PrmpVbnLCC"] = &Fei4GlobalCfg::PrmpVbnLCC;
-    // 13
-    S1.initReg(cfg, 0, 13, 0xF, 1); regMap["S1"] = &Fei4GlobalCfg::S1;
-    S0.initReg(cfg, 0, 13, 0xE, 1); regMap["S0"] = &Fei4GlobalCfg::S0;
-    Pixel_latch_strobe.initReg(cfg, 0, 13, 0x1, 13, true); regMap["Pixel_latch_strobe"] = &Fei4GlobalCfg::Pixel_latch_strobe;
-    // 14
-    LVDSDrvIref.initReg(cfg, 171, 14, 0x8, 8, true); regMap["LVDSDrvIref"] = &Fei4GlobalCfg::LVDSDrvIref;
-    GADCCompBias.initReg(cfg, 100, 14, 0x0, 8, true); regMap["GADCCompBias"] = &Fei4GlobalCfg::GADCCompBias;
-    // 15
-    PllIbias.initReg(cfg, 88, 15, 0x8, 8 , true); regMap["PllIbias"] = &Fei4GlobalCfg::PllIbias;
-    LVDSDrvVos.initReg(cfg, 105, 15, 0x0, 8, true); regMap["LVDSDrvVos"] = &Fei4GlobalCfg::LVDSDrvVos;
-    // 16
-    TempSensIbias.initReg(cfg, 0, 16, 0x8, 8, true); regMap["TempSensIbias"] = &Fei4GlobalCfg::TempSensIbias;
-    PllIcp.initReg(cfg, 28, 16, 0x0, 8, true); regMap["PllIcp"] = &Fei4GlobalCfg::PllIcp;
-    // 17
-    PlsrIDACRamp.initReg(cfg, 213, 17, 0x0, 8, true); regMap["PlsrIDACRamp"] = &Fei4GlobalCfg::PlsrIDACRamp;
-    // 18
-    VrefDigTune.initReg(cfg, 110, 18, 0x8, 8, true); regMap["VrefDigTune"] = &Fei4GlobalCfg::VrefDigTune;
-    PlsrVgOpAmp.initReg(cfg, 255, 18, 0x0, 8, true); regMap["PlsrVgOpAmp"] = &Fei4GlobalCfg::PlsrVgOpAmp;
-    // 19
-    PlsrDACbias.initReg(cfg, 96, 19, 0x8, 8, true); regMap["PlsrDACbias"] = &Fei4GlobalCfg::PlsrDACbias;
-    VrefAnTune.initReg(cfg, 50, 19, 0x0, 8, true); regMap["VrefAnTune"] = &Fei4GlobalCfg::VrefAnTune;
-    // 20
-    Vthin_Coarse.initReg(cfg, 0, 20, 0x8, 8, true); regMap["Vthin_Coarse"] = &Fei4GlobalCfg::Vthin_Coarse;
-    Vthin_Fine.initReg(cfg, 150, 20, 0x0, 8, true); regMap["Vthin_Fine"] = &Fei4GlobalCfg::Vthin_Fine;
-    // 21
-    HitLD.initReg(cfg, 0, 21, 0xC, 1); regMap["HitLD"] = &Fei4GlobalCfg::HitLD;
-    DJO.initReg(cfg, 0, 21, 0xB, 1); regMap["DJO"] = &Fei4GlobalCfg::DJO;
-    DigHitIn_Sel.initReg(cfg, 0, 21, 0xA, 1); regMap["DigHitIn_Sel"] = &Fei4GlobalCfg::DigHitIn_Sel;
-    PlsrDAC.initReg(cfg, 54, 21, 0x0, 10, true); regMap["PlsrDAC"] = &Fei4GlobalCfg::PlsrDAC;
-    // 22
-    Colpr_Mode.initReg(cfg, 0, 22, 0x8, 2, true); regMap["Colpr_Mode"] = &Fei4GlobalCfg::Colpr_Mode;
-    Colpr_Addr.initReg(cfg, 0, 22, 0x2, 6, true); regMap["Colpr_Addr"] = &Fei4GlobalCfg::Colpr_Addr;
-    // 23
-    DisableColCnfg0.initReg(cfg, 0, 23, 0x0, 16); regMap["DisableColCnfg0"] = &Fei4GlobalCfg::DisableColCnfg0;
-    // 24
-    DisableColCnfg1.initReg(cfg, 0, 24, 0x0, 16); regMap["DisableColCnfg1"] = &Fei4GlobalCfg::DisableColCnfg1;
-    // 25
-    Trig_Lat.initReg(cfg, 210, 25, 0x8, 8); regMap["Trig_Lat"] = &Fei4GlobalCfg::Trig_Lat;
-    DisableColCnfg2.initReg(cfg, 0, 25, 0x0, 8); regMap["DisableColCnfg2"] = &Fei4GlobalCfg::DisableColCnfg2;
-    // 26
-    CMDcnt12.initReg(cfg, 0, 26, 0x3, 13); regMap["CMDcnt12"] = &Fei4GlobalCfg::CMDcnt12;
-    CalPulseWidth.initReg(cfg, 10, 26, 0x3, 8); regMap["CalPulseWidth"] = &Fei4GlobalCfg::CalPulseWidth;
-    CalPulseDelay.initReg(cfg, 0, 26, 0xB, 5); regMap["CalPulseDelay"] = &Fei4GlobalCfg::CalPulseDelay;
-    StopModeConfig.initReg(cfg, 0, 26, 0x2, 1); regMap["StopModeConfig"] = &Fei4GlobalCfg::StopModeConfig;
-    HitDiscCnfg.initReg(cfg, 0, 26, 0x0, 2); regMap["HitDiscCnfg"] = &Fei4GlobalCfg::HitDiscCnfg;
-    // 27
-    PLL_Enable.initReg(cfg, 1, 27, 0xF, 1); regMap["PLL_Enable"] = &Fei4GlobalCfg::PLL_Enable;
-    EFS.initReg(cfg, 0, 27, 0xE, 1); regMap["EFS"] = &Fei4GlobalCfg::EFS;
-    StopClkPulse.initReg(cfg, 0, 27, 0xD, 1); regMap["StopClkPulse"] = &Fei4GlobalCfg::StopClkPulse;
-    ReadErrorReq.initReg(cfg, 0, 27, 0xC, 1); regMap["ReadErrorReq"] = &Fei4GlobalCfg::ReadErrorReq;
-    GADC_En.initReg(cfg, 0, 27, 0xA, 1); regMap["GADC_En"] = &Fei4GlobalCfg::GADC_En;
-    SRRead.initReg(cfg, 0, 27, 0x9, 1); regMap["SRRead"] = &Fei4GlobalCfg::SRRead;
-    HitOr.initReg(cfg, 0, 27, 0x5, 1); regMap["HitOr"] = &Fei4GlobalCfg::HitOr;
-    CalEn.initReg(cfg, 0, 27, 0x4, 1); regMap["CalEn"] = &Fei4GlobalCfg::CalEn;
-    SRClr.initReg(cfg, 0, 27, 0x3, 1); regMap["SRClr"] = &Fei4GlobalCfg::SRClr;
-    Latch_Enable.initReg(cfg, 0, 27, 0x2, 1); regMap["Latch_Enable"] = &Fei4GlobalCfg::Latch_Enable;
-    SR_Clock.initReg(cfg, 0, 27, 0x1, 1); regMap["SR_Clock"] = &Fei4GlobalCfg::SR_Clock;
-    M13.initReg(cfg, 0, 27, 0x0, 1); regMap["M13"] = &Fei4GlobalCfg::M13;
-    // 28
-    LVDSDrvSet06.initReg(cfg, 1, 28, 0xF, 1); regMap["LVDSDrvSet06"] = &Fei4GlobalCfg::LVDSDrvSet06;
-    EN_40M.initReg(cfg, 1, 28, 0x9, 1); regMap["EN_40M"] = &Fei4GlobalCfg::EN_40M;
-    EN_80M.initReg(cfg, 0, 28, 0x8, 1); regMap["EN_80M"] = &Fei4GlobalCfg::EN_80M;
-    CLK1_S0.initReg(cfg, 0, 28, 0x7, 1); regMap["CLK1_S0"] = &Fei4GlobalCfg::CLK1_S0;
-    CLK1_S1.initReg(cfg, 0, 28, 0x6, 1); regMap["CLK1_S1"] = &Fei4GlobalCfg::CLK1_S1;
-    CLK1_S2.initReg(cfg, 0, 28, 0x5, 1); regMap["CLK1_S2"] = &Fei4GlobalCfg::CLK1_S2;
-    CLK0_S0.initReg(cfg, 0, 28, 0x4, 1); regMap["CLK0_S0"] = &Fei4GlobalCfg::CLK0_S0;
-    CLK0_S1.initReg(cfg, 0, 28, 0x3, 1); regMap["CLK0_S1"] = &Fei4GlobalCfg::CLK0_S1;
-    CLK0_S2.initReg(cfg, 1, 28, 0x2, 1); regMap["CLK0_S2"] = &Fei4GlobalCfg::CLK0_S2;
-    EN_160.initReg(cfg, 1, 28, 0x1, 1); regMap["EN_160"] = &Fei4GlobalCfg::EN_160;
-    EN_320.initReg(cfg, 0, 28, 0x0, 1); regMap["EN_320"] = &Fei4GlobalCfg::EN_320;
-    // 29
-    No8b10b.initReg(cfg, 0, 29, 0xD, 1); regMap["No8b10b"] = &Fei4GlobalCfg::No8b10b;
-    Clk2Out.initReg(cfg, 0, 29, 0xC, 1); regMap["Clk2Out"] = &Fei4GlobalCfg::Clk2Out;
-    EmptyRecordCnfg.initReg(cfg, 0, 29, 0x4, 8); regMap["EmptyRecordCnfg"] = &Fei4GlobalCfg::EmptyRecordCnfg;
-    LVDSDrvEn.initReg(cfg, 1, 29, 0x2, 1); regMap["LVDSDrvEn"] = &Fei4GlobalCfg::LVDSDrvEn;
-    LVDSDrvSet30.initReg(cfg, 1, 29, 0x1, 1); regMap["LVDSDrvSet30"] = &Fei4GlobalCfg::LVDSDrvSet30;
-    LVDSDrvSet12.initReg(cfg, 1, 29, 0x0, 1); regMap["LVDSDrvSet12"] = &Fei4GlobalCfg::LVDSDrvSet12;
-    // 30
-    TmpSensDiodeSel.initReg(cfg, 0, 30, 0xE, 2); regMap["TmpSensDiodeSel"] = &Fei4GlobalCfg::TmpSensDiodeSel;
-    TmpSensDisable.initReg(cfg, 0, 30, 0xD, 1); regMap["TmpSensDisable"] = &Fei4GlobalCfg::TmpSensDisable;
-    IleakRange.initReg(cfg, 0, 30, 0xC, 1); regMap["IleakRange"] = &Fei4GlobalCfg::IleakRange;
-    // 31
-    PlsrRiseUpTau.initReg(cfg, 7, 31, 0xD, 3); regMap["PlsrRiseUpTau"] = &Fei4GlobalCfg::PlsrRiseUpTau;
-    PlsrPwr.initReg(cfg, 1, 31, 0xC, 1); regMap["PlsrPwr"] = &Fei4GlobalCfg::PlsrPwr;
-    PlsrDelay.initReg(cfg, 2, 31, 0x6, 6, true); regMap["PlsrDelay"] = &Fei4GlobalCfg::PlsrDelay;
-    ExtDigCalSW.initReg(cfg, 0, 31, 0x5, 1); regMap["ExtDigCalSW"] = &Fei4GlobalCfg::ExtDigCalSW;
-    ExtAnaCalSW.initReg(cfg, 0, 31, 0x4, 1); regMap["ExtAnaCalSW"] = &Fei4GlobalCfg::ExtAnaCalSW;
-    GADCSel.initReg(cfg, 0, 31, 0x0, 3); regMap["GADCSel"] = &Fei4GlobalCfg::GADCSel;
-    // 32
-    SELB0.initReg(cfg, 0, 32, 0x0, 16); regMap["SELB0"] = &Fei4GlobalCfg::SELB0;
-    // 33
-    SELB1.initReg(cfg, 0, 33, 0x0, 16); regMap["SELB1"] = &Fei4GlobalCfg::SELB1;
-    // 34
-    SELB2.initReg(cfg, 0, 34, 0x8, 8); regMap["SELB2"] = &Fei4GlobalCfg::SELB2;
-    PrmpVbpMsbEn.initReg(cfg, 0, 34, 0x4, 1); regMap["PrmpVbpMsbEn"] = &Fei4GlobalCfg::PrmpVbpMsbEn;
+    for (const RegDef &d : regDefs) {
+        (this->*d.ref).initReg(cfg, d.value, d.addr, d.bOffset, d.bits, d.msbRight);
+        regMap[d.name] = d.ref;
+    }
     //35
     EFUSE.initReg(cfg, 0, 35, 0x0, 16);
 }
 
 
+Fei4Register Fei4GlobalCfg::*Fei4GlobalCfg::findReg(const std::string &regName) {
+    int i = NameHash::find(regDefs, regOrder, regName);
+    if (i < 0)
+        return nullptr;
+    return regDefs[i].ref;
+}
+
 void Fei4GlobalCfg::toFilePlain(std::string filename) {
     std::fstream file(filename, std::fstream::out | std::fstream::trunc);
     
@@ -87,8 +87,7 @@ void Fei4GlobalPreampTune::preScan() {
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Count, 12);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Lat, (255-triggerDelay)-4);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::CalPulseWidth, 20); // Longer than max ToT 
-    while(!g_tx->isCmdEmpty())
-        ;
+    g_tx->fence();
 
     for(unsigned int k=0; k<g_bk->feList.size(); k++) {
         Fei4 *fe = dynamic_cast<Fei4*>(g_bk->feList[k]);
@@ -102,8 +101,7 @@ void Fei4GlobalPreampTune::preScan() {
             for (unsigned row=1; row<337; row++)
                 fe->setFDAC(col, row, 8);
         fe->configurePixels();
-        while(!g_tx->isCmdEmpty())
-            ;
+        g_tx->fence();
     }
 
     g_tx->setCmdEnable(g_bk->getTxMask());
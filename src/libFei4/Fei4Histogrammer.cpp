@@ -13,6 +13,8 @@
 bool Fei4Histogrammer::processorDone = false;
 
 Fei4Histogrammer::Fei4Histogrammer() {
+    summary = nullptr;
+    halfOcc = 1;
 }
 
 Fei4Histogrammer::~Fei4Histogrammer() {
@@ -64,6 +66,9 @@ void Fei4Histogrammer::process() {
     process_core();
     output->cv.notify_all();  // notification to the downstream
 
+    if (liveHistos) {
+        liveHistos->finish();
+    }
 }
 
 void Fei4Histogrammer::process_core() {
@@ -84,11 +89,119 @@ void Fei4Histogrammer::publish() {
     for (unsigned i=0; i<algorithms.size(); i++) {
         auto ptr = algorithms[i]->getHisto();
         if(ptr) {
+            if (summary != nullptr && ptr->getType() == typeid(OccupancyMap*)) {
+                this->summarise(static_cast<Histo2d*>(ptr.get()));
+            }
+            if (archiveHandle.is_open()) {
+                toArchive(archiveHandle, *ptr);
+            }
+            if (liveHistos) {
+                liveHistos->add(*ptr);
+            }
             output->pushData(std::move(ptr));
         }
     }
 }
 
+void Fei4Histogrammer::summarise(Histo2d *h) {
+    std::unique_ptr<OccupancySummary> s(new OccupancySummary);
+    s->stat = h->getStat();
+    s->nHit = 0;
+    s->nHalf = 0;
+    s->nMax = 0;
+    s->maxOcc = 0;
+    const double *data = h->getData();
+    for (unsigned i=0; i<h->size(); i++) {
+        unsigned occ = data[i];
+        if (occ == 0)
+            continue;
+        s->nHit++;
+        if (occ >= halfOcc)
+            s->nHalf++;
+        if (occ > s->maxOcc) {
+            s->maxOcc = occ;
+            s->nMax = 0;
+        }
+        if (occ == s->maxOcc)
+            s->nMax++;
+    }
+    summary->pushData(std::move(s));
+}
+
+namespace {
+    // Histogram types which can be archived, by their histogrammer name
+    const std::vector<std::pair<std::string, std::type_index>>& archiveTypes() {
+        static const std::vector<std::pair<std::string, std::type_index>> types = {
+            {"OccupancyMap", typeid(OccupancyMap*)},
+            {"TotMap", typeid(TotMap*)},
+            {"Tot2Map", typeid(Tot2Map*)},
+            {"TotDist", typeid(TotDist*)},
+            {"Tot3d", typeid(Tot3d*)},
+            {"L1Dist", typeid(L1Dist*)},
+            {"L13d", typeid(L13d*)},
+            {"HitsPerEvent", typeid(HitsPerEvent*)},
+            {"ClusterSizeMap", typeid(ClusterSizeMap*)},
+            {"ClusterShapeMap", typeid(ClusterShapeMap*)}
+        };
+        return types;
+    }
+}
+
+void Fei4Histogrammer::archive(std::string filename) {
+    archiveHandle.open(filename.c_str(), std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    if (!archiveHandle) {
+        std::cerr << __PRETTY_FUNCTION__ << " --> Could not open " << filename << ", histograms are not archived!" << std::endl;
+    }
+}
+
+// Each record is the histogrammer name, the dimension and the histogram
+void Fei4Histogrammer::toArchive(std::iostream &handle, HistogramBase &h) {
+    for (auto &type : archiveTypes()) {
+        if (type.second != h.getType())
+            continue;
+        uint8_t len = type.first.size();
+        uint8_t dim = 0;
+        if (dynamic_cast<Histo1d*>(&h)) dim = 1;
+        if (dynamic_cast<Histo2d*>(&h)) dim = 2;
+        if (dynamic_cast<Histo3d*>(&h)) dim = 3;
+        handle.write((const char*)&len, sizeof(len));
+        handle.write(type.first.data(), len);
+        handle.write((const char*)&dim, sizeof(dim));
+        h.toFileBinary(handle);
+        return;
+    }
+}
+
+// Returns nullptr at the end of the archive or if it is corrupted
+std::unique_ptr<HistogramBase> Fei4Histogrammer::fromArchive(std::iostream &handle) {
+    uint8_t len = 0;
+    uint8_t dim = 0;
+    handle.read((char*)&len, sizeof(len));
+    std::string typeName(len, ' ');
+    handle.read(&typeName[0], len);
+    handle.read((char*)&dim, sizeof(dim));
+    if (!handle)
+        return nullptr;
+
+    for (auto &type : archiveTypes()) {
+        if (type.first != typeName)
+            continue;
+        std::unique_ptr<HistogramBase> h;
+        if (dim == 1) {
+            h.reset(new Histo1d(typeName, 1, 0, 1, type.second));
+        } else if (dim == 2) {
+            h.reset(new Histo2d(typeName, 1, 0, 1, 1, 0, 1, type.second));
+        } else if (dim == 3) {
+            h.reset(new Histo3d(typeName, 1, 0, 1, 1, 0, 1, 1, 0, 1, type.second));
+        }
+        if (h != nullptr && h->fromFileBinary(handle))
+            return h;
+        break;
+    }
+    std::cerr << __PRETTY_FUNCTION__ << " --> Corrupted histogram archive at " << typeName << std::endl;
+    return nullptr;
+}
+
 void DataArchiver::processEvent(Fei4Data *data) {
     for (std::list<Fei4Event>::iterator eventIt = (data->events).begin(); eventIt!=data->events.end(); ++eventIt) {   
         Fei4Event curEvent = *eventIt;
@@ -226,3 +339,27 @@ void HitsPerEvent::processEvent(Fei4Data *data) {
         h->fill(curEvent.nHits);
     }
 }
+
+void ClusterSizeMap::processEvent(Fei4Data *data) {
+    for (auto &curEvent : data->events) {
+        if (curEvent.nHits == 0)
+            continue;
+        if (curEvent.nClusters == 0 || curEvent.clusterGap != gap)
+            curEvent.doClustering(gap);
+        for (auto &cluster : curEvent.clusters) {
+            for (auto hit : cluster.hits)
+                h->fill(hit->col, hit->row, cluster.nHits);
+        }
+    }
+}
+
+void ClusterShapeMap::processEvent(Fei4Data *data) {
+    for (auto &curEvent : data->events) {
+        if (curEvent.nHits == 0)
+            continue;
+        if (curEvent.nClusters == 0 || curEvent.clusterGap != gap)
+            curEvent.doClustering(gap);
+        for (auto &cluster : curEvent.clusters)
+            h->fill(cluster.getColLength(), cluster.getRowWidth());
+    }
+}
@@ -26,10 +26,29 @@ void Fei4MaskLoop::init() {
     keeper->globalFe<Fei4>()->initMask(MASK_1);
     if (enable_lCap) keeper->globalFe<Fei4>()->loadIntoPixel(1 << 6);
     if (enable_sCap) keeper->globalFe<Fei4>()->loadIntoPixel(1 << 7);
-    keeper->globalFe<Fei4>()->initMask(m_mask);
-    keeper->globalFe<Fei4>()->loadIntoPixel(1 << 0);
     m_cur = min;
-    while(g_tx->isCmdEmpty() == 0);
+
+    // Patterns of all stages as left by shifting the initial mask, so every
+    // stage is a single write however large the step is
+    m_stages.clear();
+    std::array<uint32_t, 21> bitstream;
+    bitstream.fill(m_mask);
+    for (int i=0; i<max; i++) {
+        m_stages.push_back(bitstream);
+        uint32_t carry = 0;
+        for (int j=20; j>=0; j--) {
+            uint32_t out = bitstream[j] >> 31;
+            bitstream[j] = (bitstream[j] << 1) | carry;
+            carry = out;
+        }
+    }
+    if (m_cur < m_stages.size()) {
+        keeper->globalFe<Fei4>()->writeMask(m_stages[m_cur].data());
+    } else {
+        keeper->globalFe<Fei4>()->initMask(m_mask);
+    }
+    keeper->globalFe<Fei4>()->loadIntoPixel(1 << 0);
+    g_tx->fence();
 }
 
 void Fei4MaskLoop::end() {
@@ -42,7 +61,7 @@ void Fei4MaskLoop::end() {
     keeper->globalFe<Fei4>()->loadIntoPixel(1 << 0);
     if (enable_lCap) keeper->globalFe<Fei4>()->loadIntoPixel(1 << 6);
     if (enable_sCap) keeper->globalFe<Fei4>()->loadIntoPixel(1 << 7);
-    while(g_tx->isCmdEmpty() == 0);
+    g_tx->fence();
 }
 
 void Fei4MaskLoop::execPart1() {
@@ -58,15 +77,15 @@ void Fei4MaskLoop::execPart2() {
         std::cout << __PRETTY_FUNCTION__ << std::endl;
     m_cur += step;
     if (!((int)m_cur < max)) m_done = true;
-    // Shift Enable mask by step size
-    for(unsigned i=0; i<step; i++) {
+    // Load Enable mask of the next stage
+    if (!m_done) {
         keeper->globalFe<Fei4>()->writeRegister(&Fei4::Colpr_Mode, 0x3);
         keeper->globalFe<Fei4>()->writeRegister(&Fei4::Colpr_Addr, 0x0);
-	keeper->globalFe<Fei4>()->shiftMask();
-	keeper->globalFe<Fei4>()->loadIntoPixel(1 << 0);
+        keeper->globalFe<Fei4>()->writeMask(m_stages[m_cur].data());
+        keeper->globalFe<Fei4>()->loadIntoPixel(1 << 0);
         //if (enable_lCap) keeper->globalFe<Fei4>()->loadIntoPixel(1 << 6);
         //if (enable_sCap) keeper->globalFe<Fei4>()->loadIntoPixel(1 << 7);
-        while(g_tx->isCmdEmpty() == 0);
+        g_tx->fence();
     }
 }
 
@@ -51,6 +51,6 @@ void Fei4NoiseScan::init() {
 void Fei4NoiseScan::preScan() {
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Lat, 235);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Count, 5);
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
 }
 
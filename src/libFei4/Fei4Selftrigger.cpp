@@ -58,6 +58,6 @@ void Fei4Selftrigger::preScan() {
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Lat, 235);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::HitOr, 1);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Count, 5);
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
 }
 
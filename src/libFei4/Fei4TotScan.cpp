@@ -74,8 +74,7 @@ void Fei4TotScan::preScan() {
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Count, 12);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::Trig_Lat, (255-triggerDelay)-4);
     g_bk->globalFe<Fei4>()->writeRegister(&Fei4::CalPulseWidth, 20); // Longer than max ToT 
-    while(!g_tx->isCmdEmpty())
-      ;
+    g_tx->fence();
     
     for(unsigned int k=0; k<g_bk->feList.size(); k++) {
       Fei4 *fe = dynamic_cast<Fei4*>(g_bk->feList[k]);
@@ -84,7 +83,7 @@ void Fei4TotScan::preScan() {
         g_tx->setCmdEnable(fe->getTxChannel());
         // Set specific pulser DAC
         fe->writeRegister(&Fei4::PlsrDAC, fe->toVcal(target, useScap, useLcap));
-        while(!g_tx->isCmdEmpty());
+        g_tx->fence();
       }
     }
     g_tx->setCmdEnable(g_bk->getTxMask());
@@ -49,7 +49,7 @@ void Fei4TriggerLoop::init() {
             g_tx->setCmdEnable(keeper->feList[i]->getTxChannel());
             keeper->feList[i]->setRunMode(true);
             usleep(100);
-            while(!g_tx->isCmdEmpty());
+            g_tx->fence();
         }
     }*/
 
@@ -57,7 +57,7 @@ void Fei4TriggerLoop::init() {
     g_tx->setCmdEnable(keeper->getTxMask());
     keeper->globalFe<Fei4>()->setRunMode(true);
     usleep(100); // Empty could be delayed
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
 }
 
 void Fei4TriggerLoop::end() {
@@ -65,12 +65,14 @@ void Fei4TriggerLoop::end() {
         std::cout << __PRETTY_FUNCTION__ << std::endl;
     // Go back to conf mode, general state of FE should be conf mode
     keeper->globalFe<Fei4>()->setRunMode(false);
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
 }
 
 void Fei4TriggerLoop::execPart1() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
+    // The previous stage may still be read out
+    LoopActionBase::waitDrained();
     // Enable Trigger
     g_tx->setTrigEnable(0x1);
 }
@@ -0,0 +1,144 @@
+// #################################
+// # Project: Yarr
+// # Description: Intermediate maps of long running scans
+// # Comment: Sums the published maps and writes them at a fixed interval,
+// #          once since the start and once over a rolling window
+// ################################
+
+#include "LiveHistogrammer.h"
+
+#include <iostream>
+
+LiveHistogrammer::LiveHistogrammer(std::string arg_prefix, std::string arg_dir, unsigned arg_interval, unsigned arg_window) {
+    prefix = arg_prefix;
+    dir = arg_dir;
+    interval = std::chrono::seconds(arg_interval);
+    if (interval.count() == 0)
+        interval = std::chrono::seconds(1);
+    window = arg_window;
+    if (window == 0)
+        window = 1;
+    keep = false;
+    doPlot = false;
+    nSnapshots = 0;
+    nSkipped = 0;
+    stop = false;
+    finishing = false;
+    writer = std::thread(&LiveHistogrammer::write, this);
+}
+
+LiveHistogrammer::~LiveHistogrammer() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stop = true;
+    }
+    cv.notify_all();
+    if (writer.joinable())
+        writer.join();
+}
+
+std::unique_ptr<Histo2d> LiveHistogrammer::emptyCopy(Histo2d &h) {
+    std::unique_ptr<Histo2d> c(new Histo2d(h.getName(), h.getXbins(), h.getXlow(), h.getXhigh(),
+                h.getYbins(), h.getYlow(), h.getYhigh(), h.getType()));
+    c->setXaxisTitle(h.getXaxisTitle());
+    c->setYaxisTitle(h.getYaxisTitle());
+    c->setZaxisTitle(h.getZaxisTitle());
+    return c;
+}
+
+void LiveHistogrammer::add(HistogramBase &h) {
+    Histo2d *map = dynamic_cast<Histo2d*>(&h);
+    if (map == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lk(dataMtx);
+    Entry &e = entries[map->getName()];
+    if (e.total == nullptr) {
+        e.total = emptyCopy(*map);
+        e.slices.push_back(emptyCopy(*map));
+    }
+    e.total->add(*map);
+    e.slices.back()->add(*map);
+}
+
+std::deque<LiveHistogrammer::Job> LiveHistogrammer::snapshot(bool doWrite) {
+    std::deque<Job> jobs;
+    std::lock_guard<std::mutex> lk(dataMtx);
+    std::string snapName = prefix + "_snapshot";
+    if (keep)
+        snapName += std::to_string(nSnapshots);
+    for (auto &it : entries) {
+        Entry &e = it.second;
+        if (doWrite) {
+            std::unique_ptr<Histo2d> total(new Histo2d(e.total.get()));
+            std::unique_ptr<Histo2d> rolling = emptyCopy(*e.total);
+            for (auto &slice : e.slices)
+                rolling->add(*slice);
+            total->setXaxisTitle(e.total->getXaxisTitle());
+            total->setYaxisTitle(e.total->getYaxisTitle());
+            total->setZaxisTitle(e.total->getZaxisTitle());
+            jobs.push_back({snapName, std::move(total)});
+            jobs.push_back({prefix + "_live", std::move(rolling)});
+        }
+
+        // Start the next interval, the oldest one drops out of the window
+        e.slices.push_back(emptyCopy(*e.total));
+        while (e.slices.size() > window)
+            e.slices.pop_front();
+    }
+    if (doWrite && !entries.empty())
+        nSnapshots++;
+    return jobs;
+}
+
+void LiveHistogrammer::finish() {
+    // Keep the finishing files even if the last interval is not over
+    std::unique_lock<std::mutex> lk(mtx);
+    if (stop)
+        return;
+    finishing = true;
+    cv.notify_all();
+    cv.wait(lk, [&] { return !finishing; });
+    if (nSkipped > 0) {
+        std::cout << "-> Live histograms of " << prefix << ": " << nSkipped
+            << " snapshots skipped because writing fell behind" << std::endl;
+    }
+}
+
+void LiveHistogrammer::write() {
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now() + interval;
+    std::unique_lock<std::mutex> lk(mtx);
+    while (!stop) {
+        cv.wait_until(lk, next, [&] { return stop || finishing; });
+        if (stop)
+            break;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!finishing && now < next)
+            continue;
+
+        // One slice per interval which passed, only the last one is written
+        unsigned due = 0;
+        while (next <= now) {
+            next += interval;
+            due++;
+        }
+        bool last = finishing;
+        lk.unlock();
+        for (unsigned n=1; n<due; n++)
+            this->snapshot(false);
+        nSkipped += (due > 1) ? due-1 : 0;
+        std::deque<Job> jobs = this->snapshot(true);
+        for (Job &job : jobs) {
+            job.h->toFile(job.prefix, dir);
+            if (doPlot)
+                job.h->plot(job.prefix, dir);
+        }
+        lk.lock();
+        if (last) {
+            // Nothing is added after the finishing snapshot
+            stop = true;
+            finishing = false;
+            cv.notify_all();
+        }
+    }
+}
@@ -9,6 +9,8 @@
 // # Comment: FEI4 Base class
 // ################################
 
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <string>
 
@@ -16,6 +18,7 @@
 #include "TxCore.h"
 #include "Fei4Cmd.h"
 #include "Fei4Cfg.h"
+#include "RegisterTransaction.h"
 
 
 enum MASK_STAGE {
@@ -48,7 +51,11 @@ class Fei4 : public Fei4Cfg, public Fei4Cmd, public FrontEnd {
 
         void configure() override final;
         void configureGlobal();
+        // Only double columns whose latch content changed since the last
+        // write are sent
         void configurePixels(unsigned lsb=0, unsigned msb=Fei4PixelCfg::n_Bits);
+        // Forget what was written, the next configurePixels() writes all
+        void resetPixelShadow();
 
         void setRunMode(bool mode=true) {
             runMode(chipId, mode);
@@ -57,14 +64,32 @@ class Fei4 : public Fei4Cfg, public Fei4Cmd, public FrontEnd {
         void makeGlobal() override final {
             chipId = 8;
         }
+        TxCore* setCmdCore(TxCore *arg_core) override final {
+            TxCore *prev = core;
+            this->setCore(arg_core);
+            return prev;
+        }
+        uint16_t* getRegShadow(unsigned &length) override final {
+            length = numRegs;
+            return cfg;
+        }
 
         void initMask(enum MASK_STAGE mask);
         void initMask(uint32_t mask);
+        // Full content of the shift register, one word per 32 pixels
+        void writeMask(uint32_t *bitstream);
         void shiftMask();
         void loadIntoShiftReg(unsigned pixel_latch);
         void loadIntoPixel(unsigned pixel_latch);
         void shiftByOne();
         void writeNamedRegister(std::string name, uint16_t value) override final;
+        // Reads need the chip in configuration mode
+        std::vector<unsigned> getReadbackRegisters() override;
+        bool needsReadback() override {return false;}
+        void requestRegisters(const std::vector<unsigned> &addrs) override;
+        void decodeRegisters(const std::vector<uint32_t> &words, unsigned &pos,
+                const std::vector<unsigned> &rxChannels,
+                std::map<unsigned, std::map<unsigned, uint16_t>> &values) override;
         void readPixelRegister(unsigned colpr_addr, unsigned latch);
         void dummyCmd();
 
@@ -82,6 +107,14 @@ class Fei4 : public Fei4Cfg, public Fei4Cmd, public FrontEnd {
             wrRegister(chipId, getAddr(ref), cfg[getAddr(ref)]);
         }
 
+        // Only sets the field, commit() writes all registers of the
+        // transaction in one block
+        void writeRegister(RegisterTransaction &trans, Fei4Register Fei4GlobalCfg::*ref, uint16_t cfgBits){
+            setValue(ref, cfgBits);
+            trans.add(getAddr(ref));
+        }
+        void commit(RegisterTransaction &trans);
+
         uint16_t readRegister(Fei4Register Fei4GlobalCfg::*ref){
             return getValue(ref);
         }
@@ -96,6 +129,14 @@ class Fei4 : public Fei4Cfg, public Fei4Cmd, public FrontEnd {
 
         void wrGR16(unsigned int mOffset, unsigned int bOffset, unsigned int mask, bool msbRight, uint16_t cfgBits);
     private:
+        // Latch content as last written by configurePixels, per latch and DC
+        std::array<std::array<std::array<uint32_t, Fei4PixelCfg::n_Words>, Fei4PixelCfg::n_DC>, Fei4PixelCfg::n_Bits> m_pixShadow;
+        std::array<bool, Fei4PixelCfg::n_Bits> m_pixShadowValid{};
+        // Latches loaded by a broadcast, e.g. by the mask loop, are not known
+        // anymore for any FE
+        static std::array<std::atomic<unsigned>, Fei4PixelCfg::n_Bits> broadcastLoads;
+        std::array<unsigned, Fei4PixelCfg::n_Bits> m_broadcastLoadsSeen{};
+        void copyIntoLatches(unsigned pixel_latch);
 
 };
 
@@ -12,9 +12,16 @@
 #include <iostream>
 #include <vector>
 #include <typeinfo>
+#include <typeindex>
 #include <cmath>
 #include <functional>
+#include <algorithm>
 #include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 #include "ScanBase.h"
 #include "ClipBoard.h"
@@ -24,9 +31,12 @@
 #include "GraphErrors.h"
 #include "Fei4Histogrammer.h"
 #include "lmcurve.h"
+#include "ScurveFit.h"
+#include "ThreadPool.h"
 
 #include "Bookkeeper.h"
 #include "FeedbackBase.h"
+#include "TdacModel.h"
 
 #include "AllFei4Actions.h"
 #include "AllFe65p2Actions.h"
@@ -62,7 +72,16 @@ class AnalysisAlgorithm {
         void disMasking() {make_mask = false;}
         void setMasking(bool val) {make_mask = val;}
 
+        // Algorithms are run concurrently on the histograms they consume
+        bool consumes(std::type_index t) {
+            return inputs.empty() || std::find(inputs.begin(), inputs.end(), t) != inputs.end();
+        }
+        // Algorithms which feed back into the scan are scheduled first
+        virtual bool hasFeedback() {return false;}
+
     protected:
+        // Histogram types handled by processHistogram, all if empty
+        std::vector<std::type_index> inputs;
         Bookkeeper *bookie;
         unsigned channel;
         ScanBase *scan;
@@ -111,6 +130,11 @@ class Fei4Analysis : public DataProcessor {
             
         static bool histogrammerDone;
 
+        // Executor shared by the analyses of all FEs and the algorithms
+        // themselves, sized to the number of cores. Pool tasks must never
+        // block on work that has not started yet.
+        static ThreadPool& algoPool();
+
     private:
         Bookkeeper *bookie;
         unsigned channel;
@@ -121,11 +145,21 @@ class Fei4Analysis : public DataProcessor {
         
         std::vector<AnalysisAlgorithm*> algorithms;
 
+        void runAlgorithms();
+        // Histograms waiting per algorithm, each algorithm works on one at a time
+        std::vector<std::deque<std::shared_ptr<HistogramBase>>> algoQueue;
+        std::vector<bool> algoBusy;
+        // Algorithm indices, feedback producing ones first
+        std::vector<unsigned> algoOrder;
+        std::mutex algoMutex;
+
 };
 
 class OccupancyAnalysis : public AnalysisAlgorithm {
     public:
-        OccupancyAnalysis() : AnalysisAlgorithm() {};
+        OccupancyAnalysis() : AnalysisAlgorithm() {
+            inputs = {typeid(OccupancyMap*)};
+        };
         ~OccupancyAnalysis() {};
 
         void init(ScanBase *s);
@@ -144,12 +178,15 @@ class OccupancyAnalysis : public AnalysisAlgorithm {
 
 class TotAnalysis : public AnalysisAlgorithm {
     public:
-        TotAnalysis() : AnalysisAlgorithm() {};
+        TotAnalysis() : AnalysisAlgorithm() {
+            inputs = {typeid(OccupancyMap*), typeid(TotMap*), typeid(Tot2Map*)};
+        };
         ~TotAnalysis() {};
 
         void init(ScanBase *s);
         void processHistogram(HistogramBase *h);
         void end();
+        bool hasFeedback() {return globalFb != nullptr || pixelFb != nullptr;}
 	void loadConfig(json &config){}
     private:
         std::vector<unsigned> loops;
@@ -176,14 +213,48 @@ class TotAnalysis : public AnalysisAlgorithm {
 
 class ScurveFitter : public AnalysisAlgorithm {
     public:
-        ScurveFitter() : AnalysisAlgorithm() {};
+        ScurveFitter() : AnalysisAlgorithm() {
+            inputs = {typeid(OccupancyMap*)};
+            // "fitter": "scurvefit" selects ScurveFit. Its chi2 is a binomial
+            // chi2/ndf, the chi2 cut has only been derived for lmmin.
+            useLmmin = true;
+            fixNorm = false;
+        };
         ~ScurveFitter() {};
 
         void init(ScanBase *s);
         void processHistogram(HistogramBase *h);
         void end();
-	void loadConfig(json &config){}
-    private:
+        bool hasFeedback() {return fb != nullptr;}
+	void loadConfig(json &config);
+    protected:
+        // Pixel whose s-curve is complete and waits to be fitted
+        struct FitJob {
+            unsigned bin;
+            uint32_t *data;
+            double par[3];
+            double chi2;
+            int outcome;
+            long fitTime;
+        };
+        // Estimates parameters of pending[first, last), called from the worker threads
+        virtual void fitPixels(unsigned first, unsigned last);
+        void fitSingle(FitJob &job);
+        // Vcal points of the iteration being fitted, see fitIdx
+        unsigned nFitPoints() const {return fitIdx.size();}
+        // y of the fit points of job
+        void fitData(const FitJob &job, double *y) const;
+        void accumulate(Histo2d *hh, unsigned outerIdent, unsigned vcal);
+        void completeIteration(unsigned outerIdent);
+        void fitPending(unsigned outerIdent);
+        void createResultMaps(unsigned outerIdent);
+        std::unique_ptr<Histo1d> makeScurveHisto(unsigned outerIdent, unsigned bin);
+        virtual std::unique_ptr<Histo1d> makeStatusDist(unsigned outerIdent);
+
+        std::vector<FitJob> pending;
+        bool useLmmin;
+        bool fixNorm;
+
         unsigned vcalLoop;
         unsigned vcalMin;
         unsigned vcalMax;
@@ -195,10 +266,20 @@ class ScurveFitter : public AnalysisAlgorithm {
 	    unsigned n_failedfit;
         
         std::vector<double> x;
+        // Vcal bins the iteration being fitted visited and their x. Both
+        // fitters leave out the last vcal step, as lmmin always did.
+        std::vector<unsigned> fitIdx;
+        std::vector<double> fitX;
         std::vector<unsigned> loops;
         std::vector<unsigned> loopMax;
-     
-        std::map<unsigned, std::unique_ptr<Histo1d>> histos;
+
+        // Hit counts per outer loop iteration, laid out as [pixel][vcal bin]
+        // (nCol*nRow*(vcalBins+1) counters, ~15 MB for RD53A). Each cube is
+        // freed as soon as its iteration is fitted.
+        std::map<unsigned, std::vector<uint32_t>> occCube;
+        std::map<unsigned, std::string> cubeSuffix;
+        // Vcal bins each iteration got data for, an adaptive loop skips some
+        std::map<unsigned, std::vector<bool>> visited;
         std::map<unsigned, std::unique_ptr<Histo2d>> sCurve;
         std::map<unsigned, std::unique_ptr<Histo2d>> thrMap;
         std::map<unsigned, std::unique_ptr<Histo1d>> thrDist;
@@ -217,21 +298,43 @@ class ScurveFitter : public AnalysisAlgorithm {
         unsigned prevOuter;
         double thrTarget;
         
-        std::map<unsigned, unsigned> innerCnt;
         std::map<unsigned, unsigned> medCnt;
         std::map<unsigned, unsigned> vcalCnt;
         bool useScap;
         bool useLcap;
+        bool adaptiveVcal;
+};
+
+// Fit-free estimate from the moments of the s-curve derivative, only
+// pixels which look pathological are optionally handed to the fit.
+// StatusMap is -1 for pixels taken from the moments.
+class ScurveMoments : public ScurveFitter {
+    public:
+        ScurveMoments() : ScurveFitter() {
+            fallbackFit = false;
+        };
+        ~ScurveMoments() {};
+
+	void loadConfig(json &config);
+    protected:
+        void fitPixels(unsigned first, unsigned last);
+        std::unique_ptr<Histo1d> makeStatusDist(unsigned outerIdent);
+    private:
+        bool estimate(FitJob &job);
+        bool fallbackFit;
 };
 
 class OccGlobalThresholdTune : public AnalysisAlgorithm {
     public:
-        OccGlobalThresholdTune() : AnalysisAlgorithm()  {};
+        OccGlobalThresholdTune() : AnalysisAlgorithm() {
+            inputs = {typeid(OccupancyMap*)};
+        };
         ~OccGlobalThresholdTune() {};
 
         void init(ScanBase *s);
         void processHistogram(HistogramBase *h);
         void end() {};
+        bool hasFeedback() {return true;}
 	void loadConfig(json &config){}
     private:
         std::vector<unsigned> loops;
@@ -271,12 +374,15 @@ class GlobalPreampTune : public AnalysisAlgorithm {
 
 class OccPixelThresholdTune : public AnalysisAlgorithm {
     public:
-        OccPixelThresholdTune() : AnalysisAlgorithm()  {};
+        OccPixelThresholdTune() : AnalysisAlgorithm() {
+            inputs = {typeid(OccupancyMap*)};
+        };
         ~OccPixelThresholdTune() {};
 
         void init(ScanBase *s);
         void processHistogram(HistogramBase *h);
         void end() {};
+        bool hasFeedback() {return true;}
 	void loadConfig(json &config){}
 
     private:
@@ -292,7 +398,9 @@ class OccPixelThresholdTune : public AnalysisAlgorithm {
 
 class L1Analysis : public AnalysisAlgorithm {
     public:
-        L1Analysis() : AnalysisAlgorithm() {};
+        L1Analysis() : AnalysisAlgorithm() {
+            inputs = {typeid(L1Dist*)};
+        };
         ~L1Analysis() {};
 
         void init(ScanBase *s);
@@ -311,7 +419,9 @@ class L1Analysis : public AnalysisAlgorithm {
 
 class TotDistPlotter : public AnalysisAlgorithm {
     public:
-        TotDistPlotter() : AnalysisAlgorithm() {};
+        TotDistPlotter() : AnalysisAlgorithm() {
+            inputs = {typeid(TotDist*)};
+        };
         ~TotDistPlotter() {};
 
         void init(ScanBase *s);
@@ -329,7 +439,9 @@ class TotDistPlotter : public AnalysisAlgorithm {
 
 class NoiseAnalysis : public AnalysisAlgorithm {
     public:
-        NoiseAnalysis() : AnalysisAlgorithm() {};
+        NoiseAnalysis() : AnalysisAlgorithm() {
+            inputs = {typeid(OccupancyMap*), typeid(HitsPerEvent*)};
+        };
         ~NoiseAnalysis() {};
 
         void init(ScanBase *s);
@@ -343,12 +455,15 @@ class NoiseAnalysis : public AnalysisAlgorithm {
 
 class NoiseTuning : public AnalysisAlgorithm {
     public:
-        NoiseTuning() : AnalysisAlgorithm() {};
+        NoiseTuning() : AnalysisAlgorithm() {
+            inputs = {typeid(OccupancyMap*)};
+        };
         ~NoiseTuning() {};
 
         void init(ScanBase *s);
         void processHistogram(HistogramBase *h);
         void end();
+        bool hasFeedback() {return true;}
 	void loadConfig(json &config){}
     private:
         std::vector<unsigned> loops;
@@ -362,7 +477,9 @@ class NoiseTuning : public AnalysisAlgorithm {
 
 class DelayAnalysis : public AnalysisAlgorithm {
     public:
-        DelayAnalysis() : AnalysisAlgorithm() {};
+        DelayAnalysis() : AnalysisAlgorithm() {
+            inputs = {typeid(L13d*)};
+        };
         ~DelayAnalysis() {};
 
         void init(ScanBase *s);
@@ -0,0 +1,51 @@
+#ifndef FEI4CLUSTERER_H
+#define FEI4CLUSTERER_H
+
+// #################################
+// # Project: Yarr
+// # Description: Connected component clustering of pixel hits
+// # Comment: Hits are entered into a reusable 2D grid, neighbours within
+// #          the gap are joined with union-find, linear in the number of hits
+// ################################
+
+#include <cstdint>
+#include <vector>
+
+#include "Fei4EventData.h"
+
+class Fei4Clusterer {
+    public:
+        Fei4Clusterer();
+
+        // Hits up to gap empty pixels apart end up in the same cluster
+        void setGap(unsigned arg_gap) {
+            gap = arg_gap;
+        }
+        unsigned getGap() {
+            return gap;
+        }
+
+        // Replaces the clusters of the event
+        void cluster(Fei4Event &event);
+
+    private:
+        unsigned gap;
+
+        // Grid of hit indices, a cell is only valid if its stamp matches the
+        // current generation, so the grid never has to be cleared
+        unsigned nCol;
+        unsigned nRow;
+        std::vector<uint32_t> label;
+        std::vector<uint32_t> stamp;
+        uint32_t generation;
+
+        std::vector<Fei4Hit*> hits;
+        std::vector<uint32_t> parent;
+        std::vector<int> clusterIdx;
+
+        void resize(unsigned col, unsigned row);
+        uint32_t find(uint32_t i);
+        void unite(uint32_t a, uint32_t b);
+};
+
+#endif
@@ -33,6 +33,9 @@ class Fei4Cmd {
         // Slow Commdans
         void wrRegister(int chipId, int address, int value);
         void rdRegister(int chipId, int address);
+        // Words of a register write, to send several in one block
+        static void genWrRegister(int chipId, int address, int value, uint32_t buf[2]);
+        static uint32_t genRdRegister(int chipId, int address);
         void wrFrontEnd(int chipId, uint32_t *bitstream);
         void runMode(int chipId, bool mode);
         void globalReset(int chipId);
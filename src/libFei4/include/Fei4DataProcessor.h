@@ -41,6 +41,8 @@ class Fei4DataProcessor : public DataProcessor {
         ClipBoard<RawDataContainer> *input;
         std::map<unsigned, ClipBoard<EventDataBase> > *outMap;
         std::vector<unsigned> activeChannels;
+        // Active channels of every controller
+        std::map<unsigned, std::vector<unsigned>> ctrlChannels;
         unsigned hitDiscCfg;
         std::array<std::array<unsigned, 16>, 3> totCode;
         std::map<unsigned, unsigned> tag;
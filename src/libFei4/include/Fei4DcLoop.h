@@ -8,6 +8,7 @@
 
 #include "LoopActionBase.h"
 #include "Fei4.h"
+#include "TxProgramCache.h"
 
 class Fei4DcLoop: public LoopActionBase {
     public:
@@ -22,6 +23,7 @@ class Fei4DcLoop: public LoopActionBase {
     private:
         uint32_t m_mode;
         unsigned m_col;
+        TxProgramCache m_programs;
 
         void init();
         void end();
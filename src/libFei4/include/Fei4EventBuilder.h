@@ -0,0 +1,98 @@
+#ifndef FEI4EVENTBUILDER_H
+#define FEI4EVENTBUILDER_H
+
+// #################################
+// # Project: Yarr
+// # Description: Merges the events of several FEs into module events
+// # Comment: Events are matched by tag, L1ID and BCID inside a bounded
+// #          reorder window, the per FE data is handed on unchanged
+// ################################
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "DataProcessor.h"
+#include "ClipBoard.h"
+#include "Fei4EventData.h"
+
+class Fei4EventBuilder : public DataProcessor {
+    public:
+        Fei4EventBuilder();
+        ~Fei4EventBuilder();
+
+        // Per FE data is read from inMap and pushed on to outMap, module
+        // events go to output
+        void connect(std::map<unsigned, ClipBoard<EventDataBase> > *arg_inMap,
+                std::map<unsigned, ClipBoard<EventDataBase> > *arg_outMap,
+                ClipBoard<EventDataBase> *arg_output) {
+            inMap = arg_inMap;
+            outMap = arg_outMap;
+            output = arg_output;
+        }
+
+        // Hits of the channel are shifted by the offsets into module coordinates
+        void addChannel(unsigned ch, unsigned colOffset, unsigned rowOffset);
+
+        // Number of module events waiting for missing FEs, the oldest one
+        // is published incomplete when the window is full
+        void setWindow(unsigned size) {
+            window = size;
+        }
+
+        void init();
+        void run();
+        void join();
+        void process();
+        void process_core();
+
+        unsigned getComplete() {return nComplete;}
+        unsigned getIncomplete() {return nIncomplete;}
+
+    private:
+        struct Channel {
+            unsigned rx;
+            unsigned colOffset;
+            unsigned rowOffset;
+            // Sequence number expected for the next event of this FE
+            uint64_t next;
+        };
+        struct Slot {
+            bool used;
+            uint64_t key;
+            uint64_t chMask;
+            // Loop status of the container which opened the slot
+            LoopStatus stat;
+            Fei4Event event;
+        };
+
+        std::map<unsigned, ClipBoard<EventDataBase> > *inMap;
+        std::map<unsigned, ClipBoard<EventDataBase> > *outMap;
+        ClipBoard<EventDataBase> *output;
+        std::unique_ptr<std::thread> thread_ptr;
+
+        std::vector<Channel> channels;
+        uint64_t allMask;
+
+        // Ring of slots indexed by sequence number, head is the oldest
+        // pending event
+        unsigned window;
+        std::vector<Slot> slots;
+        uint64_t head;
+        uint64_t tail;
+        std::unordered_map<uint64_t, uint64_t> pending;
+
+        std::unique_ptr<Fei4Data> curOut;
+        unsigned nComplete;
+        unsigned nIncomplete;
+
+        void add(unsigned idx, Fei4Event &event, const LoopStatus &stat);
+        void publish(uint64_t seq);
+        void advance();
+        void flush();
+};
+
+#endif
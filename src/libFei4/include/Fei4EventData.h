@@ -28,40 +28,54 @@ class Fei4Cluster {
     public:
         Fei4Cluster() {
             nHits = 0;
+            minCol = 0;
+            maxCol = 0;
+            minRow = 0;
+            maxRow = 0;
+            charge = 0;
         }
         ~Fei4Cluster() {}
 
         void addHit(Fei4Hit* hit) {
+            if (nHits == 0) {
+                minCol = maxCol = hit->col;
+                minRow = maxRow = hit->row;
+            } else {
+                if (hit->col < minCol) minCol = hit->col;
+                if (hit->col > maxCol) maxCol = hit->col;
+                if (hit->row < minRow) minRow = hit->row;
+                if (hit->row > maxRow) maxRow = hit->row;
+            }
+            charge += hit->tot;
             hits.push_back(hit);
             nHits++;
         }
 
         unsigned getColLength() {
-            int min = 999999;
-            int max = -1;
-            for (unsigned i=0; i<hits.size(); i++) {
-                if ((int)hits[i]->col > max)
-                    max = hits[i]->col;
-                if ((int)hits[i]->col < min)
-                    min = hits[i]->col;
-            }
-            return max-min+1;
+            if (nHits == 0)
+                return 0;
+            return maxCol-minCol+1;
         }
         
         unsigned getRowWidth() {
-            int min = 999999;
-            int max = -1;
-            for (unsigned i=0; i<hits.size(); i++) {
-                if ((int)hits[i]->row > max)
-                    max = hits[i]->row;
-                if ((int)hits[i]->row < min)
-                    min = hits[i]->row;
-            }
-            return max-min+1;
+            if (nHits == 0)
+                return 0;
+            return maxRow-minRow+1;
+        }
+
+        // Sum of the ToT of all hits
+        unsigned getCharge() {
+            return charge;
         }
 
         unsigned nHits;
         std::vector<Fei4Hit*> hits;
+    private:
+        uint16_t minCol;
+        uint16_t maxCol;
+        uint16_t minRow;
+        uint16_t maxRow;
+        unsigned charge;
 };
 
 class Fei4Event {
@@ -72,6 +86,7 @@ class Fei4Event {
             bcid = 0;
             nHits = 0;
             nClusters = 0;
+            clusterGap = 0;
         }
         Fei4Event(unsigned arg_tag, unsigned arg_l1id, unsigned arg_bcid) {
             tag = arg_tag;
@@ -79,6 +94,7 @@ class Fei4Event {
             bcid = arg_bcid;
             nHits = 0;
             nClusters = 0;
+            clusterGap = 0;
         }
         ~Fei4Event() {
             //while(!hits.empty()) {
@@ -103,7 +119,8 @@ class Fei4Event {
             nHits+=event.nHits;
         }
 
-        void doClustering();
+        // Hits up to gap empty pixels apart are joined into one cluster
+        void doClustering(unsigned gap=1);
 
         void toFileBinary(std::fstream &handle);
         void fromFileBinary(std::fstream &handle);
@@ -113,6 +130,7 @@ class Fei4Event {
         uint32_t tag;
         uint16_t nHits;
         uint16_t nClusters;
+        uint8_t clusterGap;
         std::list<Fei4Hit> hits;
         std::vector<Fei4Cluster> clusters;
 };
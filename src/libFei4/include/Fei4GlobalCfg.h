@@ -89,6 +89,9 @@ class Fei4GlobalCfg {
                 (this->*ref).write(cfgBits);
             }
 
+        // Looked up in a table hashed at compile time, nullptr if unknown
+        static Fei4Register Fei4GlobalCfg::*findReg(const std::string &regName);
+
         uint16_t getValue(Fei4Register Fei4GlobalCfg::*ref) {
                 return (this->*ref).value();
             }
@@ -98,8 +101,9 @@ class Fei4GlobalCfg {
             }
 
         uint16_t getValue(std::string regName) {
-            if (regMap.find(regName) != regMap.end()) {
-                return (this->*regMap[regName]).value();
+            Fei4Register Fei4GlobalCfg::*ref = this->findReg(regName);
+            if (ref != nullptr) {
+                return (this->*ref).value();
             } else {
                 std::cerr << " --> Error: Could not find register \""<< regName << "\"" << std::endl;
             }
@@ -107,8 +111,9 @@ class Fei4GlobalCfg {
         }
 
         void setValue(std::string regName, uint16_t value) {
-            if (regMap.find(regName) != regMap.end()) {
-                (this->*regMap[regName]).write(value);
+            Fei4Register Fei4GlobalCfg::*ref = this->findReg(regName);
+            if (ref != nullptr) {
+                (this->*ref).write(value);
             } else {
                 std::cerr << " --> Error: Could not find register \""<< regName << "\"" << std::endl;
             }
@@ -11,6 +11,7 @@
 #include "Fei4.h"
 #include "LoopActionBase.h"
 #include "FeedbackBase.h"
+#include "TxBroadcaster.h"
 
 class Fei4GlobalFeedback : public LoopActionBase, public GlobalFeedbackBase {
     public:
@@ -43,8 +44,8 @@ class Fei4GlobalFeedback : public LoopActionBase, public GlobalFeedbackBase {
             if (val < 50) {
 				doneMap[channel] = true;
 			}
-            // Unlock the mutex to let the scan proceed
-			keeper->mutexMap[channel].unlock();
+            // Let the scan proceed with this channel
+            fbChannel.post(channel);
         }
 
         // Binary search feedback algorithm
@@ -60,8 +61,8 @@ class Fei4GlobalFeedback : public LoopActionBase, public GlobalFeedbackBase {
 				 doneMap[channel] = true;
 			}
             
-            // Unlock the mutex to let the scan proceed
-			keeper->mutexMap[channel].unlock();
+            // Let the scan proceed with this channel
+            fbChannel.post(channel);
         }
 	void writeConfig(json &config);
 	void loadConfig(json &config);
@@ -70,6 +71,10 @@ class Fei4GlobalFeedback : public LoopActionBase, public GlobalFeedbackBase {
         void init() {
             m_done = false;
             cur = 0;
+            // Resolved once, writePar() runs for every step
+	   if(parName!=""){
+	    parPtr = Fei4GlobalCfg::findReg(parName);
+	   }
 			// Init all maps:
             for(unsigned int k=0; k<keeper->feList.size(); k++) {
 				if(keeper->feList[k]->getActive()) {
@@ -94,43 +99,48 @@ class Fei4GlobalFeedback : public LoopActionBase, public GlobalFeedbackBase {
 
         void execPart1() {
             g_stat->set(this, cur);
-            // Lock all mutexes if open
+            // Expect feedback from all active FEs
 			for(unsigned int k=0; k<keeper->feList.size(); k++) {
 				if(keeper->feList[k]->getActive()) {	
-					keeper->mutexMap[dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel()].try_lock();
+					fbChannel.expect(dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel());
 			    }
 			}
 			m_done = allDone();
 		}
 
         void execPart2() {
-            // Wait for mutexes to be unlocked by feedback
-			for(unsigned int k=0; k<keeper->feList.size(); k++) {
-				if(keeper->feList[k]->getActive()) {
-					keeper->mutexMap[dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel()].lock();
-                    if (verbose)
-                        std::cout << " --> Received Feedback on Channel " 
-                            << dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel() << " with value: " 
-                            << values[dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel()] << std::endl;
-			    }
-			}
+            // Write each FE as soon as its feedback arrived
+            unsigned ch;
+            while (fbChannel.next(ch)) {
+                if (verbose)
+                    std::cout << " --> Received Feedback on Channel " 
+                        << ch << " with value: " << values[ch] << std::endl;
+                this->writePar(keeper->getFe(ch));
+                g_tx->setCmdEnable(keeper->getTxMask());
+            }
             cur++;
-            this->writePar();
         }
 
         void writePar() {
-	   if(parName!=""){
-	    parPtr = keeper->globalFe<Fei4>()->regMap[parName];
-	   }
+            // FEs which get the same value are written together
+            std::vector<FrontEnd*> active;
 			for(unsigned int k=0; k<keeper->feList.size(); k++) {
 				if(keeper->feList[k]->getActive()) {
-					g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getTxChannel());
-				    dynamic_cast<Fei4*>(keeper->feList[k])->writeRegister(parPtr, values[dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel()]);
-                    while(!g_tx->isCmdEmpty());
+                    active.push_back(keeper->feList[k]);
 				}
 			}
+            TxBroadcaster broadcaster(g_tx);
+            broadcaster.write(active, [&](FrontEnd *fe) {
+                dynamic_cast<Fei4*>(fe)->writeRegister(parPtr, values[dynamic_cast<FrontEndCfg*>(fe)->getRxChannel()]);
+            });
 			g_tx->setCmdEnable(keeper->getTxMask());
         }
+
+        void writePar(FrontEnd *fe) {
+            g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
+            dynamic_cast<Fei4*>(fe)->writeRegister(parPtr, values[dynamic_cast<FrontEndCfg*>(fe)->getRxChannel()]);
+            g_tx->fence();
+        }
         
         bool allDone() {
             for(unsigned int k=0; k<keeper->feList.size(); k++) {
@@ -11,6 +11,7 @@
 
 #include <fstream>
 #include <vector>
+#include <algorithm>
 #include <typeinfo>
 #include <thread>
 
@@ -22,6 +23,8 @@
 #include "Histo2d.h"
 #include "Histo3d.h"
 #include "LoopStatus.h"
+#include "OccupancySummary.h"
+#include "LiveHistogrammer.h"
 
 class HistogramAlgorithm {
     public:
@@ -59,6 +62,23 @@ class Fei4Histogrammer : public DataProcessor {
             output = arg_output;
         }
 
+        // Publish a summary of every occupancy map for adaptive loops,
+        // injections sets the 50% occupancy level
+        void connectSummary(ClipBoard<OccupancySummary> *arg_summary, unsigned injections) {
+            summary = arg_summary;
+            halfOcc = std::max(1u, (injections+1)/2);
+        }
+
+        // Save every published histogram for a later re-analysis
+        void archive(std::string filename);
+        static void toArchive(std::iostream &handle, HistogramBase &h);
+        static std::unique_ptr<HistogramBase> fromArchive(std::iostream &handle);
+
+        // Write intermediate maps while the scan is running
+        void live(std::unique_ptr<LiveHistogrammer> arg_live) {
+            liveHistos = std::move(arg_live);
+        }
+
         void addHistogrammer(HistogramAlgorithm *a) {
             algorithms.push_back(a);
         }
@@ -77,6 +97,7 @@ class Fei4Histogrammer : public DataProcessor {
         void process();
         void process_core();
         void publish();
+        void summarise(Histo2d *h);
 
         ClipBoard<EventDataBase>& getInput() { return *input; }
 
@@ -85,6 +106,10 @@ class Fei4Histogrammer : public DataProcessor {
     private:
         ClipBoard<EventDataBase> *input;
         ClipBoard<HistogramBase> *output;
+        ClipBoard<OccupancySummary> *summary;
+        unsigned halfOcc;
+        std::fstream archiveHandle;
+        std::unique_ptr<LiveHistogrammer> liveHistos;
         std::unique_ptr<std::thread> thread_ptr;
 
         std::vector<HistogramAlgorithm*> algorithms;
@@ -288,4 +313,61 @@ class HitsPerEvent : public HistogramAlgorithm {
     private:
         Histo1d *h;
 };
+// Clusters the hits of every event, the clusters are shared with the other
+// cluster algorithms as long as they use the same gap
+class ClusterSizeMap : public HistogramAlgorithm {
+    public:
+        ClusterSizeMap() : HistogramAlgorithm() {
+            h = nullptr;
+            r = nullptr;
+            gap = 1;
+        }
+        ~ClusterSizeMap() {
+        }
+
+        void setGap(unsigned arg_gap) {
+            gap = arg_gap;
+        }
+
+        void create(LoopStatus &stat) {
+            h = new Histo2d("ClusterSizeMap", nCol, 0.5, nCol+0.5, nRow, 0.5, nRow+0.5, typeid(this), stat);
+            h->setXaxisTitle("Column");
+            h->setYaxisTitle("Row");
+            h->setZaxisTitle("Sum of Cluster Sizes");
+            r.reset(h);
+        }
+
+        void processEvent(Fei4Data *data);
+    private:
+        Histo2d *h;
+        unsigned gap;
+};
+
+class ClusterShapeMap : public HistogramAlgorithm {
+    public:
+        ClusterShapeMap() : HistogramAlgorithm() {
+            h = nullptr;
+            r = nullptr;
+            gap = 1;
+        }
+        ~ClusterShapeMap() {
+        }
+
+        void setGap(unsigned arg_gap) {
+            gap = arg_gap;
+        }
+
+        void create(LoopStatus &stat) {
+            h = new Histo2d("ClusterShapeMap", 11, -0.5, 10.5, 11, -0.5, 10.5, typeid(this), stat);
+            h->setXaxisTitle("Cluster Col Length");
+            h->setYaxisTitle("Cluster Row Width");
+            h->setZaxisTitle("Clusters");
+            r.reset(h);
+        }
+
+        void processEvent(Fei4Data *data);
+    private:
+        Histo2d *h;
+        unsigned gap;
+};
 #endif
@@ -6,7 +6,9 @@
 #ifndef FEI4MASKLOOP_H
 #define FEI4MASKLOOP_H
 
+#include <array>
 #include <iostream>
+#include <vector>
 
 #include "Fei4.h"
 #include "LoopActionBase.h"
@@ -33,6 +35,8 @@ class Fei4MaskLoop : public LoopActionBase {
         unsigned m_cur;
         bool enable_sCap;
         bool enable_lCap;
+        // Shift register content of every stage, precomputed in init()
+        std::vector<std::array<uint32_t, 21>> m_stages;
 
         void init();
         void end();
@@ -40,7 +40,7 @@ class Fei4ParameterLoop : public LoopActionBase{
             m_done = false;
             cur = min;
 	    if(parName!=""){
-	      parPtr = keeper->globalFe<Fei4>()->regMap[parName];
+	      parPtr = Fei4GlobalCfg::findReg(parName);
 	    }
             this->writePar();
         }
@@ -60,7 +60,7 @@ class Fei4ParameterLoop : public LoopActionBase{
 
         void writePar() {
             keeper->globalFe<Fei4>()->writeRegister(parPtr, cur);
-            while(!g_tx->isCmdEmpty());
+            g_tx->fence();
         }
 
         unsigned cur;
@@ -12,6 +12,7 @@
 #include "Histo2d.h"
 #include "ClipBoard.h"
 #include "FeedbackBase.h"
+#include "TdacModel.h"
 
 enum FeedbackType {
     TDAC_FB, // 0 - 31
@@ -46,17 +47,23 @@ class Fei4PixelFeedback : public LoopActionBase, public PixelFeedbackBase {
                 std::cout << __PRETTY_FUNCTION__ 
                     << " --> ERROR : Wrong type of feedback histogram on channel " << channel << std::endl;
                 doneMap[channel] = true;
+                delete h;
             } else {
                 fbHistoMap[channel] = h;
             }
 
-            keeper->mutexMap[channel].unlock();
+            fbChannel.post(channel);
+        }
+        // Only the threshold tuning measures a deviation
+        bool wantsDeviation() {
+            return useModel && fbType == TDAC_FB;
         }
         void writeConfig(json &config){
 	    config["min"]=min;
 	    config["max"]=max;
             config["step"]=step;
             config["parameter"] = parName;
+            config["model"] = useModel;
         }
         void loadConfig(json &config){
 	    if (!config["min"].empty())
@@ -67,6 +74,8 @@ class Fei4PixelFeedback : public LoopActionBase, public PixelFeedbackBase {
 	      step = config["step"];
 	    if (!config["parameter"].empty())
 	      parName = config["parameter"];
+	    if (!config["model"].empty())
+	      useModel = config["model"];
 	    if(parName=="TDAC_FB"){
 	      fbType=TDAC_FB;
 	    }
@@ -76,9 +85,12 @@ class Fei4PixelFeedback : public LoopActionBase, public PixelFeedbackBase {
         }
     private:
 	std::string parName="";
+        // Model based TDAC steps, see TdacModel (simulation only so far)
+        bool useModel = false;
         void init() {
             m_done = false;
             cur = 0;
+            models.clear();
 
             // Loop over active FEs
             for(unsigned int k=0; k<keeper->feList.size(); k++) {
@@ -87,6 +99,8 @@ class Fei4PixelFeedback : public LoopActionBase, public PixelFeedbackBase {
                     
                     // Init Maps
                     fbHistoMap[ch] = NULL;
+                    if (this->wantsDeviation())
+                        models[ch].init(Fei4PixelCfg::n_Col*Fei4PixelCfg::n_Row);
                     
                     // Initilize Pixel regs with default config
                     for (unsigned col=1; col<81; col++) {
@@ -108,26 +122,24 @@ class Fei4PixelFeedback : public LoopActionBase, public PixelFeedbackBase {
          
             for(unsigned int k=0; k<keeper->feList.size(); k++) {
                 if(keeper->feList[k]->getActive()) {
-                    // Need to lock mutex on first itereation
-                    keeper->mutexMap[dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel()].try_lock();
-                    // Write config
-                    this->writePixelCfg(dynamic_cast<Fei4*>(keeper->feList[k]));
+                    fbChannel.expect(dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel());
+                    // Later iterations are written when the feedback arrives
+                    if (cur == 0)
+                        this->writePixelCfg(dynamic_cast<Fei4*>(keeper->feList[k]));
                 }
             }
         }
 
         void execPart2() {
+            // Update and write each FE as soon as its feedback arrived
             unsigned ch;
-            for(unsigned int k=0; k<keeper->feList.size(); k++) {
-                if(keeper->feList[k]->getActive()) {
-                    ch = dynamic_cast<FrontEndCfg*>(keeper->feList[k])->getRxChannel();
-                    // Wait for Mutex to be unlocked by feedback
-                    keeper->mutexMap[ch].lock();
-                    this->addFeedback(ch);
-                }
+            while (fbChannel.next(ch)) {
+                this->addFeedback(ch);
+                this->writePixelCfg(dynamic_cast<Fei4*>(keeper->getFe(ch)));
             }
-            // Execute last step twice to get full range
-            if (step == 1 && oldStep == 1)
+            // Execute last step twice to get full range, the model already
+            // covers it and only needs the final refinement
+            if (step == 1 && (oldStep == 1 || this->wantsDeviation()))
                 m_done = true;
             oldStep = step;
             step = step/2;
@@ -173,17 +185,28 @@ class Fei4PixelFeedback : public LoopActionBase, public PixelFeedbackBase {
 
         void addFeedback(unsigned ch) {
             if (fbHistoMap[ch] != NULL) {
+                // The last step with size 1 refines by the sign only
+                bool model = this->wantsDeviation() && step > 1;
                 for (unsigned row=1; row<337; row++) {
                     for (unsigned col=1; col<81; col++) {
-                        int sign = fbHistoMap[ch]->getBin(fbHistoMap[ch]->binNum(col, row));
+                        unsigned bin = fbHistoMap[ch]->binNum(col, row);
+                        double dev = fbHistoMap[ch]->getBin(bin);
+                        int sign = this->wantsDeviation() ? TdacModel::sign(dev) : (int)dev;
                         int v = getPixel(dynamic_cast<Fei4*>(keeper->getFe(ch)),col, row);
-                        v = v + (step)*sign;
+                        if (model) {
+                            v = models[ch].next(bin, v, dev, 1, step, 0, max);
+                        } else {
+                            v = v + (step)*sign;
+                        }
                         if (v < 0) v = 0;
                         if (v > max) v = max;
                         this->setPixel(dynamic_cast<Fei4*>(keeper->getFe(ch)),col, row, v);
                     }
                 }
+                if (model)
+                    models[ch].update();
                 delete fbHistoMap[ch];
+                fbHistoMap[ch] = NULL;
             }
         }
 
@@ -205,11 +228,12 @@ class Fei4PixelFeedback : public LoopActionBase, public PixelFeedbackBase {
             g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
             fe->configurePixels(lsb, msb+1);
             g_tx->setCmdEnable(keeper->getTxMask());
-            while(!g_tx->isCmdEmpty());
+            g_tx->fence();
         }
 
         enum FeedbackType fbType;
         std::map<unsigned, Histo2d*> fbHistoMap;
+        std::map<unsigned, TdacModel> models;
         unsigned step, oldStep;
         unsigned cur;
 };
@@ -0,0 +1,80 @@
+#ifndef LIVEHISTOGRAMMER_H
+#define LIVEHISTOGRAMMER_H
+
+// #################################
+// # Project: Yarr
+// # Description: Intermediate maps of long running scans
+// # Comment: Sums the published maps and writes them at a fixed interval,
+// #          once since the start and once over a rolling window
+// ################################
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Histo2d.h"
+
+class LiveHistogrammer {
+    public:
+        // Every interval seconds prefix_snapshot_<name> is written with the
+        // sum since the start and prefix_live_<name> with the sum over the
+        // last window intervals. With keep the snapshots are numbered
+        // instead of overwritten.
+        LiveHistogrammer(std::string prefix, std::string dir, unsigned interval, unsigned window);
+        ~LiveHistogrammer();
+
+        void setKeep(bool v) {keep = v;}
+        void setPlot(bool v) {doPlot = v;}
+
+        // Only 2D maps are followed, everything else is ignored
+        void add(HistogramBase &h);
+        // Writes the final state and waits until everything is on disk
+        void finish();
+
+    private:
+        struct Entry {
+            std::unique_ptr<Histo2d> total;
+            // Sum of every interval, the last one is still being filled
+            std::deque<std::unique_ptr<Histo2d>> slices;
+        };
+        struct Job {
+            std::string prefix;
+            std::unique_ptr<Histo2d> h;
+        };
+
+        std::string prefix;
+        std::string dir;
+        std::chrono::seconds interval;
+        unsigned window;
+        bool keep;
+        bool doPlot;
+
+        // Filled by add() on the histogrammer thread, rotated and copied by
+        // the writer thread
+        std::map<std::string, Entry> entries;
+        std::mutex dataMtx;
+        unsigned nSnapshots;
+        unsigned nSkipped;
+
+        // Snapshots are taken and written by their own thread on a fixed
+        // interval, so the histogrammer never waits for the disk and idle
+        // periods are written as well. If writing falls behind, the slices
+        // still move on every interval and only the write is skipped.
+        std::thread writer;
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool stop;
+        bool finishing;
+
+        static std::unique_ptr<Histo2d> emptyCopy(Histo2d &h);
+        // Starts the next interval, with doWrite also returns the maps
+        std::deque<Job> snapshot(bool doWrite);
+        void write();
+};
+
+#endif
@@ -88,6 +88,15 @@ void KU040TxCore::writeFifo(uint32_t value)
 	cmdFifo.push(value);
 }
 
+void KU040TxCore::writeFifoBlock(const uint32_t *words, size_t length)
+{
+	// queued like single words, releaseFifo sends everything in one IPbus write
+	for(size_t i = 0; i < length; i++)
+	{
+		cmdFifo.push(words[i]);
+	}
+}
+
 void KU040TxCore::releaseFifo()
 {
 	size_t len = cmdFifo.size();
@@ -18,6 +18,7 @@ class KU040TxCore : virtual public TxCore {
 
         // Write to FE interface
         void writeFifo(uint32_t);
+        void writeFifoBlock(const uint32_t *words, size_t length);
         void setCmdEnable(uint32_t);
         void setCmdEnable(std::vector<uint32_t> channels);
         uint32_t getCmdEnable();
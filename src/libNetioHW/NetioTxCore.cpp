@@ -109,6 +109,20 @@ void NetioTxCore::writeFifo(uint32_t value){
     }
 }
 
+void NetioTxCore::writeFifoBlock(const uint32_t *words, size_t length){
+  if(m_debug) std::cout << "NetioTxCore::writeFifoBlock words=" << length << endl;
+  map<uint32_t,bool>::iterator it;
+
+  for(it=m_elinks.begin();it!=m_elinks.end();it++)
+    if(it->second) {
+      vector<uint8_t> *fifo=&m_fifo[it->first];
+      fifo->reserve(fifo->size()+length*(m_extend==4?16:4));
+      for(size_t i=0;i<length;i++){
+        writeFifo(fifo,words[i]);
+      }
+    }
+}
+
 void NetioTxCore::writeFifo(uint32_t elink, uint32_t value){
   if(m_debug) std::cout << "NetioTxCore::writeFifo elink=" << elink
                    << " val=0x" << hex << setw(8) << setfill('0') << value << dec << endl;
@@ -33,6 +33,7 @@ public:
   NetioTxCore(); 		// Create NetIO context and low_latency_send_socket
   ~NetioTxCore(); 		// Delete socket and context.
   void writeFifo(uint32_t value) override; 	// append to fifo of all channels
+  void writeFifoBlock(const uint32_t *words, size_t length) override; 	// append several words to fifo of all channels
   void releaseFifo() override; 		// release the fifo for all enabled channels
 
   void setCmdEnable(uint32_t) override;
@@ -19,6 +19,10 @@ void RceCom::write32(uint32_t value) {
   txfifo.push_back(value);
 }
 
+void RceCom::writeBlock32(const uint32_t *buf, uint32_t length) {
+  txfifo.insert(txfifo.end(), buf, buf+length);
+}
+
 uint32_t RceCom::read32(){
   return 0;
 }
@@ -14,6 +14,7 @@ class RceCom : public Rce::Receiver {
         virtual uint32_t read32();
         virtual uint32_t readBlock32(uint32_t *buf, uint32_t length);
         virtual void write32(uint32_t);
+        virtual void writeBlock32(const uint32_t *buf, uint32_t length);
 	virtual void releaseFifo();
 	Rce::PGPmaster* pgp; //FIXME
 	
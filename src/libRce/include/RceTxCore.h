@@ -20,6 +20,7 @@ class RceTxCore : virtual public TxCore {
         RceCom* getCom() {return m_com;}
 
         void writeFifo(uint32_t value);
+        void writeFifoBlock(const uint32_t *words, size_t length) {m_com->writeBlock32(words, length);}
         void releaseFifo() {this->writeFifo(0x0);m_com->releaseFifo();} // Add some padding
         
         void setCmdEnable(uint32_t value) { }
@@ -7,9 +7,12 @@
 // # Date: Jun 2017
 // ################################
 
+#include <algorithm>
+
 #include "AllChips.h"
 #include "Rd53a.h"
 #include "RawData.h"
+#include "RegisterReadback.h"
 
 bool rd53a_registred =
     StdDict::registerFrontEnd("RD53A", [](){return std::unique_ptr<FrontEnd>(new Rd53a());});
@@ -67,6 +70,11 @@ void Rd53a::writeRegister(Rd53aReg Rd53aGlobalCfg::*ref, uint32_t value) {
         wrRegister(m_chipId, (this->*ref).addr(), m_cfg[(this->*ref).addr()]);
 }
 
+void Rd53a::writeRegister(RegisterTransaction &trans, Rd53aReg Rd53aGlobalCfg::*ref, uint32_t value) {
+        (this->*ref).write(value);
+        trans.add((this->*ref).addr());
+}
+
 void Rd53a::readRegister(Rd53aReg Rd53aGlobalCfg::*ref) {
         rdRegister(m_chipId, (this->*ref).addr());
 }
@@ -86,38 +94,52 @@ void Rd53a::configure() {
     EnCoreColDiff2.write(0);
     // Write globals
     this->configureGlobal();
-    while(!core->isCmdEmpty()){;}
-    // Write pixels
+    core->fence();
+    // Write pixels, whatever the chip had before
+    this->resetPixelShadow();
     this->configurePixels();
-    while(!core->isCmdEmpty()){;}
+    core->fence();
     // Turn on clock to matrix
     this->writeRegister(&Rd53a::EnCoreColSync, tmp_enCoreColSync);
     this->writeRegister(&Rd53a::EnCoreColLin1, tmp_enCoreColLin1);
     this->writeRegister(&Rd53a::EnCoreColLin2, tmp_enCoreColLin2);
     this->writeRegister(&Rd53a::EnCoreColDiff1, tmp_enCoreColDiff1);
     this->writeRegister(&Rd53a::EnCoreColDiff2, tmp_enCoreColDiff2);
-    while(!core->isCmdEmpty()){;}
+    core->fence();
 }
 
 void Rd53a::configureInit() {
     this->writeRegister(&Rd53a::GlobalPulseRt, 0x007F); // Reset a whole bunch of things
     this->globalPulse(m_chipId, 8);
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    core->pause(1000);
     this->writeRegister(&Rd53a::GlobalPulseRt, 0x4100); //activate monitor and prime sync FE AZ
     this->globalPulse(m_chipId, 8);
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    core->pause(1000);
     this->ecr();
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    core->pause(1000);
     this->bcr();
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    while(!core->isCmdEmpty()){;}
+    core->pause(1000);
+    core->fence();
 }
 
 void Rd53a::configureGlobal() {
-    for (unsigned addr=0; addr<numRegs; addr++) {
-        this->wrRegister(m_chipId, addr, m_cfg[addr]);
-        if (addr % 20 == 0)
-            while(!core->isCmdEmpty()){;}
+    RegisterTransaction trans;
+    for (unsigned addr=0; addr<numRegs; addr++)
+        trans.add(addr);
+    this->commit(trans);
+}
+
+namespace {
+    // Command words of a pixel portal write and of a six row block write
+    constexpr unsigned singleWords = 3;
+    constexpr unsigned blockWords = 7;
+    // Words sent before waiting for the fifo to drain
+    constexpr unsigned maxBlockWords = 600;
+
+    // Words to write a run of rows in auto row mode, without setting the row
+    unsigned runWords(unsigned length) {
+        unsigned rest = length%6;
+        return (length/6)*blockWords + std::min(rest*singleWords, blockWords);
     }
 }
 
@@ -126,50 +148,131 @@ void Rd53a::configurePixels() {
     this->writeRegister(&Rd53a::PixAutoCol, 0);
     this->writeRegister(&Rd53a::PixAutoRow, 1);
 
-    // Writing two columns and six rows at the same time
-    for (unsigned col=0; col<n_Col; col+=2) {
-        this->writeRegister(&Rd53a::PixRegionCol, col/2);
-        this->writeRegister(&Rd53a::PixRegionRow, 0); 
-        for (unsigned row=0; row<n_Row; row+=1) {
-            //this->writeRegister(&Rd53a::PixRegionRow, row); 
-            //this->wrRegisterBlock(m_chipId, 0, &pixRegs[Rd53aPixelCfg::toIndex(col, row)]);
-            this->writeRegister(&Rd53a::PixPortal, pixRegs[Rd53aPixelCfg::toIndex(col, row)]);
-            //if (pixRegs[Rd53aPixelCfg::toIndex(col, row)] != 0x0)
-            //    std::cout << "[" << col << "][" << row << "] = 0x" << std::hex << pixRegs[Rd53aPixelCfg::toIndex(col, row)] << std::dec << std::endl;
-            //if (row % 24 == 0)
-            //    while(!core->isCmdEmpty()){;}
+    // Only the double pixels which changed since the last write
+    std::vector<unsigned> rows;
+    for (unsigned dc=0; dc<n_DC; dc++) {
+        rows.clear();
+        for (unsigned row=0; row<n_Row; row++) {
+            unsigned index = dc*n_Row+row;
+            if (!m_pixShadowValid || pixRegs[index] != m_pixShadow[index])
+                rows.push_back(row);
         }
-        while(!core->isCmdEmpty()){;}
+        this->writePixelRows(dc, rows, nullptr);
     }
+    m_pixShadowValid = true;
 }
 
 void Rd53a::configurePixels(std::vector<std::pair<unsigned, unsigned>> &pixels) {
     // Setup pixel programming
     this->writeRegister(&Rd53a::PixAutoCol, 0);
-    this->writeRegister(&Rd53a::PixAutoRow, 0);
-    int counter = 0;
-    int old_col = -1;
-    //std::cout << "Seeing " << pixels.size() << " modified pixels!" << std::endl;
+    this->writeRegister(&Rd53a::PixAutoRow, 1);
+
+    std::vector<uint8_t> selected(n_DC*n_Row, 0);
+    std::vector<std::vector<unsigned>> rows(n_DC);
     for (auto &pixel : pixels) {
-        if (old_col != (int)pixel.first/2) {
-            this->writeRegister(&Rd53a::PixRegionCol, pixel.first/2);
-            old_col = pixel.first/2;
+        unsigned index = Rd53aPixelCfg::toIndex(pixel.first, pixel.second);
+        if (selected[index])
+            continue;
+        selected[index] = 1;
+        if (!m_pixShadowValid || pixRegs[index] != m_pixShadow[index])
+            rows[pixel.first/2].push_back(pixel.second);
+    }
+    for (unsigned dc=0; dc<n_DC; dc++) {
+        std::sort(rows[dc].begin(), rows[dc].end());
+        this->writePixelRows(dc, rows[dc], &selected);
+    }
+}
+
+// Writes the given rows of one double column. Close rows are merged into one
+// run in auto row mode, also writing the unchanged rows in between, and runs
+// go out as six row blocks where possible. If that is more than writing the
+// whole column, the whole column is written.
+void Rd53a::writePixelRows(unsigned dc, std::vector<unsigned> &rows, const std::vector<uint8_t> *selected) {
+    if (rows.empty())
+        return;
+
+    // Unselected rows may only be rewritten with what the chip already has
+    bool canFill = m_pixShadowValid;
+    std::vector<std::pair<unsigned, unsigned>> runs;
+    unsigned words = 0;
+    for (unsigned row : rows) {
+        if (!runs.empty()) {
+            std::pair<unsigned, unsigned> &run = runs.back();
+            unsigned cur = runWords(run.second-run.first);
+            if ((canFill || row == run.second) && runWords(row+1-run.first)-cur <= singleWords+runWords(1)) {
+                words += runWords(row+1-run.first)-cur;
+                run.second = row+1;
+                continue;
+            }
         }
-        this->writeRegister(&Rd53a::PixRegionRow, pixel.second); 
-        this->writeRegister(&Rd53a::PixPortal, pixRegs[Rd53aPixelCfg::toIndex(pixel.first, pixel.second)]);
-        counter++;
-        if (counter == 100 ) {
-            while(!core->isCmdEmpty()){;}
-            counter = 0;
+        runs.push_back(std::make_pair(row, row+1));
+        words += singleWords + runWords(1);
+    }
+    if (canFill && words > singleWords+runWords(n_Row)) {
+        runs.clear();
+        runs.push_back(std::make_pair(0, n_Row));
+    }
+
+    auto value = [&](unsigned row) {
+        unsigned index = dc*n_Row+row;
+        if (selected == nullptr || (*selected)[index])
+            m_pixShadow[index] = pixRegs[index];
+        return m_pixShadow[index];
+    };
+
+    this->writeRegister(&Rd53a::PixRegionCol, dc);
+    m_pixWords += singleWords;
+    for (auto &run : runs) {
+        this->writeRegister(&Rd53a::PixRegionRow, run.first);
+        m_pixWords += singleWords;
+        unsigned row = run.first;
+        while (row < run.second) {
+            unsigned left = run.second-row;
+            // A short rest still goes as a block if the rows after it are known
+            if (left >= 6 || (left*singleWords > blockWords && canFill && row+6 <= n_Row)) {
+                uint16_t block[6];
+                for (unsigned i=0; i<6; i++)
+                    block[i] = value(row+i);
+                this->wrRegisterBlock(m_chipId, PixPortal.addr(), block);
+                m_pixWords += blockWords;
+                row += 6;
+            } else {
+                PixPortal.write(value(row));
+                wrRegister(m_chipId, PixPortal.addr(), m_cfg[PixPortal.addr()]);
+                m_pixWords += singleWords;
+                row++;
+            }
+        }
+        if (m_pixWords > maxBlockWords) {
+            core->fence();
+            m_pixWords = 0;
+        }
+    }
+}
+
+void Rd53a::commit(RegisterTransaction &trans) {
+    std::vector<uint32_t> words;
+    for (unsigned addr : trans.addresses()) {
+        if (words.size() + singleWords > maxBlockWords) {
+            core->writeFifoBlock(words.data(), words.size());
+            core->fence();
+            words.clear();
         }
+        uint32_t buf[singleWords];
+        Rd53aCmd::genWrRegister(m_chipId, addr, m_cfg[addr], buf);
+        words.insert(words.end(), buf, buf+singleWords);
     }
-    while(!core->isCmdEmpty()){;}
+    if (!words.empty())
+        core->writeFifoBlock(words.data(), words.size());
+    core->releaseFifo();
+    trans.clear();
 }
 
 void Rd53a::writeNamedRegister(std::string name, uint16_t value) {
     std::cout << __PRETTY_FUNCTION__ << " : " << name << " -> " << value << std::endl;
-    if (regMap.find(name) != regMap.end())
-        writeRegister(regMap[name], value);
+    Rd53aReg Rd53aGlobalCfg::*ref = this->findReg(name);
+    if (ref != nullptr)
+        writeRegister(ref, value);
 }
 
 // TODO remove magic numbers
@@ -243,36 +346,57 @@ void Rd53a::disableCalCol(unsigned col) {
 }
 
 int Rd53a::checkCom() {
-    //std::cout << __PRETTY_FUNCTION__ << " : Checking communication for " << this->name << " by reading a register .." << std::endl;
-    uint32_t regAddr = 21;
-    uint32_t regValue = m_cfg[regAddr];
-    rdRegister(m_chipId, regAddr);
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    
-    //std::cout << __PRETTY_FUNCTION__ << " : Trying to read data .." << std::endl;
-    // TODO not happy about this, rx knowledge should not be here
-    RawData *data = m_rxcore->readData();
-
-    if (data != NULL) {
-        if (!(data->words == 2 || data->words == 4)) {
-            std::cout << "#ERROR# Received wrong number of words (" << data->words << ") for " << this->name << std::endl;
-            return 0;
-        }
-        std::pair<uint32_t, uint32_t> answer = decodeSingleRegRead(data->buf[0], data->buf[1]);
-        //std::cout << "Addr (" << answer.first << ") Value(" << answer.second << ")" << std::endl;
-        
-        if (answer.first != regAddr || answer.second != regValue) {
-            std::cout << "#ERROR# Received data was not as expected:" << std::endl;
-            std::cout << "    Received Addr: " << answer.first << " (expected " << regAddr <<")" << std::endl;
-            std::cout << "    Received Value: " << answer.second << " (expected "<< regValue << ")" << std::endl;
-            return 0;
+    RegisterReadback readback(core, m_rxcore);
+    return readback.checkCom({this}) ? 1 : 0;
+}
+
+std::vector<unsigned> Rd53a::getReadbackRegisters() {
+    // 21 goes first, it is read to check the communication
+    std::vector<unsigned> addrs = {21};
+    // The pixel portal is skipped and the region moves in auto mode,
+    // from 110 on the registers are read only
+    for (unsigned addr=3; addr<110; addr++) {
+        if (addr != 21)
+            addrs.push_back(addr);
+    }
+    return addrs;
+}
+
+void Rd53a::requestRegisters(const std::vector<unsigned> &addrs) {
+    std::vector<uint32_t> words;
+    for (unsigned addr : addrs) {
+        if (words.size() + 2 > maxBlockWords) {
+            core->writeFifoBlock(words.data(), words.size());
+            core->fence();
+            words.clear();
         }
+        uint32_t buf[2];
+        Rd53aCmd::genRdRegister(m_chipId, addr, buf);
+        words.insert(words.end(), buf, buf+2);
+    }
+    if (!words.empty())
+        core->writeFifoBlock(words.data(), words.size());
+    core->releaseFifo();
+}
 
-        //std::cout << "    ... success!" << std::endl;
-        return 1;
-    } else {
-        std::cout << "#ERROR# Did not receive any data for " << this->name << std::endl;
-        return 0;
+void Rd53a::decodeRegisters(const std::vector<uint32_t> &words, unsigned &pos,
+        const std::vector<unsigned> &rxChannels,
+        std::map<unsigned, std::map<unsigned, uint16_t>> &values) {
+    if (rxChannels.empty()) {
+        pos = words.size();
+        return;
+    }
+    // Frames of two words, the enabled channels take turns starting over
+    // with every chunk, as in Rd53aDataProcessor
+    for (; pos+1 < words.size(); pos += 2) {
+        uint32_t higher = words[pos];
+        uint32_t lower = words[pos+1];
+        unsigned channel = rxChannels[(pos/2)%rxChannels.size()];
+        unsigned code = higher >> 24;
+        if (code == 0x99 || code == 0xd2)
+            values[channel][(higher>>10)&0x3FF] = ((lower>>26)&0x3F)+((higher&0x3FF)<<6);
+        if (code == 0x55 || code == 0xd2)
+            values[channel][(lower>>16)&0x3FF] = lower&0xFFFF;
     }
 }
 
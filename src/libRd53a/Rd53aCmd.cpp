@@ -75,85 +75,93 @@ uint32_t Rd53aCmd::genCal(uint32_t chipId, uint32_t mode, uint32_t delay, uint32
 }
 
 void Rd53aCmd::cal(uint32_t chipId, uint32_t mode, uint32_t delay, uint32_t duration, uint32_t aux_mode, uint32_t aux_delay) {
-    core->writeFifo(0x69696363); 
-    core->writeFifo(Rd53aCmd::genCal(chipId, mode, delay, duration, aux_mode, aux_delay));
+    uint32_t buf[2];
+    buf[0] = 0x69696363;
+    buf[1] = Rd53aCmd::genCal(chipId, mode, delay, duration, aux_mode, aux_delay);
+    core->writeFifoBlock(buf, 2);
     core->releaseFifo();
 }
 
 void Rd53aCmd::wrRegister(uint32_t chipId, uint32_t address, uint16_t value) {
     if (verbose) std::cout << __PRETTY_FUNCTION__ << " : ID(" << chipId << ") ADR(" << address << ") VAL(0x" << std::hex << value << std::dec << ")" << std::endl;
-    // Header
-    core->writeFifo(0x69696666);
-    uint32_t tmp = 0x0;
-    // ID[3:0],0 | ADR[8:4]
-    tmp += (this->encode5to8((chipId & 0xF) << 1)) << 24;
-    tmp += (this->encode5to8((address >> 4) & 0x1F)) << 16;
-    // ADR[3:0],VAL[15] | VAL[14:10]
-    tmp += (this->encode5to8(((address & 0xF) << 1) + ((value >> 15) & 0x1)) << 8);
-    tmp += (this->encode5to8((value >> 10) & 0x1F));
-    core->writeFifo(tmp);
-    // VAL[9:5] | VAL [4:0]
-    tmp = (this->encode5to8((value >> 5) & 0x1F) << 24);
-    tmp += (this->encode5to8(value & 0x1F)) << 16;
-    tmp += 0x6969;
-    core->writeFifo(tmp);
+    uint32_t buf[3];
+    Rd53aCmd::genWrRegister(chipId, address, value, buf);
+    core->writeFifoBlock(buf, 3);
     core->releaseFifo();
 }
 
-// TODO this does not seem to work?
-void Rd53aCmd::wrRegisterBlock(uint32_t chipId, uint32_t address, uint16_t value[6]) {
+void Rd53aCmd::genWrRegister(uint32_t chipId, uint32_t address, uint16_t value, uint32_t buf[3]) {
     // Header
-    core->writeFifo(0x69696666);
+    buf[0] = 0x69696666;
     uint32_t tmp = 0x0;
     // ID[3:0],0 | ADR[8:4]
-    tmp += (this->encode5to8((chipId & 0xF) << 1)) << 24;
-    tmp += (this->encode5to8((address >> 4) & 0x1F)) << 16;
+    tmp += (Rd53aCmd::encode5to8((chipId & 0xF) << 1)) << 24;
+    tmp += (Rd53aCmd::encode5to8((address >> 4) & 0x1F)) << 16;
     // ADR[3:0],VAL[15] | VAL[14:10]
-    tmp += (this->encode5to8((address<<1) + ((value[0] >> 15) & 0x1)) << 8);
-    tmp += (this->encode5to8(value[0] >> 10));
-    core->writeFifo(tmp);
-    // VAL[9:5] | VAL [4:0] | VAL[15:10] | VAL[
-    tmp = (this->encode5to8(value[0] >> 5) << 24);
-    tmp += (this->encode5to8(value[0]) << 16);
-    tmp += (this->encode5to8(value[1] >> 11) << 8);
-    tmp += (this->encode5to8(value[1] >> 6) << 0);
-    core->writeFifo(tmp);
-    tmp = (this->encode5to8(value[1] >> 1) << 24);
-    tmp += (this->encode5to8((value[1]<<4)+((value[2]>>12)&0xF)) << 16);
-    tmp += (this->encode5to8(value[2]>>7) << 8);
-    tmp +=(this->encode5to8(value[2]>>2));
-    core->writeFifo(tmp);
-    tmp = (this->encode5to8((value[2]<<3)+((value[3]>>13)&0x7)) << 24);
-    tmp += (this->encode5to8(value[3]>>8) << 16);
-    tmp += (this->encode5to8(value[3]>>3) << 8);
-    tmp += (this->encode5to8((value[3]<<2)+((value[4]>>14)&0x3)));
-    core->writeFifo(tmp);
-    tmp = (this->encode5to8(value[4]>>9) << 24);
-    tmp += (this->encode5to8(value[4]>>4) << 16);
-    tmp += (this->encode5to8((value[4]<<1)+((value[5]>>15)&0x1)) << 8);
-    tmp += (this->encode5to8(value[5]>>10));
-    core->writeFifo(tmp);
-    tmp = (this->encode5to8(value[5]>>5) << 24);
-    tmp += (this->encode5to8(value[5]) << 16);
+    tmp += (Rd53aCmd::encode5to8(((address & 0xF) << 1) + ((value >> 15) & 0x1)) << 8);
+    tmp += (Rd53aCmd::encode5to8((value >> 10) & 0x1F));
+    buf[1] = tmp;
+    // VAL[9:5] | VAL [4:0]
+    tmp = (Rd53aCmd::encode5to8((value >> 5) & 0x1F) << 24);
+    tmp += (Rd53aCmd::encode5to8(value & 0x1F)) << 16;
     tmp += 0x6969;
+    buf[2] = tmp;
+}
 
+// Six values to the same address, meant for the pixel portal in auto row mode
+// {WrReg,WrReg}{ChipId[3:0],1}{Addr[8:4]}{Addr[3:0],Data[95]}...{Data[4:0]}
+void Rd53aCmd::wrRegisterBlock(uint32_t chipId, uint32_t address, uint16_t value[6]) {
+    if (verbose) std::cout << __PRETTY_FUNCTION__ << " : ID(" << chipId << ") ADR(" << address << ")" << std::endl;
+    // 22 symbols of 5 bits after the header
+    uint32_t symbols[22];
+    symbols[0] = ((chipId & 0xF) << 1) + 0x1;
+    symbols[1] = (address >> 4) & 0x1F;
+    // ADR[3:0] followed by the 96 data bits
+    uint32_t bits = address & 0xF;
+    unsigned nBits = 4;
+    unsigned n = 2;
+    for (unsigned i=0; i<6; i++) {
+        bits = (bits << 16) | value[i];
+        nBits += 16;
+        while (nBits >= 5) {
+            nBits -= 5;
+            symbols[n++] = (bits >> nBits) & 0x1F;
+        }
+        bits &= (1 << nBits) - 1;
+    }
 
+    uint32_t buf[7];
+    // Header
+    buf[0] = 0x69696666;
+    for (unsigned i=0; i<5; i++) {
+        buf[i+1] = (this->encode5to8(symbols[4*i]) << 24)
+            + (this->encode5to8(symbols[4*i+1]) << 16)
+            + (this->encode5to8(symbols[4*i+2]) << 8)
+            + (this->encode5to8(symbols[4*i+3]));
+    }
+    buf[6] = (this->encode5to8(symbols[20]) << 24) + (this->encode5to8(symbols[21]) << 16) + 0x6969;
+    core->writeFifoBlock(buf, 7);
     core->releaseFifo();
-
 }
 
 void Rd53aCmd::rdRegister(uint32_t chipId, uint32_t address) {
     if (verbose) std::cout << __PRETTY_FUNCTION__ << " : ID(" << chipId << ") ADR(" << address << ")" << std::endl;
+    uint32_t buf[2];
+    Rd53aCmd::genRdRegister(chipId, address, buf);
+    core->writeFifoBlock(buf, 2);
+    core->releaseFifo();
+}
+
+void Rd53aCmd::genRdRegister(uint32_t chipId, uint32_t address, uint32_t buf[2]) {
     // Header
-    core->writeFifo(0x69696565);
+    buf[0] = 0x69696565;
     uint32_t tmp = 0x0;
     // ID[3:0],0 | ADR[8:4]
-    tmp += (this->encode5to8((chipId & 0xF) << 1)) << 24;
-    tmp += (this->encode5to8((address >> 4) & 0x1F)) << 16;
+    tmp += (Rd53aCmd::encode5to8((chipId & 0xF) << 1)) << 24;
+    tmp += (Rd53aCmd::encode5to8((address >> 4) & 0x1F)) << 16;
     // ADR[3:0],0
-    tmp += (this->encode5to8((address & 0xF) << 1)) << 8;
-    tmp += (this->encode5to8(0x0)) << 0;
-    core->writeFifo(tmp);
-    core->releaseFifo();
+    tmp += (Rd53aCmd::encode5to8((address & 0xF) << 1)) << 8;
+    tmp += (Rd53aCmd::encode5to8(0x0)) << 0;
+    buf[1] = tmp;
 }
 
@@ -9,6 +9,7 @@
 #include "Rd53aCoreColLoop.h"
 #include "FrontEnd.h"
 #include "Rd53a.h"
+#include "TxProgramCache.h"
 
 class Rd53aCoreColLoop::Impl {
     public:
@@ -16,6 +17,8 @@ class Rd53aCoreColLoop::Impl {
     unsigned nSteps;
     unsigned maxCore;
     unsigned minCore;
+    // Every mask stage goes through the same steps
+    TxProgramCache programs;
 };
 
 
@@ -44,7 +47,7 @@ void Rd53aCoreColLoop::init() {
         dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+2);
         dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+3);
     }
-    while(!g_tx->isCmdEmpty()) {}
+    g_tx->fence();
 }
 
 void Rd53aCoreColLoop::execPart1() {
@@ -52,36 +55,37 @@ void Rd53aCoreColLoop::execPart1() {
         std::cout << __PRETTY_FUNCTION__ << std::endl;
     
     g_tx->setCmdEnable(keeper->getTxMask());
-    // Loop over cores, i.e. activate in pairs of 4 DC
-    for (unsigned dc=(m_impl->minCore*4), i=0; dc<(m_impl->maxCore*4); dc+=4, i++) {
-        // Disable previous columns
-        if (m_impl->m_cur>0 && ((i%m_impl->nSteps) == (m_impl->m_cur-step))) {
-            dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc);
-            dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+1);
-            dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+2);
-            dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+3);
-        }
-        // Enable next columns
-        if (i%m_impl->nSteps == m_impl->m_cur) {
-            if (verbose)
-                std::cout << __PRETTY_FUNCTION__ << " : Enabling QC -> " << dc << std::endl;
-            dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc);
-            dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc+1);
-            dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc+2);
-            dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc+3);
+    m_impl->programs.run(g_fe, g_tx, m_impl->m_cur, [&]() {
+        // Loop over cores, i.e. activate in pairs of 4 DC
+        for (unsigned dc=(m_impl->minCore*4), i=0; dc<(m_impl->maxCore*4); dc+=4, i++) {
+            // Disable previous columns
+            if (m_impl->m_cur>0 && ((i%m_impl->nSteps) == (m_impl->m_cur-step))) {
+                dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc);
+                dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+1);
+                dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+2);
+                dynamic_cast<Rd53a*>(g_fe)->disableCalCol(dc+3);
+            }
+            // Enable next columns
+            if (i%m_impl->nSteps == m_impl->m_cur) {
+                if (verbose)
+                    std::cout << __PRETTY_FUNCTION__ << " : Enabling QC -> " << dc << std::endl;
+                dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc);
+                dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc+1);
+                dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc+2);
+                dynamic_cast<Rd53a*>(g_fe)->enableCalCol(dc+3);
+            }
+        //Add fine delay
         }
-    //Add fine delay
-        while(!g_tx->isCmdEmpty()) {}
-    }
 
-    // TODO this needs to be changed to be per FE
-    if ( m_delayArray.size() > 0 ) {
-        if ( m_delayArray.size() == (m_impl->maxCore-m_impl->minCore) ) 
-            dynamic_cast<Rd53a*>(g_fe)->writeRegister(&Rd53a::InjDelay,m_delayArray[m_impl->m_cur]);
-        else 
-            dynamic_cast<Rd53a*>(g_fe)->writeRegister(&Rd53a::InjDelay,m_delayArray[0]);
-    }
-    while(!g_tx->isCmdEmpty()) {}
+        // TODO this needs to be changed to be per FE
+        if ( m_delayArray.size() > 0 ) {
+            if ( m_delayArray.size() == (m_impl->maxCore-m_impl->minCore) ) 
+                dynamic_cast<Rd53a*>(g_fe)->writeRegister(&Rd53a::InjDelay,m_delayArray[m_impl->m_cur]);
+            else 
+                dynamic_cast<Rd53a*>(g_fe)->writeRegister(&Rd53a::InjDelay,m_delayArray[0]);
+        }
+    });
+    g_tx->fence();
     
     g_stat->set(this, m_impl->m_cur);
     //std::this_thread::sleep_for(std::chrono::milliseconds(20));
@@ -111,7 +115,7 @@ void Rd53aCoreColLoop::end() {
             dynamic_cast<Rd53a*>(fe)->enableCalCol(dc+3);
         }
     }
-    while(!g_tx->isCmdEmpty()) {}
+    g_tx->fence();
     */
     //std::this_thread::sleep_for(std::chrono::milliseconds(20));
 }
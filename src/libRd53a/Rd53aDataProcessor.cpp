@@ -8,6 +8,7 @@
 
 #include "Rd53aDataProcessor.h"
 #include "AllProcessors.h"
+#include "MultiController.h"
 
 bool rd53a_proc_registered =
     StdDict::registerDataProcessor("RD53A", []() { return std::unique_ptr<DataProcessor>(new Rd53aDataProcessor());});
@@ -29,6 +30,7 @@ void Rd53aDataProcessor::init() {
 
     for (auto &it : *m_outMap) {
         activeChannels.push_back(it.first);
+        ctrlChannels[MultiController::ctrlOf(it.first)].push_back(it.first);
     }
     scanDone = false;
 }
@@ -100,6 +102,11 @@ void Rd53aDataProcessor::process_core() {
             events[activeChannels[i]] = 0;
         }
 
+        // Each controller interleaves only its own channels
+        auto ctrlIt = ctrlChannels.find(curInV->ctrl);
+        if (ctrlIt == ctrlChannels.end())
+            continue;
+        const std::vector<unsigned> &channels = ctrlIt->second;
         unsigned size = curInV->size();
         for(unsigned c=0; c<size; c++) {
             RawData *curIn = new RawData(curInV->adr[c], curInV->buf[c], curInV->words[c]);
@@ -111,7 +118,7 @@ void Rd53aDataProcessor::process_core() {
                 // TODO this needs review, can't deal with user-k data
                 uint32_t data = curIn->buf[i];
 
-                unsigned channel = activeChannels[(i/2)%activeChannels.size()];
+                unsigned channel = channels[(i/2)%channels.size()];
                 //std::cout << "[" << i << "]\t\t[" << channel << "] = 0x" << std::hex << data << std::dec << std::endl;
                 if (__builtin_expect(((data & 0xFFFF0000) != 0xFFFF0000 ), 1)) {
                     if ((data >> 25) & 0x1) { // is header
@@ -83,8 +83,8 @@ void Rd53aGlobalFeedback::feedback(unsigned channel, double sign, bool last) {
     if (val <= min) {
         m_doneMap[channel] = true;
     }
-    // Unlock the mutex to let the scan proceed
-    keeper->mutexMap[channel].unlock();
+    // Let the scan proceed with this channel
+    fbChannel.post(channel);
 }
 
 void Rd53aGlobalFeedback::feedbackBinary(unsigned channel, double sign, bool last) {
@@ -99,15 +99,15 @@ void Rd53aGlobalFeedback::feedbackBinary(unsigned channel, double sign, bool las
         m_doneMap[channel] = true;
     }
 
-    // Unlock the mutex to let the scan proceed
-    keeper->mutexMap[channel].unlock();
+    // Let the scan proceed with this channel
+    fbChannel.post(channel);
 
 }
 
 void Rd53aGlobalFeedback::feedbackStep(unsigned channel, double sign, bool last) {
     m_values[channel] = m_values[channel] + sign;
     m_doneMap[channel] |= last;
-    keeper->mutexMap[channel].unlock();
+    fbChannel.post(channel);
 }
 
 
@@ -124,23 +124,27 @@ bool Rd53aGlobalFeedback::allDone() {
 void Rd53aGlobalFeedback::writePar() {
     for (auto *fe : keeper->feList) {
         if(fe->getActive()) {
-            // Enable single channel
-            g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
-            // Write parameter
-            dynamic_cast<Rd53a*>(fe)->writeRegister(parPtr, m_values[dynamic_cast<FrontEndCfg*>(fe)->getRxChannel()]);
-            while(!g_tx->isCmdEmpty()){}
+            this->writePar(fe);
         }
     }
     // Reset CMD mask
     g_tx->setCmdEnable(keeper->getTxMask());
 }
 
+void Rd53aGlobalFeedback::writePar(FrontEnd *fe) {
+    // Enable single channel
+    g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
+    // Write parameter
+    dynamic_cast<Rd53a*>(fe)->writeRegister(parPtr, m_values[dynamic_cast<FrontEndCfg*>(fe)->getRxChannel()]);
+    g_tx->fence();
+}
+
 void Rd53aGlobalFeedback::init() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
     m_done = false;
     m_cur = 0;
-    parPtr = keeper->globalFe<Rd53a>()->regMap[parName];
+    parPtr = keeper->globalFe<Rd53a>()->findReg(parName);
     // Init maps
     for (auto *fe : keeper->feList) {
         if (fe->getActive()) {
@@ -212,32 +216,30 @@ void Rd53aGlobalFeedback::init() {
                     break;
             }
         }
-        while(!g_tx->isCmdEmpty()){}
+        g_tx->fence();
     }
     g_tx->setCmdEnable(keeper->getTxMask());
 }
 
 void Rd53aGlobalFeedback::execPart1() {
     g_stat->set(this, m_cur);
-    // Lock all mutexes
+    // Expect feedback from all active FEs
     for (auto fe : keeper->feList) {
         if (fe->getActive()) {
-            keeper->mutexMap[dynamic_cast<FrontEndCfg*>(fe)->getRxChannel()].try_lock();
+            fbChannel.expect(dynamic_cast<FrontEndCfg*>(fe)->getRxChannel());
         }
     }
 }
 
 void Rd53aGlobalFeedback::execPart2() {
-    // Wait for mutexes to be unlocked by feedback
-    for (auto fe: keeper->feList) {
-        if (fe->getActive()) {
-            unsigned rx = dynamic_cast<FrontEndCfg*>(fe)->getRxChannel();
-            keeper->mutexMap[rx].lock();
-            std::cout << " --> Received Feedback on Channel " << rx << " with value: " << m_values[rx] << std::endl;
-        }
+    // Write each FE as soon as its feedback arrived
+    unsigned rx;
+    while (fbChannel.next(rx)) {
+        std::cout << " --> Received Feedback on Channel " << rx << " with value: " << m_values[rx] << std::endl;
+        this->writePar(keeper->getFe(rx));
     }
+    g_tx->setCmdEnable(keeper->getTxMask());
     m_cur++;
-    this->writePar();
     m_done = this->allDone();
 }
 
@@ -7,6 +7,7 @@
 // ################################
 
 #include "Rd53aMaskLoop.h"
+#include "TxBroadcaster.h"
 
 //enum PixelCategories  {LeftEdge, BottomEdge, RightEdge, UpperEdge, Corner, Middle};
 //enum CornerCategories {UpperLeft, BottomLeft, BottomRight, UpperRight, NotCorner};
@@ -91,20 +92,22 @@ void Rd53aMaskLoop::init() {
         std::cout << __PRETTY_FUNCTION__ << std::endl;
     m_done = false;
     m_cur = min;
-    for(FrontEnd *fe : keeper->feList) {
+    m_stage = 0;
+    this->compileStages();
+    TxBroadcaster broadcaster(g_tx);
+    broadcaster.write(keeper->feList, [&](FrontEnd *fe) {
+        Rd53a *rd53a = dynamic_cast<Rd53a*>(fe);
         // Make copy of pixRegs
-        m_pixRegs[fe] = dynamic_cast<Rd53a*>(fe)->pixRegs;
-        g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
+        m_pixRegs[fe] = rd53a->pixRegs;
         for(unsigned col=0; col<Rd53a::n_Col; col++) {
             for(unsigned row=0; row<Rd53a::n_Row; row++) {
-                dynamic_cast<Rd53a*>(fe)->setEn(col, row, 0);
-                dynamic_cast<Rd53a*>(fe)->setInjEn(col, row, 0);
+                rd53a->setEn(col, row, 0);
+                rd53a->setInjEn(col, row, 0);
             }
         }
         // TODO make configrue for subset
-        dynamic_cast<Rd53a*>(fe)->configurePixels();
-        while(!g_tx->isCmdEmpty()) {}
-    }
+        rd53a->configurePixels();
+    });
     // Reset CMD mask
     g_tx->setCmdEnable(keeper->getTxMask());
 }
@@ -113,76 +116,18 @@ void Rd53aMaskLoop::execPart1() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
 
-    // Loop over FrontEnds
-    for(FrontEnd *fe : keeper->feList) {
-        g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
-        std::vector<std::pair<unsigned, unsigned>> modPixels;
-        //Loop over all pixels - n_Col=400, n_Row=192 - from Rd53aPixelCfg.h
-        for(unsigned col=0; col<Rd53a::n_Col; col++) {
-            for(unsigned row=0; row<Rd53a::n_Row; row++) {
-                if (ApplyMask(col,row)){
-                    if (m_maskType == StandardMask){	       
-                        //------------------------------------------------------------------------
-                        //standard map, inj and read out the same pixel
-                        //------------------------------------------------------------------------
-                        dynamic_cast<Rd53a*>(fe)->setEn(col, row, 1);
-                        dynamic_cast<Rd53a*>(fe)->setInjEn(col, row, 1);
-                        modPixels.push_back(std::make_pair(col, row));
-                    } 		
-                    if (m_maskType == CrossTalkMask  ){	      
-                        //---------------------------------------------------------------------------------
-                        // std cross-talk scan, inj in surrounding pixels and read out the central one
-                        //---------------------------------------------------------------------------------		    		  
-                        std::vector<std::pair<int, int>> neighbours;		 
-                        getNeighboursMap(col,row,m_sensorType, m_maskSize, neighbours);
-                        //Read-only central pixel
-                        dynamic_cast<Rd53a*>(fe)->setInjEn(col, row, 0);		
-                        dynamic_cast<Rd53a*>(fe)->setEn(col, row, 1);
-                        modPixels.push_back(std::make_pair(col, row));
-                        //Inject only neighbours
-                        for (auto n: neighbours){ 
-                            dynamic_cast<Rd53a*>(fe)->setInjEn(n.first, n.second,1);
-                            dynamic_cast<Rd53a*>(fe)->setEn(n.first, n.second, 0);
-                            modPixels.push_back(std::make_pair(n.first, n.second));
-                        }
-                    }
-                    else if (m_maskType == CrossTalkMaskv2 ){	      
-                        //---------------------------------------------------------------------------------
-                        // alternative cross-talk scan, inj central pixel, read out the surrounding ones
-                        //--------------------------------------------------------------------------------		  
-                        std::vector<std::pair<int, int>> neighbours;		 
-                        getNeighboursMap(col,row, m_sensorType,m_maskSize,neighbours);
-                        //Read-only central pixel
-                        dynamic_cast<Rd53a*>(fe)->setInjEn(col, row, 1);		
-                        dynamic_cast<Rd53a*>(fe)->setEn(col, row, 0);
-                        modPixels.push_back(std::make_pair(col, row));
-                        //Inject only neighbours
-                        for (auto n: neighbours){ 		  	       
-                            dynamic_cast<Rd53a*>(fe)->setInjEn(n.first, n.second, 0);
-                            dynamic_cast<Rd53a*>(fe)->setEn(n.first, n.second, 1);
-                            modPixels.push_back(std::make_pair(n.first, n.second));
-                        }
-                    }
-                }//end ApplyMask
-                else {
-                    if (m_maskType == StandardMask){	       
-                        //---------------------------------------------------------------------------------
-                        // clean pixels for standardmask
-                        //--------------------------------------------------------------------------------- 		  
-                        if (dynamic_cast<Rd53a*>(fe)->getInjEn(col, row) == 1) {
-                            dynamic_cast<Rd53a*>(fe)->setEn(col, row, 0);
-                            dynamic_cast<Rd53a*>(fe)->setInjEn(col, row, 0);
-                            modPixels.push_back(std::make_pair(col, row));
-                        }		
-                    }
-                }	     
-            }//end row
-        }//end column
-
-        // TODO make configrue for subset
-        // TODO set cmeEnable correctly
-        dynamic_cast<Rd53a*>(fe)->configurePixels(modPixels);
-        while(!g_tx->isCmdEmpty()) {}
+    if (m_stage < m_stages.size()) {
+        MaskStage &stage = m_stages[m_stage];
+        // FEs with the same pixel config get the stage in one go
+        TxBroadcaster broadcaster(g_tx);
+        broadcaster.write(keeper->feList, [&](FrontEnd *fe) {
+            Rd53a *rd53a = dynamic_cast<Rd53a*>(fe);
+            for (unsigned i=0; i<stage.pixels.size(); i++) {
+                rd53a->setEn(stage.pixels[i].first, stage.pixels[i].second, stage.bits[i] & 0x1);
+                rd53a->setInjEn(stage.pixels[i].first, stage.pixels[i].second, (stage.bits[i] >> 1) & 0x1);
+            }
+            rd53a->configurePixels(stage.pixels);
+        });
     }
     // Reset CMD mask
     g_tx->setCmdEnable(keeper->getTxMask());
@@ -195,40 +140,25 @@ void Rd53aMaskLoop::execPart2() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
 
-    // Loop over FrontEnds to clean it up
-    if (m_maskType == CrossTalkMask or m_maskType == CrossTalkMaskv2 ){
-        for(FrontEnd *fe : keeper->feList) {
-            g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
-            std::vector<std::pair<unsigned, unsigned>> modPixels;
-            for(unsigned col=0; col<Rd53a::n_Col; col++) {
-                for(unsigned row=0; row<Rd53a::n_Row; row++) {
-                    if (ApplyMask(col,row)){
-                        std::vector<std::pair<int, int>> neighbours;		 
-                        //switch off central pixel
-                        dynamic_cast<Rd53a*>(fe)->setInjEn(col, row, 0);		
-                        dynamic_cast<Rd53a*>(fe)->setEn(col, row, 0);
-                        modPixels.push_back(std::make_pair(col, row));
-                        //switch off neighbours
-                        getNeighboursMap(col,row, m_sensorType,m_maskSize, neighbours);
-                        for (auto n: neighbours){ 		  	       
-                            dynamic_cast<Rd53a*>(fe)->setInjEn(n.first, n.second, 0);
-                            dynamic_cast<Rd53a*>(fe)->setEn(n.first, n.second, 0);
-                            modPixels.push_back(std::make_pair(n.first, n.second));
-                        }
-                    }
-                }
-            }	
-            dynamic_cast<Rd53a*>(fe)->configurePixels(modPixels);
-            while(!g_tx->isCmdEmpty()) {}	
-        }
+    // Loop over FrontEnds to clean it up, the standard mask is switched
+    // off together with the next stage
+    if ((m_maskType == CrossTalkMask or m_maskType == CrossTalkMaskv2) and m_stage < m_stages.size()){
+        MaskStage &stage = m_stages[m_stage];
+        TxBroadcaster broadcaster(g_tx);
+        broadcaster.write(keeper->feList, [&](FrontEnd *fe) {
+            Rd53a *rd53a = dynamic_cast<Rd53a*>(fe);
+            for (auto &pixel : stage.pixels) {
+                rd53a->setInjEn(pixel.first, pixel.second, 0);
+                rd53a->setEn(pixel.first, pixel.second, 0);
+            }
+            rd53a->configurePixels(stage.pixels);
+        });
+        g_tx->setCmdEnable(keeper->getTxMask());
     }
 
     m_cur += step;
+    m_stage++;
     if (!((int)m_cur < max)) m_done = true;
-    // Nothing else to do here?
-
-
-
 }
 
 void Rd53aMaskLoop::end() {
@@ -318,24 +248,76 @@ bool Rd53aMaskLoop::getNeighboursMap(int col, int row,int sensorType, int maskSi
     return filled;
 }
 
-//Return true if the pixel should be considered for this scan step, or false if it should be ignored
-bool Rd53aMaskLoop::ApplyMask(int col, int row){
-
+// Build the pixel list of every stage up front, so execPart1 only has to
+// copy the bits into the pixel registers
+void Rd53aMaskLoop::compileStages() {
+    const uint8_t en = 0x1;
+    const uint8_t injEn = 0x2;
+    const uint8_t touched = 0x4;
+
+    m_stages.clear();
+    if (max <= 0 || step == 0)
+        return;
+
+    // Sort the pixels into the stage they are scanned in
+    std::vector<std::vector<std::pair<int, int>>> serialPixels(max);
+    for(unsigned col=0; col<Rd53a::n_Col; col++) {
+        for(unsigned row=0; row<Rd53a::n_Row; row++) {
+            //Do not run over edges pixels, if not explicity requested
+            if (IgnorePixel(col, row)) continue;
+            unsigned core_row = row/8;
+            unsigned serial = (core_row*64)+((col+(core_row%8))%8)*8+row%8;
+            serialPixels[serial%max].push_back(std::make_pair(col, row));
+        }
+    }
 
-    //Do not run over edges pixels, if not explicity requested
-    if (IgnorePixel(col, row)) return false;
+    // Final state of every pixel touched in a stage, in column order
+    std::vector<uint8_t> state(Rd53a::n_Col*Rd53a::n_Row, 0);
+    auto set = [&](int col, int row, uint8_t bits) {
+        state[col*Rd53a::n_Row+row] = touched | bits;
+    };
+
+    for (unsigned cur=min; (int)cur<max; cur+=step) {
+        std::vector<std::pair<int, int>> &central = serialPixels[cur];
+        if (m_maskType == StandardMask) {
+            //------------------------------------------------------------------------
+            //standard map, inj and read out the same pixel, the pixels of the
+            //previous stage are cleaned in the same go
+            //------------------------------------------------------------------------
+            if (cur != (unsigned)min) {
+                for (auto &p : serialPixels[cur-step])
+                    set(p.first, p.second, 0);
+            }
+            for (auto &p : central)
+                set(p.first, p.second, en | injEn);
+        } else if (m_maskType == CrossTalkMask or m_maskType == CrossTalkMaskv2) {
+            //---------------------------------------------------------------------------------
+            // std cross-talk scan, inj in surrounding pixels and read out the central one
+            // alternative cross-talk scan, inj central pixel, read out the surrounding ones
+            //---------------------------------------------------------------------------------
+            uint8_t centralBits = (m_maskType == CrossTalkMask) ? en : injEn;
+            uint8_t neighbourBits = (m_maskType == CrossTalkMask) ? injEn : en;
+            for (auto &p : central) {
+                std::vector<std::pair<int, int>> neighbours;
+                getNeighboursMap(p.first, p.second, m_sensorType, m_maskSize, neighbours);
+                set(p.first, p.second, centralBits);
+                for (auto &n : neighbours)
+                    set(n.first, n.second, neighbourBits);
+            }
+        }
 
-    unsigned core_row = row/8;
-    unsigned serial = (core_row*64)+((col+(core_row%8))%8)*8+row%8;
-    if ((serial%max) == m_cur){
-        return true;
+        m_stages.emplace_back();
+        MaskStage &stage = m_stages.back();
+        for (unsigned i=0; i<state.size(); i++) {
+            if (state[i] & touched) {
+                stage.pixels.push_back(std::make_pair(i/Rd53a::n_Row, i%Rd53a::n_Row));
+                stage.bits.push_back(state[i] & (en | injEn));
+                state[i] = 0;
+            }
+        }
     }
-    else
-        return false;
-
 }
 
-
 bool Rd53aMaskLoop::IgnorePixel(int col, int row){
 
     //if checking bump bonding connections for rectangular sensors, only use (0,0) pixel
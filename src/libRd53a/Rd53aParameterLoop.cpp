@@ -30,7 +30,7 @@ void Rd53aParameterLoop::init() {
         std::cout << __PRETTY_FUNCTION__ << std::endl;
     m_done = false;
     m_cur = min;
-    parPtr = keeper->globalFe<Rd53a>()->regMap[parName];
+    parPtr = keeper->globalFe<Rd53a>()->findReg(parName);
     this->writePar();
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
 }
@@ -56,7 +56,7 @@ void Rd53aParameterLoop::end() {
 
 void Rd53aParameterLoop::writePar() {
     keeper->globalFe<Rd53a>()->writeRegister(parPtr, m_cur);
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
     //std::this_thread::sleep_for(std::chrono::milliseconds(20));
 }
 
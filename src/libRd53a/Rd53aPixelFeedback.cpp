@@ -8,6 +8,7 @@
 // ################################
 
 #include "Rd53aPixelFeedback.h"
+#include "TxBroadcaster.h"
 
 Rd53aPixelFeedback::Rd53aPixelFeedback() {
     min = -15;
@@ -20,6 +21,7 @@ Rd53aPixelFeedback::Rd53aPixelFeedback() {
     tuneLin = true;
     tuneDiff = true;
     m_resetTdac = true;
+    m_useModel = false;
 }
 
 void Rd53aPixelFeedback::writeConfig(json &j) {
@@ -29,6 +31,7 @@ void Rd53aPixelFeedback::writeConfig(json &j) {
     j["tuneDiff"] = tuneDiff;
     j["tuneLin"] = tuneLin;
     j["resetTdac"] = m_resetTdac;
+    j["model"] = m_useModel;
 }
 
 void Rd53aPixelFeedback::loadConfig(json &j) {
@@ -42,6 +45,8 @@ void Rd53aPixelFeedback::loadConfig(json &j) {
         tuneLin = j["tuneLin"];
     if (!j["resetTdac"].empty())
         m_resetTdac = j["resetTdac"];
+    if (!j["model"].empty())
+        m_useModel = j["model"];
     if (!j["steps"].empty()) {
         m_steps.clear();
         for(auto i: j["steps"])
@@ -57,31 +62,49 @@ void Rd53aPixelFeedback::feedback(unsigned channel, Histo2d *h) {
             << " --> ERROR : Wrong type of feedback histogram on channel " << channel << std::endl;
         doneMap[channel] = true;
     } else {
-        m_fb[channel] = h;
+        Rd53a *fe = dynamic_cast<Rd53a*>(keeper->getFe(channel));
+        // All but the last step jump to the predicted TDAC, the last one
+        // refines by the sign only
+        bool model = m_useModel && (m_cur+1 < m_steps.size());
+        // Only looked up, the analyses of all FEs get here at the same time
+        TdacModel *tm = model ? &m_model.at(channel) : nullptr;
         for (unsigned row=1; row<=Rd53a::n_Row; row++) {
             for (unsigned col=1; col<=Rd53a::n_Col; col++) {
-                int sign = m_fb[channel]->getBin(m_fb[channel]->binNum(col, row));
-                int v = dynamic_cast<Rd53a*>(keeper->getFe(channel))->getTDAC(col-1, row-1);
+                unsigned bin = h->binNum(col, row);
+                double dev = h->getBin(bin);
+                int sign = m_useModel ? TdacModel::sign(dev) : (int)dev;
+                int v = fe->getTDAC(col-1, row-1);
                 if (128<col && col<=264 && tuneLin) {
-                    v = v + ((m_steps[m_cur])*sign);
+                    if (model) {
+                        v = tm->next(bin, v, dev, 1, m_steps[m_cur], min, max);
+                    } else {
+                        v = v + ((m_steps[m_cur])*sign);
+                    }
                     if (v<min) v = min;
                     if (v>max) v = max;
                 } else if (264<col && tuneDiff) {
-                    v = v + (m_steps[m_cur]*sign*-1);
+                    if (model) {
+                        v = tm->next(bin, v, dev, -1, m_steps[m_cur], min, max);
+                    } else {
+                        v = v + (m_steps[m_cur]*sign*-1);
+                    }
                     if (v<min) v = min;
                     if (v>max) v = max;
                 }
-                dynamic_cast<Rd53a*>(keeper->getFe(channel))->setTDAC(col-1, row-1, v);
+                fe->setTDAC(col-1, row-1, v);
             }
         }
+        if (model)
+            tm->update();
     }
-    keeper->mutexMap[channel].unlock();
+    delete h;
+    fbChannel.post(channel);
 }
 
 void Rd53aPixelFeedback::writePixelCfg(Rd53a *fe) {
     g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
     fe->configurePixels();
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
     g_tx->setCmdEnable(keeper->getTxMask());
 }
 
@@ -90,12 +113,21 @@ void Rd53aPixelFeedback::init() {
         std::cout << __PRETTY_FUNCTION__ << std::endl;
     m_done = false;
     m_cur = 0;
+    m_model.clear();
+    // feedback() only looks the entries up
+    for (auto *fe : keeper->feList) {
+        if (fe->getActive()) {
+            unsigned ch = dynamic_cast<FrontEndCfg*>(fe)->getRxChannel();
+            doneMap[ch] = false;
+            if (m_useModel)
+                m_model[ch].init(Rd53a::n_Row*Rd53a::n_Col);
+        }
+    }
     // Init maps
     if (m_resetTdac) {
         for (auto *fe : keeper->feList) {
             if (fe->getActive()) {
                 unsigned ch = dynamic_cast<FrontEndCfg*>(fe)->getRxChannel();
-                m_fb[ch] = NULL;
                 int linCnt = 0;
                 int diffCnt = 0;
                 for (unsigned col=1; col<=Rd53a::n_Col; col++) {
@@ -117,23 +149,30 @@ void Rd53aPixelFeedback::init() {
 
 void Rd53aPixelFeedback::execPart1() {
     g_stat->set(this, m_cur);
-    // Lock all mutexes
+    std::vector<FrontEnd*> active;
     for (auto fe : keeper->feList) {
         if (fe->getActive()) {
-            keeper->mutexMap[dynamic_cast<FrontEndCfg*>(fe)->getRxChannel()].try_lock();
-            this->writePixelCfg(dynamic_cast<Rd53a*>(fe));
+            fbChannel.expect(dynamic_cast<FrontEndCfg*>(fe)->getRxChannel());
+            active.push_back(fe);
         }
     }
+    // Later iterations are written when the feedback arrives, the first
+    // one usually starts all FEs from the same trim
+    if (m_cur == 0) {
+        TxBroadcaster broadcaster(g_tx);
+        broadcaster.write(active, [](FrontEnd *fe) {
+            dynamic_cast<Rd53a*>(fe)->configurePixels();
+        });
+        g_tx->setCmdEnable(keeper->getTxMask());
+    }
     std::cout << " -> Feedback step " << m_cur << " with size " << m_steps[m_cur] << std::endl;
 }
 
 void Rd53aPixelFeedback::execPart2() {
-    // Wait for mutexes to be unlocked by feedback
-    for (auto fe: keeper->feList) {
-        if (fe->getActive()) {
-            unsigned rx = dynamic_cast<FrontEndCfg*>(fe)->getRxChannel();
-            keeper->mutexMap[rx].lock();
-        }
+    // Write each FE as soon as its feedback arrived
+    unsigned rx;
+    while (fbChannel.next(rx)) {
+        this->writePixelCfg(dynamic_cast<Rd53a*>(keeper->getFe(rx)));
     }
     m_cur++;
     if (m_cur == m_steps.size()) {
@@ -142,13 +181,5 @@ void Rd53aPixelFeedback::execPart2() {
 }
 
 void Rd53aPixelFeedback::end() {
-    /*
-    for (auto fe: keeper->feList) {
-        if (fe->getActive()) {
-            unsigned rx = dynamic_cast<FrontEndCfg*>(fe)->getRxChannel();
-            keeper->mutexMap[rx].lock();
-            this->writePixelCfg(dynamic_cast<Rd53a*>(fe));
-        }
-    }
-    */
+    // Final TDACs were already written in the last execPart2
 }
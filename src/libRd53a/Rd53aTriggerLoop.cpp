@@ -115,22 +115,25 @@ void Rd53aTriggerLoop::init() {
     g_tx->setTrigTime(m_trigTime);
 
     g_tx->setCmdEnable(keeper->getTxMask());
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
     //std::this_thread::sleep_for(std::chrono::milliseconds(1));
 }
 
 void Rd53aTriggerLoop::execPart1() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
+    // The previous stage may still be read out
+    LoopActionBase::waitDrained();
     g_tx->setCmdEnable(keeper->getTxMask());
     dynamic_cast<Rd53a*>(g_fe)->ecr();
     dynamic_cast<Rd53a*>(g_fe)->idle();
     dynamic_cast<Rd53a*>(g_fe)->idle();
     dynamic_cast<Rd53a*>(g_fe)->idle();
     dynamic_cast<Rd53a*>(g_fe)->idle();
+    uint64_t reset = g_tx->submit();
     std::this_thread::sleep_for(std::chrono::microseconds(200));
     g_rx->flushBuffer();
-    while(!g_tx->isCmdEmpty());
+    g_tx->wait(reset);
     std::this_thread::sleep_for(std::chrono::microseconds(10));
     g_tx->setTrigEnable(0x1);
 
@@ -10,6 +10,7 @@
 // # Date: Jun 2017
 // #################################
 
+#include <array>
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -21,6 +22,7 @@
 #include "RxCore.h"
 #include "Rd53aCfg.h"
 #include "Rd53aCmd.h"
+#include "RegisterTransaction.h"
 
 class Rd53a : public FrontEnd, public Rd53aCfg, public Rd53aCmd {
     public:
@@ -33,14 +35,33 @@ class Rd53a : public FrontEnd, public Rd53aCfg, public Rd53aCmd {
         void makeGlobal() override {
             m_chipId = 8;
         }
+        TxCore* setCmdCore(TxCore *arg_core) override {
+            TxCore *prev = core;
+            this->setCore(arg_core);
+            return prev;
+        }
+        uint16_t* getRegShadow(unsigned &length) override {
+            length = numRegs;
+            return m_cfg.data();
+        }
 
         void configure() override;
         void configureInit();
         void configureGlobal();
+        // Return without waiting for the commands to be sent, fence the
+        // core before switching channels
         void configurePixels();
         void configurePixels(std::vector<std::pair<unsigned, unsigned>> &pixels);
+        // Forget what was written to the pixels, the next full
+        // configurePixels() writes every double pixel again
+        void resetPixelShadow() {m_pixShadowValid = false;}
 
         int checkCom() override;
+        std::vector<unsigned> getReadbackRegisters() override;
+        void requestRegisters(const std::vector<unsigned> &addrs) override;
+        void decodeRegisters(const std::vector<uint32_t> &words, unsigned &pos,
+                const std::vector<unsigned> &rxChannels,
+                std::map<unsigned, std::map<unsigned, uint16_t>> &values) override;
 
         void maskPixel(unsigned col, unsigned row) override {
             this->setEn(col, row, 0);
@@ -48,6 +69,10 @@ class Rd53a : public FrontEnd, public Rd53aCfg, public Rd53aCmd {
         }
 
         void writeRegister(Rd53aReg Rd53aGlobalCfg::*ref, uint32_t value);
+        // Only sets the field, commit() writes all registers of the
+        // transaction in one block
+        void writeRegister(RegisterTransaction &trans, Rd53aReg Rd53aGlobalCfg::*ref, uint32_t value);
+        void commit(RegisterTransaction &trans);
         void readRegister(Rd53aReg Rd53aGlobalCfg::*ref);
         void writeNamedRegister(std::string name, uint16_t value) override;
         
@@ -62,6 +87,14 @@ class Rd53a : public FrontEnd, public Rd53aCfg, public Rd53aCmd {
     protected:
     private:
         std::pair<uint32_t, uint32_t> decodeSingleRegRead(uint32_t higher, uint32_t lower);
+
+        // Pixel registers as last written to the chip, only double pixels
+        // which differ from it are sent again
+        std::array<uint16_t, n_DC*n_Row> m_pixShadow;
+        bool m_pixShadowValid = false;
+        // Pixel words written since the last fence
+        unsigned m_pixWords = 0;
+        void writePixelRows(unsigned dc, std::vector<unsigned> &rows, const std::vector<uint8_t> *selected);
 };
 
 #endif
@@ -49,6 +49,9 @@ class Rd53aCmd {
         void sync();
         void idle();
 
+        // Words of a register write, to send several in one block
+        static void genWrRegister(uint32_t chipId, uint32_t address, uint16_t value, uint32_t buf[3]);
+        static void genRdRegister(uint32_t chipId, uint32_t address, uint32_t buf[2]);
         static uint32_t genTrigger(uint32_t bc, uint32_t tag, uint32_t bc2=0, uint32_t tag2=0);
         static uint32_t genCal(uint32_t chipId, uint32_t mode, uint32_t delay, uint32_t duration, uint32_t aux_mode, uint32_t aux_delay);
     protected:
@@ -39,6 +39,8 @@ class Rd53aDataProcessor : public DataProcessor {
         ClipBoard<RawDataContainer> *m_input;
         std::map<unsigned, ClipBoard<EventDataBase>> *m_outMap;
         std::vector<unsigned> activeChannels;
+        // Active channels of every controller
+        std::map<unsigned, std::vector<unsigned>> ctrlChannels;
         
         std::map<unsigned, unsigned> tag;
         std::map<unsigned, unsigned> l1id;
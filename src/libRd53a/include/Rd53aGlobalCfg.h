@@ -115,13 +115,17 @@ class Rd53aGlobalCfg {
         ~Rd53aGlobalCfg();
         void init();
 
+        // Looked up in a table hashed at compile time, nullptr if unknown
+        Rd53aReg Rd53aGlobalCfg::*findReg(const std::string &name);
+
         uint16_t getValue(Rd53aReg Rd53aGlobalCfg::*ref) {
             return (this->*ref).read();
         }
 
         uint16_t getValue(std::string name) {
-            if (regMap.find(name) != regMap.end()) {
-                return (this->*regMap[name]).read();
+            Rd53aReg Rd53aGlobalCfg::*ref = this->findReg(name);
+            if (ref != nullptr) {
+                return (this->*ref).read();
             } else {
                 std::cerr << " --> Error: Could not find register \"" << name << "\"" << std::endl;
             }
@@ -133,8 +137,9 @@ class Rd53aGlobalCfg {
         }
 
         void setValue(std::string name, uint16_t val) {
-            if (regMap.find(name) != regMap.end()) {
-                (this->*regMap[name]).write(val);
+            Rd53aReg Rd53aGlobalCfg::*ref = this->findReg(name);
+            if (ref != nullptr) {
+                (this->*ref).write(val);
             } else {
                 std::cerr << " --> Error: Could not find register \"" << name << "\"" << std::endl;
             }
@@ -46,6 +46,7 @@ class Rd53aGlobalFeedback : public LoopActionBase, public GlobalFeedbackBase {
         std::vector<unsigned> m_pixelReg;
 
         void writePar();
+        void writePar(FrontEnd *fe);
         bool allDone();
         
         void init();
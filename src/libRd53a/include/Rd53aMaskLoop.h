@@ -38,9 +38,17 @@ class Rd53aMaskLoop : public LoopActionBase {
         void execPart1();
         void execPart2();
 
-	
-	bool ApplyMask(int col, int row);
-        
+
+        // Pixels written in one mask stage and their En/InjEn bits, compiled
+        // once in init() and applied to every FE
+        struct MaskStage {
+            std::vector<std::pair<unsigned, unsigned>> pixels;
+            std::vector<uint8_t> bits;
+        };
+        std::vector<MaskStage> m_stages;
+        unsigned m_stage;
+        void compileStages();
+
 	std::map<FrontEnd*, std::array<uint16_t, Rd53a::n_DC*Rd53a::n_Row>> m_pixRegs;
 	
 	//Needed for cross-talk mask
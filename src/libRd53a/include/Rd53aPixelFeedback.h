@@ -17,6 +17,7 @@
 
 #include "LoopActionBase.h"
 #include "FeedbackBase.h"
+#include "TdacModel.h"
 #include "Rd53a.h"
 
 class Rd53aPixelFeedback : public LoopActionBase, public PixelFeedbackBase {
@@ -27,6 +28,7 @@ class Rd53aPixelFeedback : public LoopActionBase, public PixelFeedbackBase {
         void loadConfig(json &j);
 
         void feedback(unsigned channel, Histo2d *h);
+        bool wantsDeviation() {return m_useModel;}
 
     protected:
     private:
@@ -34,9 +36,10 @@ class Rd53aPixelFeedback : public LoopActionBase, public PixelFeedbackBase {
         bool tuneLin;
         bool tuneDiff;
         bool m_resetTdac;
+        bool m_useModel;
         std::vector<unsigned> m_steps;
-
-        std::map<unsigned, Histo2d*> m_fb;
+        // Filled in init() when the model is used
+        std::map<unsigned, TdacModel> m_model;
 
         void addFeedback(unsigned ch);
         void writePixelCfg(Rd53a *fe);
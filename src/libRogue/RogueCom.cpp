@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <iostream>
 
 #include <RogueCom.h>
+#include <cstring>
 #include <memory>
 #include <unistd.h>
 void RogueSender::send(uint8_t *data,uint32_t size) {
@@ -162,6 +164,21 @@ void  RogueCom::write32(uint32_t value){
   txfifo[txfifo_cnt]=value;
   txfifo_cnt++;
 }
+void  RogueCom::writeBlock32(const uint32_t *buf, uint32_t length){
+  while(length>0){
+    if(txfifo_cnt>0 && txfifo_cnt+length>N_TXFIFO){
+      // does not fit anymore, send what is queued first, longer blocks
+      // go out in chunks of the fifo size
+      forceRelaseTxfifo=true;
+      releaseFifo();
+    }
+    uint32_t n=std::min(length,(uint32_t)N_TXFIFO-txfifo_cnt);
+    memcpy(&txfifo[txfifo_cnt],buf,sizeof(uint32_t)*n);
+    txfifo_cnt+=n;
+    buf+=n;
+    length-=n;
+  }
+}
 void  RogueCom::releaseFifo(){
   if(forceRelaseTxfifo || txfifo_cnt>2048){ 
     configStream->send((uint8_t*)txfifo,sizeof(uint32_t)*txfifo_cnt);
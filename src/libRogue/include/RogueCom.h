@@ -71,6 +71,7 @@ class RogueCom  {
   virtual uint32_t read32();
   virtual uint32_t readBlock32(uint32_t *buf, uint32_t length);
   virtual void write32(uint32_t);
+  virtual void writeBlock32(const uint32_t *buf, uint32_t length);
   virtual void releaseFifo();	
   void enableLane(uint32_t mask);
   void enableDebugStream(bool enable);
@@ -21,6 +21,7 @@ class RogueTxCore : virtual public TxCore {
 	std::shared_ptr<RogueCom> getCom() {return m_com;}
 
         void writeFifo(uint32_t value);
+        void writeFifoBlock(const uint32_t *words, size_t length) {m_com->writeBlock32(words, length);}
         void releaseFifo() {m_com->releaseFifo();} // Add some padding
 		void setForceRelaseTxfifo(bool enable=true) { m_com->setForceRelaseTxfifo(enable);}
         
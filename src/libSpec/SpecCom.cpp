@@ -86,7 +86,7 @@ uint32_t SpecCom::readSingle(uint32_t off) {
     return tmp; 
 }
 
-void SpecCom::write32(uint32_t off, uint32_t *val, size_t words) {
+void SpecCom::write32(uint32_t off, const uint32_t *val, size_t words) {
     this->write32(bar0, off, val, words);
 }
 
@@ -298,8 +298,9 @@ void SpecCom::writeBlock(void *bar, uint32_t off, uint32_t *val, size_t words) {
     }
 }
 
-void SpecCom::write32(void *bar, uint32_t off, uint32_t *val, size_t words) {
-    uint32_t *addr = (uint32_t*) bar+off;
+void SpecCom::write32(void *bar, uint32_t off, const uint32_t *val, size_t words) {
+    // Same address every time, volatile so no store is dropped
+    volatile uint32_t *addr = (uint32_t*) bar+off;
     for (uint32_t i=0; i<words; i++)
         *addr = val[i];
 }
@@ -22,6 +22,14 @@ void SpecTxCore::writeFifo(uint32_t value) {
     SpecCom::writeSingle(TX_ADDR | TX_FIFO, value);
 }
 
+void SpecTxCore::writeFifoBlock(const uint32_t *words, size_t length) {
+    if (verbose)
+        std::cout << __PRETTY_FUNCTION__ 
+            << " : Writing " << length << " words" << std::endl;
+    // All words go to the same FIFO address back to back
+    SpecCom::write32(TX_ADDR | TX_FIFO, words, length);
+}
+
 void SpecTxCore::setCmdEnable(uint32_t value) {
     uint32_t mask = (1 << value);
     if (verbose)
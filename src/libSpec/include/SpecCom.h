@@ -68,7 +68,7 @@ class SpecCom {
         void writeSingle(uint32_t off, uint32_t val);
         uint32_t readSingle(uint32_t off);
 
-        void write32(uint32_t off, uint32_t *val, size_t words = 1);
+        void write32(uint32_t off, const uint32_t *val, size_t words = 1);
         void read32(uint32_t off, uint32_t *val, size_t words = 1);
 
         void writeBlock(uint32_t off, uint32_t *val, size_t words);
@@ -98,7 +98,7 @@ class SpecCom {
         uint32_t read32(void *bar, uint32_t off);
         void mask32(void *bar, uint32_t off, uint32_t mask, uint32_t val);
 
-        void write32(void *bar, uint32_t off, uint32_t *val, size_t words);
+        void write32(void *bar, uint32_t off, const uint32_t *val, size_t words);
         void read32(void *bar, uint32_t off, uint32_t *val, size_t words);
 
         void writeBlock(void *bar, uint32_t off, uint32_t *val, size_t words);
@@ -58,6 +58,7 @@ class SpecTxCore : virtual public TxCore, virtual public SpecCom{
         void setVerbose(bool v=true);
 
         void writeFifo(uint32_t value);
+        void writeFifoBlock(const uint32_t *words, size_t length);
         void releaseFifo() {};
         
         void setCmdEnable(uint32_t value);
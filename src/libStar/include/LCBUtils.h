@@ -1,6 +1,8 @@
 #ifndef STAR_LCB_HEADER
 #define STAR_LCB_HEADER
 
+#include <cstdint>
+
 namespace SixEight {
 
   constexpr int count_bits(uint8_t d) {
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstdint>
 
 Histo1d::Histo1d(std::string arg_name, unsigned arg_bins, double arg_xlow, double arg_xhigh, std::type_index t) : HistogramBase(arg_name, t) {
     bins = arg_bins;
@@ -187,6 +188,64 @@ bool Histo1d::fromFile(std::string filename) {
     return true;
 }
 
+// Only non-empty bins are stored
+void Histo1d::toFileBinary(std::iostream &handle) {
+    this->toFileBinaryBase(handle);
+    writeBinary(handle, bins);
+    writeBinary(handle, xlow);
+    writeBinary(handle, xhigh);
+    writeBinary(handle, underflow);
+    writeBinary(handle, overflow);
+    writeBinary(handle, max);
+    writeBinary(handle, min);
+    writeBinary(handle, entries);
+    writeBinary(handle, sum);
+    uint32_t n = 0;
+    for (unsigned i=0; i<bins; i++)
+        n += (data[i] != 0);
+    writeBinary(handle, n);
+    for (uint32_t i=0; i<bins; i++) {
+        if (data[i] != 0) {
+            writeBinary(handle, i);
+            writeBinary(handle, data[i]);
+        }
+    }
+}
+
+bool Histo1d::fromFileBinary(std::iostream &handle) {
+    if (!this->fromFileBinaryBase(handle))
+        return false;
+    unsigned nBins = 0;
+    readBinary(handle, nBins);
+    readBinary(handle, xlow);
+    readBinary(handle, xhigh);
+    readBinary(handle, underflow);
+    readBinary(handle, overflow);
+    readBinary(handle, max);
+    readBinary(handle, min);
+    readBinary(handle, entries);
+    readBinary(handle, sum);
+    uint32_t n = 0;
+    readBinary(handle, n);
+    if (!checkBinary(handle, nBins, n, sizeof(uint32_t)+sizeof(double)))
+        return false;
+    bins = nBins;
+    binWidth = (xhigh - xlow)/bins;
+    delete[] data;
+    data = new double[bins];
+    for (unsigned i=0; i<bins; i++)
+        data[i] = 0;
+    for (unsigned k=0; k<n; k++) {
+        uint32_t i = 0;
+        double v = 0;
+        readBinary(handle, i);
+        readBinary(handle, v);
+        if (i < bins)
+            data[i] = v;
+    }
+    return (bool)handle;
+}
+
 void Histo1d::plot(std::string prefix, std::string dir) {
     std::cout << "Plotting: " << HistogramBase::name << std::endl;
     // Put raw histo data in tmp file
@@ -9,6 +9,7 @@
 #include "Histo2d.h"
 
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 
@@ -279,6 +280,77 @@ bool Histo2d::fromFile(std::string filename) {
     return true;
 }
 
+// Only non-empty bins are stored
+void Histo2d::toFileBinary(std::iostream &handle) {
+    this->toFileBinaryBase(handle);
+    writeBinary(handle, xbins);
+    writeBinary(handle, xlow);
+    writeBinary(handle, xhigh);
+    writeBinary(handle, ybins);
+    writeBinary(handle, ylow);
+    writeBinary(handle, yhigh);
+    writeBinary(handle, underflow);
+    writeBinary(handle, overflow);
+    writeBinary(handle, max);
+    writeBinary(handle, min);
+    writeBinary(handle, entries);
+    uint32_t n = 0;
+    for (unsigned i=0; i<xbins*ybins; i++)
+        n += (data[i] != 0);
+    writeBinary(handle, n);
+    for (uint32_t i=0; i<xbins*ybins; i++) {
+        if (data[i] != 0) {
+            writeBinary(handle, i);
+            writeBinary(handle, data[i]);
+        }
+    }
+}
+
+bool Histo2d::fromFileBinary(std::iostream &handle) {
+    if (!this->fromFileBinaryBase(handle))
+        return false;
+    unsigned nx = 0;
+    unsigned ny = 0;
+    readBinary(handle, nx);
+    readBinary(handle, xlow);
+    readBinary(handle, xhigh);
+    readBinary(handle, ny);
+    readBinary(handle, ylow);
+    readBinary(handle, yhigh);
+    readBinary(handle, underflow);
+    readBinary(handle, overflow);
+    readBinary(handle, max);
+    readBinary(handle, min);
+    readBinary(handle, entries);
+    uint32_t n = 0;
+    readBinary(handle, n);
+    if (!checkBinary(handle, (uint64_t)nx*ny, n, sizeof(uint32_t)+sizeof(double)))
+        return false;
+    xbins = nx;
+    ybins = ny;
+    xbinWidth = (xhigh - xlow)/xbins;
+    ybinWidth = (yhigh - ylow)/ybins;
+    delete[] data;
+    delete[] isFilled;
+    data = new double[xbins*ybins];
+    isFilled = new bool[xbins*ybins];
+    for (unsigned i=0; i<xbins*ybins; i++) {
+        data[i] = 0;
+        isFilled[i] = false;
+    }
+    for (unsigned k=0; k<n; k++) {
+        uint32_t i = 0;
+        double v = 0;
+        readBinary(handle, i);
+        readBinary(handle, v);
+        if (i < xbins*ybins) {
+            data[i] = v;
+            isFilled[i] = true;
+        }
+    }
+    return (bool)handle;
+}
+
 void Histo2d::plot(std::string prefix, std::string dir) {
     std::cout << "Plotting " << HistogramBase::name << std::endl;
     // Put raw histo data in tmp file
@@ -298,6 +298,81 @@ bool Histo3d::fromFile(std::string filename) {
     return true;
 }
 
+// Only non-empty bins are stored
+void Histo3d::toFileBinary(std::iostream &handle) {
+    this->toFileBinaryBase(handle);
+    writeBinary(handle, xbins);
+    writeBinary(handle, xlow);
+    writeBinary(handle, xhigh);
+    writeBinary(handle, ybins);
+    writeBinary(handle, ylow);
+    writeBinary(handle, yhigh);
+    writeBinary(handle, zbins);
+    writeBinary(handle, zlow);
+    writeBinary(handle, zhigh);
+    writeBinary(handle, underflow);
+    writeBinary(handle, overflow);
+    writeBinary(handle, max);
+    writeBinary(handle, min);
+    writeBinary(handle, entries);
+    uint32_t n = 0;
+    for (unsigned i=0; i<xbins*ybins*zbins; i++)
+        n += (data[i] != 0);
+    writeBinary(handle, n);
+    for (uint32_t i=0; i<xbins*ybins*zbins; i++) {
+        if (data[i] != 0) {
+            writeBinary(handle, i);
+            writeBinary(handle, data[i]);
+        }
+    }
+}
+
+bool Histo3d::fromFileBinary(std::iostream &handle) {
+    if (!this->fromFileBinaryBase(handle))
+        return false;
+    unsigned nx = 0;
+    unsigned ny = 0;
+    unsigned nz = 0;
+    readBinary(handle, nx);
+    readBinary(handle, xlow);
+    readBinary(handle, xhigh);
+    readBinary(handle, ny);
+    readBinary(handle, ylow);
+    readBinary(handle, yhigh);
+    readBinary(handle, nz);
+    readBinary(handle, zlow);
+    readBinary(handle, zhigh);
+    readBinary(handle, underflow);
+    readBinary(handle, overflow);
+    readBinary(handle, max);
+    readBinary(handle, min);
+    readBinary(handle, entries);
+    uint32_t n = 0;
+    readBinary(handle, n);
+    if (!checkBinary(handle, (uint64_t)nx*ny*nz, n, sizeof(uint32_t)+sizeof(uint16_t)))
+        return false;
+    xbins = nx;
+    ybins = ny;
+    zbins = nz;
+    xbinWidth = (xhigh - xlow)/xbins;
+    ybinWidth = (yhigh - ylow)/ybins;
+    zbinWidth = (zhigh - zlow)/zbins;
+    delete[] data;
+    data = new uint16_t[xbins*ybins*zbins];
+    for (unsigned i=0; i<xbins*ybins*zbins; i++)
+        data[i] = 0;
+    isFilled.clear();
+    for (unsigned k=0; k<n; k++) {
+        uint32_t i = 0;
+        uint16_t v = 0;
+        readBinary(handle, i);
+        readBinary(handle, v);
+        if (i < xbins*ybins*zbins)
+            data[i] = v;
+    }
+    return (bool)handle;
+}
+
 void Histo3d::plot(std::string prefix, std::string dir) {
     // Put raw histo data in tmp file
     std::string tmp_name = std::string(getenv("USER")) + "/tmp_yarr_histo2d_" + prefix;
@@ -0,0 +1,304 @@
+// #################################
+// # Project: Yarr
+// # Description: Dedicated s-curve fitter
+// # Comment: Levenberg-Marquardt with analytic Jacobian
+// ################################
+
+#include "ScurveFit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ScurveFit {
+
+const Control defaultControl = {100, 1e-6, false};
+
+namespace {
+    const double invSqrt2 = 0.70710678118654752;
+    const double invSqrt2Pi = 0.39894228040143268;
+
+    // Abramowitz & Stegun 7.1.26, absolute error below 1.5e-7. Only uses
+    // arithmetic and exp, so loops over lanes can be vectorised.
+    inline double fastErfc(double t) {
+        double a = std::fabs(t);
+        double k = 1.0/(1.0+0.3275911*a);
+        double e = k*(0.254829592+k*(-0.284496736+k*(1.421413741+k*(-1.453152027+k*1.061405429))))*std::exp(-a*a);
+        return t < 0 ? 2.0-e : e;
+    }
+
+    inline double cdf(double z) {
+        return 0.5*fastErfc(-z*invSqrt2);
+    }
+
+    // Variance of the data assuming binomial statistics, at least one hit so
+    // that bins on the plateaus do not dominate
+    inline double variance(double f, double norm) {
+        double v = f*(1.0-f/norm);
+        return v > 1.0 ? v : 1.0;
+    }
+
+    // Gaussian elimination with partial pivoting on the first np rows
+    bool solve(unsigned np, double a[n_par][n_par], double *b, double *d) {
+        for (unsigned k=0; k<np; k++) {
+            unsigned piv = k;
+            for (unsigned i=k+1; i<np; i++) {
+                if (std::fabs(a[i][k]) > std::fabs(a[piv][k]))
+                    piv = i;
+            }
+            if (a[piv][k] == 0)
+                return false;
+            if (piv != k) {
+                for (unsigned j=0; j<np; j++)
+                    std::swap(a[k][j], a[piv][j]);
+                std::swap(b[k], b[piv]);
+            }
+            for (unsigned i=k+1; i<np; i++) {
+                double f = a[i][k]/a[k][k];
+                for (unsigned j=k; j<np; j++)
+                    a[i][j] -= f*a[k][j];
+                b[i] -= f*b[k];
+            }
+        }
+        for (int i=np-1; i>=0; i--) {
+            double sum = b[i];
+            for (unsigned j=i+1; j<np; j++)
+                sum -= a[i][j]*d[j];
+            d[i] = sum/a[i][i];
+        }
+        return true;
+    }
+
+    // Sum of squared residuals for w lanes, yt is stored as [point][lane]
+    void sumOfSquares(unsigned w, unsigned n, const double *x, const double *yt,
+            const double *mu, const double *sig, const double *norm, double *sum) {
+        for (unsigned l=0; l<w; l++)
+            sum[l] = 0;
+        for (unsigned i=0; i<n; i++) {
+            for (unsigned l=0; l<w; l++) {
+                double r = yt[i*w+l] - norm[l]*cdf((x[i]-mu[l])/sig[l]);
+                sum[l] += r*r;
+            }
+        }
+    }
+
+    // Advances up to 'lanes' fits in lockstep
+    void fitBlock(unsigned nl, unsigned n, const double *x, const double *y, double *par, const Control &c, Status *s) {
+        const unsigned np = c.fixNorm ? 2 : 3;
+        // A single fit does not pay for the padding
+        const unsigned w = (nl == 1) ? 1 : lanes;
+        std::vector<double> yt(n*w);
+        double mu[lanes], sig[lanes], norm[lanes];
+        double tmu[lanes], tsig[lanes], tnorm[lanes];
+        double sum[lanes], tsum[lanes], lambda[lanes];
+        double jtj[6][lanes], jtr[n_par][lanes];
+        double step[lanes];
+        bool active[lanes];
+
+        // Unused lanes are padded with a copy of the first fit
+        for (unsigned l=0; l<w; l++) {
+            unsigned src = (l < nl) ? l : 0;
+            mu[l] = par[src*n_par+0];
+            sig[l] = std::fabs(par[src*n_par+1]);
+            norm[l] = par[src*n_par+2];
+            lambda[l] = 1e-3;
+            active[l] = (l < nl);
+            for (unsigned i=0; i<n; i++)
+                yt[i*w+l] = y[src*n+i];
+            if (l < nl) {
+                s[l].nIter = 0;
+                s[l].outcome = 5;
+            }
+        }
+
+        sumOfSquares(w, n, x, &yt[0], mu, sig, norm, sum);
+        for (unsigned l=0; l<nl; l++) {
+            if (sum[l] == 0) {
+                s[l].outcome = 0;
+                active[l] = false;
+            }
+        }
+
+        for (unsigned iter=0; iter<c.maxIter; iter++) {
+            // Normal equations from the analytic Jacobian
+            for (unsigned l=0; l<w; l++) {
+                for (unsigned k=0; k<6; k++)
+                    jtj[k][l] = 0;
+                for (unsigned k=0; k<n_par; k++)
+                    jtr[k][l] = 0;
+            }
+            for (unsigned i=0; i<n; i++) {
+                for (unsigned l=0; l<w; l++) {
+                    double z = (x[i]-mu[l])/sig[l];
+                    double p = cdf(z);
+                    double g = invSqrt2Pi*std::exp(-0.5*z*z);
+                    double r = yt[i*w+l] - norm[l]*p;
+                    double dMu = -norm[l]*g/sig[l];
+                    double dSig = dMu*z;
+                    double dNorm = p;
+                    jtj[0][l] += dMu*dMu;
+                    jtj[1][l] += dMu*dSig;
+                    jtj[2][l] += dMu*dNorm;
+                    jtj[3][l] += dSig*dSig;
+                    jtj[4][l] += dSig*dNorm;
+                    jtj[5][l] += dNorm*dNorm;
+                    jtr[0][l] += dMu*r;
+                    jtr[1][l] += dSig*r;
+                    jtr[2][l] += dNorm*r;
+                }
+            }
+
+            // Damped step per lane
+            for (unsigned l=0; l<w; l++) {
+                tmu[l] = mu[l];
+                tsig[l] = sig[l];
+                tnorm[l] = norm[l];
+                step[l] = 0;
+                if (!active[l])
+                    continue;
+                double a[n_par][n_par] = {{jtj[0][l], jtj[1][l], jtj[2][l]},
+                                          {jtj[1][l], jtj[3][l], jtj[4][l]},
+                                          {jtj[2][l], jtj[4][l], jtj[5][l]}};
+                double b[n_par] = {jtr[0][l], jtr[1][l], jtr[2][l]};
+                double d[n_par] = {0, 0, 0};
+                for (unsigned k=0; k<np; k++)
+                    a[k][k] *= (1.0+lambda[l]);
+                if (!solve(np, a, b, d))
+                    continue;
+                tmu[l] = mu[l] + d[0];
+                tsig[l] = sig[l] + d[1];
+                tnorm[l] = norm[l] + d[2];
+                step[l] = std::max(std::fabs(d[0])/(std::fabs(mu[l])+c.tol),
+                        std::fabs(d[1])/(std::fabs(sig[l])+c.tol));
+                if (np == 3)
+                    step[l] = std::max(step[l], std::fabs(d[2])/(std::fabs(norm[l])+c.tol));
+                // Width has to stay positive
+                if (tsig[l] <= 0)
+                    tsig[l] = 0.5*sig[l];
+            }
+
+            sumOfSquares(w, n, x, &yt[0], tmu, tsig, tnorm, tsum);
+
+            bool any = false;
+            for (unsigned l=0; l<nl; l++) {
+                if (!active[l])
+                    continue;
+                s[l].nIter = iter+1;
+                if (tsum[l] < sum[l]) {
+                    double change = sum[l]-tsum[l];
+                    mu[l] = tmu[l];
+                    sig[l] = tsig[l];
+                    norm[l] = tnorm[l];
+                    lambda[l] = std::max(lambda[l]*0.1, 1e-12);
+                    bool fConv = (change <= c.tol*sum[l]);
+                    bool pConv = (step[l] <= c.tol);
+                    sum[l] = tsum[l];
+                    if (fConv || pConv) {
+                        s[l].outcome = (fConv && pConv) ? 3 : (fConv ? 1 : 2);
+                        active[l] = false;
+                    }
+                } else {
+                    lambda[l] *= 10;
+                    if (lambda[l] > 1e12) {
+                        s[l].outcome = 6;
+                        active[l] = false;
+                    }
+                }
+                any |= active[l];
+            }
+            if (!any)
+                break;
+        }
+
+        for (unsigned l=0; l<nl; l++) {
+            par[l*n_par+0] = mu[l];
+            par[l*n_par+1] = sig[l];
+            par[l*n_par+2] = norm[l];
+            s[l].chi2 = chi2(n, x, y+l*n, par+l*n_par, np);
+        }
+    }
+}
+
+double chi2(unsigned n, const double *x, const double *y, const double *par, unsigned np) {
+    double sum = 0;
+    for (unsigned i=0; i<n; i++) {
+        double f = par[2]*cdf((x[i]-par[0])/par[1]);
+        double r = y[i] - f;
+        sum += r*r/variance(f, par[2]);
+    }
+    return (n > np) ? sum/(double)(n-np) : sum;
+}
+
+double eval(double x, const double *par) {
+    return 0.5*std::erfc(-(x-par[0])/par[1]*invSqrt2)*par[2];
+}
+
+void guess(unsigned n, const double *x, const double *y, double norm, double *par) {
+    par[0] = 0.5*(x[0]+x[n-1]);
+    par[1] = (n > 1) ? (x[n-1]-x[0])/10.0 : 1.0;
+    par[2] = norm;
+    if (n < 2)
+        return;
+
+    double half = 0.5*norm;
+    if (y[0] >= half) {
+        par[0] = x[0];
+        return;
+    }
+    for (unsigned k=1; k<n; k++) {
+        if (y[k] >= half && y[k-1] < half) {
+            double dx = x[k]-x[k-1];
+            double dy = y[k]-y[k-1];
+            par[0] = x[k-1] + (half-y[k-1])/dy*dx;
+            // Largest slope of the model is norm/(sigma*sqrt(2pi))
+            par[1] = norm*invSqrt2Pi/(dy/dx);
+            if (par[1] < 0.1*dx)
+                par[1] = 0.1*dx;
+            return;
+        }
+    }
+    par[0] = x[n-1];
+}
+
+void fit(unsigned n, const double *x, const double *y, double *par, const Control &c, Status &s) {
+    fitBlock(1, n, x, y, par, c, &s);
+}
+
+void fitBatch(unsigned nFits, unsigned n, const double *x, const double *y, double *par, const Control &c, Status *s) {
+    for (unsigned first=0; first<nFits; first+=lanes) {
+        unsigned nl = std::min(lanes, nFits-first);
+        fitBlock(nl, n, x, y+first*n, par+first*n_par, c, s+first);
+    }
+}
+
+void errors(unsigned n, const double *x, const double *par, double *err) {
+    double a[n_par][n_par] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    for (unsigned i=0; i<n; i++) {
+        double z = (x[i]-par[0])/par[1];
+        double p = cdf(z);
+        double g = invSqrt2Pi*std::exp(-0.5*z*z);
+        double j[n_par] = {-par[2]*g/par[1], -par[2]*g*z/par[1], p};
+        double w = 1.0/variance(par[2]*p, par[2]);
+        for (unsigned r=0; r<n_par; r++)
+            for (unsigned c=0; c<n_par; c++)
+                a[r][c] += w*j[r]*j[c];
+    }
+    // Diagonal of the inverse, one column at a time
+    for (unsigned k=0; k<n_par; k++) {
+        double m[n_par][n_par];
+        for (unsigned r=0; r<n_par; r++)
+            for (unsigned c=0; c<n_par; c++)
+                m[r][c] = a[r][c];
+        double b[n_par] = {0, 0, 0};
+        double d[n_par] = {0, 0, 0};
+        b[k] = 1;
+        if (solve(n_par, m, b, d) && d[k] > 0) {
+            err[k] = std::sqrt(d[k]);
+        } else {
+            err[k] = std::numeric_limits<double>::infinity();
+        }
+    }
+}
+
+}
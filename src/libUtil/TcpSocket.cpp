@@ -0,0 +1,143 @@
+// #################################
+// # Project: Yarr
+// # Description: Blocking TCP stream socket
+// # Comment: send() and recv() always move the whole buffer
+// ################################
+
+#include "TcpSocket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+TcpSocket::TcpSocket() {
+    fd = -1;
+}
+
+TcpSocket::TcpSocket(int arg_fd) {
+    fd = arg_fd;
+    this->noDelay();
+}
+
+TcpSocket::~TcpSocket() {
+    this->close();
+}
+
+bool TcpSocket::connect(const std::string &host, unsigned port) {
+    this->close();
+    struct addrinfo hints, *res, *ressave;
+    memset(&hints, 0, sizeof(struct addrinfo));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    int n = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res);
+    if (n != 0) {
+        std::cerr << "#ERROR# Could not resolve host '" << host << "': " << gai_strerror(n) << std::endl;
+        return false;
+    }
+
+    ressave = res;
+    while (res) {
+        fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (fd >= 0) {
+            if (::connect(fd, res->ai_addr, res->ai_addrlen) == 0)
+                break;
+            ::close(fd);
+            fd = -1;
+        }
+        res = res->ai_next;
+    }
+    freeaddrinfo(ressave);
+
+    if (fd < 0) {
+        std::cerr << "#ERROR# Could not connect to " << host << ":" << port << std::endl;
+        return false;
+    }
+    this->noDelay();
+    return true;
+}
+
+bool TcpSocket::listen(unsigned port, bool loopbackOnly) {
+    this->close();
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "#ERROR# Could not create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(fd, 4) != 0) {
+        std::cerr << "#ERROR# Could not listen on port " << port << ": " << strerror(errno) << std::endl;
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<TcpSocket> TcpSocket::accept() {
+    int client = ::accept(fd, nullptr, nullptr);
+    if (client < 0)
+        return nullptr;
+    return std::unique_ptr<TcpSocket>(new TcpSocket(client));
+}
+
+unsigned TcpSocket::getPort() {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (getsockname(fd, (struct sockaddr*)&addr, &len) != 0)
+        return 0;
+    return ntohs(addr.sin_port);
+}
+
+bool TcpSocket::send(const void *buf, size_t length) {
+    const char *p = (const char*)buf;
+    while (length > 0) {
+        ssize_t n = ::send(fd, p, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+bool TcpSocket::recv(void *buf, size_t length) {
+    char *p = (char*)buf;
+    while (length > 0) {
+        ssize_t n = ::recv(fd, p, length, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+void TcpSocket::close() {
+    if (fd < 0)
+        return;
+    shutdown(fd, SHUT_RDWR);
+    ::close(fd);
+    fd = -1;
+}
+
+void TcpSocket::noDelay() {
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
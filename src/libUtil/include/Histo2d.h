@@ -43,6 +43,7 @@ class Histo2d : public HistogramBase {
         
         double getBin(unsigned n) const;
         int binNum(double x, double y);
+        double* getData() { return data;};
         
         double getUnderflow() {return underflow;}
         double getOverflow() {return overflow;}
@@ -61,6 +62,8 @@ class Histo2d : public HistogramBase {
         
         void toFile(std::string filename, std::string dir = "", bool header=true);
         bool fromFile(std::string filename);
+        void toFileBinary(std::iostream &handle);
+        bool fromFileBinary(std::iostream &handle);
         void plot(std::string filename, std::string dir = "");
 
     private:
@@ -69,6 +69,8 @@ class Histo3d : public HistogramBase {
         
         void toFile(std::string filename, std::string dir = "", bool header=true);
         bool fromFile(std::string filename);
+        void toFileBinary(std::iostream &handle);
+        bool fromFileBinary(std::iostream &handle);
         void plot(std::string filename, std::string dir = "");
 
     private:
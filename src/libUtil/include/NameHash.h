@@ -0,0 +1,64 @@
+#ifndef NAMEHASH_H
+#define NAMEHASH_H
+
+// #################################
+// # Project: Yarr
+// # Description: Compile time hashed name tables
+// # Comment: Tables of entries with a name and its hash are sorted by
+// #          hash at compile time and searched by binary search
+// ################################
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace NameHash {
+    // FNV-1a
+    constexpr uint32_t hash(const char *s) {
+        uint32_t h = 2166136261u;
+        while (*s != '\0') {
+            h ^= (uint8_t)*s++;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // Indices of the entries ordered by hash
+    template<typename T, size_t N>
+    constexpr std::array<uint16_t, N> order(const T (&table)[N]) {
+        std::array<uint16_t, N> idx{};
+        for (size_t i=0; i<N; i++) {
+            size_t j = i;
+            while (j > 0 && table[idx[j-1]].hash > table[i].hash) {
+                idx[j] = idx[j-1];
+                j--;
+            }
+            idx[j] = i;
+        }
+        return idx;
+    }
+
+    // Index of the entry with this name, -1 if there is none
+    template<typename T, size_t N>
+    int find(const T (&table)[N], const std::array<uint16_t, N> &idx, const std::string &name) {
+        uint32_t h = hash(name.c_str());
+        size_t lo = 0;
+        size_t hi = N;
+        while (lo < hi) {
+            size_t mid = (lo+hi)/2;
+            if (table[idx[mid]].hash < h) {
+                lo = mid+1;
+            } else {
+                hi = mid;
+            }
+        }
+        for (; lo<N && table[idx[lo]].hash == h; lo++) {
+            if (strcmp(table[idx[lo]].name, name.c_str()) == 0)
+                return idx[lo];
+        }
+        return -1;
+    }
+}
+
+#endif
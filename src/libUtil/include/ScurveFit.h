@@ -0,0 +1,48 @@
+#ifndef SCURVEFIT_H
+#define SCURVEFIT_H
+
+// #################################
+// # Project: Yarr
+// # Description: Dedicated s-curve fitter
+// # Comment: Levenberg-Marquardt with analytic Jacobian for
+// #          f(x) = 0.5*erfc(-(x-par[0])/(par[1]*sqrt(2)))*par[2]
+// #          par[0] = Mean, par[1] = Sigma, par[2] = Normalisation
+// ################################
+
+namespace ScurveFit {
+    const unsigned n_par = 3;
+    // Number of fits advanced in lockstep by fitBatch
+    const unsigned lanes = 8;
+
+    struct Control {
+        unsigned maxIter;   // Maximum number of iterations
+        double tol;         // Relative change of sum of squares or parameters to stop at
+        bool fixNorm;       // Keep par[2] at its start value
+    };
+    extern const Control defaultControl;
+
+    struct Status {
+        double chi2;        // Chi2/ndf assuming binomial errors on the data
+        unsigned nIter;     // Number of iterations
+        int outcome;        // Same meaning as lm_infmsg
+    };
+
+    double eval(double x, const double *par);
+
+    // Start values from the 50% crossing and the slope around it
+    void guess(unsigned n, const double *x, const double *y, double norm, double *par);
+
+    // Fits use par as start values and return the result in there
+    void fit(unsigned n, const double *x, const double *y, double *par, const Control &c, Status &s);
+
+    // y and par hold nFits consecutive data sets and parameter triplets
+    void fitBatch(unsigned nFits, unsigned n, const double *x, const double *y, double *par, const Control &c, Status *s);
+
+    // Chi2/ndf of par on the data assuming binomial errors, np free parameters
+    double chi2(unsigned n, const double *x, const double *y, const double *par, unsigned np = n_par);
+
+    // Parameter uncertainties from the Jacobian at par, binomial errors on the data
+    void errors(unsigned n, const double *x, const double *par, double *err);
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TCPSOCKET_H
+#define TCPSOCKET_H
+
+// #################################
+// # Project: Yarr
+// # Description: Blocking TCP stream socket
+// # Comment: send() and recv() always move the whole buffer
+// ################################
+
+#include <memory>
+#include <string>
+
+class TcpSocket {
+    public:
+        TcpSocket();
+        ~TcpSocket();
+
+        // Client side
+        bool connect(const std::string &host, unsigned port);
+        // Server side, port 0 picks a free port, see getPort()
+        bool listen(unsigned port, bool loopbackOnly = false);
+        std::unique_ptr<TcpSocket> accept();
+        unsigned getPort();
+
+        bool send(const void *buf, size_t length);
+        bool recv(void *buf, size_t length);
+
+        // Also wakes up a thread blocked in recv() or accept()
+        void close();
+        bool isOpen() {return fd >= 0;}
+
+    private:
+        TcpSocket(int arg_fd);
+        // Small messages go out at once instead of being collected
+        void noDelay();
+
+        int fd;
+};
+
+#endif
@@ -28,6 +28,10 @@ namespace AllStdActionsRegistry {
   bool param_loop_registered =
     registerLoopAction("StdParameterLoop",
                        []() { return std::unique_ptr<LoopActionBase>(new StdParameterLoop); });
+
+  bool adaptive_param_loop_registered =
+    registerLoopAction("StdAdaptiveParameterLoop",
+                       []() { return std::unique_ptr<LoopActionBase>(new StdAdaptiveParameterLoop); });
   
 }
 
@@ -42,7 +42,6 @@ void Bookkeeper::addFe(FrontEnd *fe, unsigned txChannel, unsigned rxChannel) {
         feList.back()->clipData = &eventMap[rxChannel];
         feList.back()->clipHisto = &histoMap[rxChannel];
         feList.back()->clipResult = &resultMap[rxChannel];
-        mutexMap[rxChannel];
     }
     std::cout << __PRETTY_FUNCTION__ << " -> Added FE: Tx(" << txChannel << "), Rx(" << rxChannel << ")" << std::endl;
 }
@@ -62,10 +61,8 @@ void Bookkeeper::delFe(unsigned rxChannel) {
                 feList.erase(feList.begin() + k);
             }
         }
-        mutexMap.erase(rxChannel);
         histoMap.erase(rxChannel);
         resultMap.erase(rxChannel);
-        mutexMap.erase(rxChannel);
     }
 }
 
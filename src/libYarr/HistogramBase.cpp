@@ -8,6 +8,8 @@
 
 #include "HistogramBase.h"
 
+#include <cstdint>
+
 HistogramBase::HistogramBase(std::string arg_name, std::type_index t, LoopStatus &stat) : type(typeid(void)){
     name = arg_name;
     xAxisTitle = "x";
@@ -62,3 +64,78 @@ void HistogramBase::setYaxisTitle(std::string name) {
 void HistogramBase::setZaxisTitle(std::string name) {
     zAxisTitle = name;
 }
+
+namespace {
+    std::streamoff streamLeft(std::iostream &handle) {
+        std::streamoff pos = handle.tellg();
+        if (pos < 0)
+            return -1;
+        handle.seekg(0, std::ios::end);
+        std::streamoff end = handle.tellg();
+        handle.seekg(pos);
+        if (end < pos)
+            return -1;
+        return end-pos;
+    }
+
+    void writeString(std::iostream &handle, const std::string &str) {
+        uint32_t len = str.size();
+        handle.write((const char*)&len, sizeof(len));
+        handle.write(str.data(), len);
+    }
+
+    bool readString(std::iostream &handle, std::string &str) {
+        uint32_t len = 0;
+        handle.read((char*)&len, sizeof(len));
+        if (!handle)
+            return false;
+        std::streamoff left = streamLeft(handle);
+        if (len > (1u << 16) || (left >= 0 && len > left))
+            return false;
+        str.resize(len);
+        handle.read(&str[0], len);
+        return (bool)handle;
+    }
+}
+
+void HistogramBase::toFileBinaryBase(std::iostream &handle) {
+    writeString(handle, name);
+    writeString(handle, xAxisTitle);
+    writeString(handle, yAxisTitle);
+    writeString(handle, zAxisTitle);
+    uint32_t n = lStat.size();
+    writeBinary(handle, n);
+    for (unsigned i=0; i<n; i++) {
+        uint32_t v = lStat.get(i);
+        writeBinary(handle, v);
+    }
+}
+
+bool HistogramBase::fromFileBinaryBase(std::iostream &handle) {
+    if (!readString(handle, name) || !readString(handle, xAxisTitle)
+            || !readString(handle, yAxisTitle) || !readString(handle, zAxisTitle))
+        return false;
+    uint32_t n = 0;
+    readBinary(handle, n);
+    if (!checkBinary(handle, 1, n, sizeof(uint32_t)) || n > 64)
+        return false;
+    lStat = LoopStatus();
+    lStat.init(n);
+    for (unsigned i=0; i<n; i++) {
+        uint32_t v = 0;
+        readBinary(handle, v);
+        lStat.set(i, v);
+    }
+    return (bool)handle;
+}
+
+std::streamoff HistogramBase::bytesLeft(std::iostream &handle) {
+    return streamLeft(handle);
+}
+
+bool HistogramBase::checkBinary(std::iostream &handle, uint64_t nBins, uint32_t nEntries, size_t entrySize) {
+    if (!handle || nBins == 0 || nBins > maxBinaryBins)
+        return false;
+    std::streamoff left = bytesLeft(handle);
+    return (left < 0 || (uint64_t)nEntries*entrySize <= (uint64_t)left);
+}
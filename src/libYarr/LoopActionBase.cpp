@@ -5,8 +5,16 @@
  */
 
 #include "LoopActionBase.h"
+#include <future>
 #include <iostream>
 
+namespace {
+    std::future<void>& pendingDrain() {
+        static std::future<void> drain;
+        return drain;
+    }
+}
+
 LoopActionBase::LoopActionBase() : loopType(typeid(void)){
     g_fe = NULL;
     g_tx = NULL;
@@ -93,3 +101,14 @@ bool LoopActionBase::checkGlobalDone() {
 	return g_done;
 
 }
+
+void LoopActionBase::drainInBackground(std::function<void()> drain) {
+    waitDrained();
+    pendingDrain() = std::async(std::launch::async, drain);
+}
+
+void LoopActionBase::waitDrained() {
+    std::future<void> &drain = pendingDrain();
+    if (drain.valid())
+        drain.get();
+}
@@ -0,0 +1,266 @@
+// #################################
+// # Project: Yarr
+// # Description: Several controllers driven as one
+// # Comment: Channels are numbered across controllers, channel c of
+// #          controller k is k*channelStride+c
+// ################################
+
+#include "MultiController.h"
+
+#include <iostream>
+#include <stdexcept>
+
+MultiController::MultiController() {
+    m_waitTime = std::chrono::microseconds(0);
+}
+
+MultiController::~MultiController() {
+}
+
+void MultiController::addController(std::unique_ptr<HwController> ctrl) {
+    // Data is only complete once the slowest controller delivered it
+    if (ctrl->getWaitTime() > m_waitTime)
+        m_waitTime = ctrl->getWaitTime();
+    ctrls.push_back(std::move(ctrl));
+    cmdActive.push_back(true);
+}
+
+void MultiController::loadConfig(json &j) {
+    for (unsigned k=0; k<ctrls.size() && k<j.size(); k++)
+        ctrls[k]->loadConfig(j[k]);
+}
+
+void MultiController::setupMode() {
+    for (auto &ctrl : ctrls)
+        ctrl->setupMode();
+}
+
+void MultiController::runMode() {
+    for (auto &ctrl : ctrls)
+        ctrl->runMode();
+}
+
+std::map<unsigned, std::vector<uint32_t>> MultiController::split(const std::vector<uint32_t> &channels) {
+    std::map<unsigned, std::vector<uint32_t>> local;
+    for (uint32_t channel : channels) {
+        if (ctrlOf(channel) >= ctrls.size()) {
+            std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : channel " << channel
+                << " belongs to controller " << ctrlOf(channel) << ", only " << ctrls.size() << " loaded" << std::endl;
+            continue;
+        }
+        local[ctrlOf(channel)].push_back(localOf(channel));
+    }
+    return local;
+}
+
+void MultiController::writeFifo(uint32_t value) {
+    for (unsigned k=0; k<ctrls.size(); k++) {
+        if (cmdActive[k])
+            ctrls[k]->writeFifo(value);
+    }
+}
+
+void MultiController::writeFifoBlock(const uint32_t *words, size_t length) {
+    for (unsigned k=0; k<ctrls.size(); k++) {
+        if (cmdActive[k])
+            ctrls[k]->writeFifoBlock(words, length);
+    }
+}
+
+void MultiController::releaseFifo() {
+    for (unsigned k=0; k<ctrls.size(); k++) {
+        if (cmdActive[k])
+            ctrls[k]->releaseFifo();
+    }
+}
+
+void MultiController::setCmdEnable(uint32_t channel) {
+    this->setCmdEnable(std::vector<uint32_t>({channel}));
+}
+
+void MultiController::setCmdEnable(std::vector<uint32_t> channels) {
+    std::map<unsigned, std::vector<uint32_t>> local = this->split(channels);
+    for (unsigned k=0; k<ctrls.size(); k++) {
+        cmdActive[k] = local.find(k) != local.end();
+        if (cmdActive[k])
+            ctrls[k]->setCmdEnable(local[k]);
+    }
+}
+
+uint32_t MultiController::getCmdEnable() {
+    if (ctrls.empty())
+        return 0;
+    return ctrls[0]->getCmdEnable();
+}
+
+bool MultiController::isCmdEmpty() {
+    for (auto &ctrl : ctrls) {
+        if (!ctrl->isCmdEmpty())
+            return false;
+    }
+    return true;
+}
+
+uint64_t MultiController::submit() {
+    std::lock_guard<std::mutex> lk(fenceMtx);
+    uint64_t token = ++m_fenceSubmitted;
+    std::vector<uint64_t> &sub = fences[token];
+    for (auto &ctrl : ctrls)
+        sub.push_back(ctrl->submit());
+    return token;
+}
+
+void MultiController::wait(uint64_t token) {
+    if (m_fenceDone >= token)
+        return;
+    std::vector<uint64_t> sub;
+    {
+        std::lock_guard<std::mutex> lk(fenceMtx);
+        auto it = fences.find(token);
+        // Already waited for by someone else
+        if (it == fences.end())
+            return;
+        sub = it->second;
+    }
+    for (unsigned k=0; k<ctrls.size(); k++)
+        ctrls[k]->wait(sub[k]);
+    this->fenceDone(token);
+
+    std::lock_guard<std::mutex> lk(fenceMtx);
+    fences.erase(fences.begin(), fences.upper_bound(token));
+}
+
+void MultiController::setTrigEnable(uint32_t value) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTrigEnable(value);
+}
+
+uint32_t MultiController::getTrigEnable() {
+    uint32_t value = 0;
+    for (auto &ctrl : ctrls)
+        value |= ctrl->getTrigEnable();
+    return value;
+}
+
+void MultiController::maskTrigEnable(uint32_t value, uint32_t mask) {
+    for (auto &ctrl : ctrls)
+        ctrl->maskTrigEnable(value, mask);
+}
+
+bool MultiController::isTrigDone() {
+    for (auto &ctrl : ctrls) {
+        if (!ctrl->isTrigDone())
+            return false;
+    }
+    return true;
+}
+
+void MultiController::setTrigConfig(enum TRIG_CONF_VALUE cfg) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTrigConfig(cfg);
+}
+
+void MultiController::setTrigFreq(double freq) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTrigFreq(freq);
+}
+
+void MultiController::setTrigCnt(uint32_t count) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTrigCnt(count);
+}
+
+void MultiController::setTrigTime(double time) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTrigTime(time);
+}
+
+void MultiController::setTrigWordLength(uint32_t length) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTrigWordLength(length);
+}
+
+void MultiController::setTrigWord(uint32_t *word, uint32_t length) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTrigWord(word, length);
+}
+
+void MultiController::toggleTrigAbort() {
+    for (auto &ctrl : ctrls)
+        ctrl->toggleTrigAbort();
+}
+
+void MultiController::setTriggerLogicMask(uint32_t mask) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTriggerLogicMask(mask);
+}
+
+void MultiController::setTriggerLogicMode(enum TRIG_LOGIC_MODE_VALUE mode) {
+    for (auto &ctrl : ctrls)
+        ctrl->setTriggerLogicMode(mode);
+}
+
+void MultiController::resetTriggerLogic() {
+    for (auto &ctrl : ctrls)
+        ctrl->resetTriggerLogic();
+}
+
+uint32_t MultiController::getTrigInCount() {
+    // Every controller sees the same external triggers
+    if (ctrls.empty())
+        return 0;
+    return ctrls[0]->getTrigInCount();
+}
+
+void MultiController::setRxEnable(uint32_t channel) {
+    this->setRxEnable(std::vector<uint32_t>({channel}));
+}
+
+void MultiController::setRxEnable(std::vector<uint32_t> channels) {
+    std::map<unsigned, std::vector<uint32_t>> local = this->split(channels);
+    for (unsigned k=0; k<ctrls.size(); k++)
+        ctrls[k]->setRxEnable(local[k]);
+}
+
+void MultiController::maskRxEnable(uint32_t value, uint32_t mask) {
+    for (unsigned k=0; k<ctrls.size(); k++) {
+        if (k == 0)
+            ctrls[k]->maskRxEnable(value, mask);
+        else
+            ctrls[k]->maskRxEnable(0, mask);
+    }
+}
+
+RawData* MultiController::readData() {
+    if (ctrls.size() == 1)
+        return ctrls[0]->readData();
+    // The data does not say which controller it came from
+    throw std::runtime_error("MultiController::readData: read the controllers one by one with getController()");
+}
+
+void MultiController::flushBuffer() {
+    for (auto &ctrl : ctrls)
+        ctrl->flushBuffer();
+}
+
+uint32_t MultiController::getDataRate() {
+    uint32_t rate = 0;
+    for (auto &ctrl : ctrls)
+        rate += ctrl->getDataRate();
+    return rate;
+}
+
+uint32_t MultiController::getCurCount() {
+    uint32_t count = 0;
+    for (auto &ctrl : ctrls)
+        count += ctrl->getCurCount();
+    return count;
+}
+
+bool MultiController::isBridgeEmpty() {
+    for (auto &ctrl : ctrls) {
+        if (!ctrl->isBridgeEmpty())
+            return false;
+    }
+    return true;
+}
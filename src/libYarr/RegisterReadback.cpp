@@ -0,0 +1,185 @@
+// #################################
+// # Project: Yarr
+// # Description: Reads back the global registers of many FEs at once
+// # Comment: Reads are sent back to back in batches, the answers are
+// #          collected from the rx stream and matched by channel and address
+// ################################
+
+#include "RegisterReadback.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "MultiController.h"
+#include "TxBroadcaster.h"
+
+RegisterReadback::RegisterReadback(TxCore *arg_tx, RxCore *arg_rx) {
+    tx = arg_tx;
+    rx = arg_rx;
+    timeout = 100;
+    batch = 8;
+}
+
+std::map<unsigned, std::map<unsigned, uint16_t>> RegisterReadback::read(const std::vector<FrontEnd*> &fes, const std::vector<unsigned> &addrs) {
+    std::map<unsigned, std::map<unsigned, uint16_t>> values;
+    if (fes.empty() || addrs.empty())
+        return values;
+
+    // The channels share the stream in ascending order
+    std::vector<unsigned> rxChannels;
+    for (FrontEnd *fe : fes)
+        rxChannels.push_back(dynamic_cast<FrontEndCfg*>(fe)->getRxChannel());
+    std::sort(rxChannels.begin(), rxChannels.end());
+    rxChannels.erase(std::unique(rxChannels.begin(), rxChannels.end()), rxChannels.end());
+    rx->setRxEnable(std::vector<uint32_t>(rxChannels.begin(), rxChannels.end()));
+
+    // Every controller has its own stream with its own channel numbers
+    struct Stream {
+        RxCore *rx;
+        unsigned ctrl;
+        std::vector<unsigned> channels;
+        std::vector<uint32_t> words;
+        unsigned pos;
+        std::map<unsigned, std::map<unsigned, uint16_t>> values;
+    };
+    std::vector<Stream> streams;
+    MultiController *multi = dynamic_cast<MultiController*>(rx);
+    if (multi == nullptr) {
+        streams.push_back({rx, 0, rxChannels, {}, 0, {}});
+    } else {
+        for (unsigned ch : rxChannels) {
+            unsigned k = MultiController::ctrlOf(ch);
+            if (streams.empty() || streams.back().ctrl != k)
+                streams.push_back({multi->getController(k), k, {}, {}, 0, {}});
+            streams.back().channels.push_back(MultiController::localOf(ch));
+        }
+    }
+
+    for (unsigned first=0; first<addrs.size(); first+=batch) {
+        std::vector<unsigned> part(addrs.begin()+first, addrs.begin()+std::min<size_t>(first+batch, addrs.size()));
+
+        // FEs with the same chip ID get their reads together
+        TxBroadcaster broadcaster(tx);
+        broadcaster.write(fes, [&](FrontEnd *fe) {
+            fe->requestRegisters(part);
+        });
+
+        auto complete = [&]() {
+            for (unsigned ch : rxChannels) {
+                std::map<unsigned, uint16_t> &answers = values[ch];
+                for (unsigned addr : part) {
+                    if (answers.find(addr) == answers.end())
+                        return false;
+                }
+            }
+            return true;
+        };
+
+        std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+        while (!complete()) {
+            bool received = false;
+            for (Stream &s : streams) {
+                RawData *data = s.rx->readData();
+                if (data == nullptr)
+                    continue;
+                // Decoded chunk by chunk like the data processors do, only
+                // an incomplete answer is carried over
+                s.words.erase(s.words.begin(), s.words.begin()+s.pos);
+                s.pos = 0;
+                s.words.insert(s.words.end(), data->buf, data->buf+data->words);
+                delete[] data->buf;
+                delete data;
+                fes[0]->decodeRegisters(s.words, s.pos, s.channels, s.values);
+                for (auto &it : s.values) {
+                    unsigned ch = multi == nullptr ? it.first : MultiController::globalOf(s.ctrl, it.first);
+                    values[ch].insert(it.second.begin(), it.second.end());
+                }
+                received = true;
+            }
+            if (received) {
+                last = std::chrono::steady_clock::now();
+            } else {
+                if (std::chrono::steady_clock::now() - last > std::chrono::milliseconds(timeout))
+                    break;
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+    return values;
+}
+
+std::vector<FrontEnd*> RegisterReadback::compare(const std::vector<FrontEnd*> &fes, const std::vector<unsigned> &addrs) {
+    std::map<unsigned, std::map<unsigned, uint16_t>> values = this->read(fes, addrs);
+
+    std::vector<FrontEnd*> bad;
+    for (FrontEnd *fe : fes) {
+        FrontEndCfg *cfg = dynamic_cast<FrontEndCfg*>(fe);
+        std::map<unsigned, uint16_t> &answers = values[cfg->getRxChannel()];
+        unsigned length = 0;
+        uint16_t *shadow = fe->getRegShadow(length);
+
+        unsigned nMissing = 0;
+        unsigned nWrong = 0;
+        for (unsigned addr : addrs) {
+            auto it = answers.find(addr);
+            if (it == answers.end()) {
+                nMissing++;
+            } else if (shadow != nullptr && addr < length && it->second != shadow[addr]) {
+                std::cout << "#ERROR# " << cfg->getName() << " register " << addr << " reads 0x" << std::hex
+                    << it->second << " instead of 0x" << shadow[addr] << std::dec << std::endl;
+                nWrong++;
+            }
+        }
+        if (nMissing > 0) {
+            std::cout << "#ERROR# " << cfg->getName() << " did not answer " << nMissing << " of "
+                << addrs.size() << " register reads" << std::endl;
+        }
+        if (nMissing > 0 || nWrong > 0)
+            bad.push_back(fe);
+    }
+    return bad;
+}
+
+bool RegisterReadback::checkCom(const std::vector<FrontEnd*> &fes) {
+    bool ok = true;
+    std::map<unsigned, std::vector<FrontEnd*>> byAddr;
+    for (FrontEnd *fe : fes) {
+        std::vector<unsigned> addrs = fe->getReadbackRegisters();
+        if (!addrs.empty()) {
+            byAddr[addrs[0]].push_back(fe);
+            continue;
+        }
+        tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
+        rx->setRxEnable(dynamic_cast<FrontEndCfg*>(fe)->getRxChannel());
+        if (fe->checkCom() != 1) {
+            std::cout << "#ERROR# No communication with " << dynamic_cast<FrontEndCfg*>(fe)->getName() << std::endl;
+            ok = false;
+        }
+    }
+    for (auto &it : byAddr) {
+        for (FrontEnd *fe : this->compare(it.second, {it.first})) {
+            if (fe->needsReadback()) {
+                ok = false;
+            } else {
+                std::cout << "#WARNING# " << dynamic_cast<FrontEndCfg*>(fe)->getName()
+                    << " can not be read back, continuing without" << std::endl;
+            }
+        }
+    }
+    return ok;
+}
+
+bool RegisterReadback::verify(const std::vector<FrontEnd*> &fes) {
+    std::map<std::vector<unsigned>, std::vector<FrontEnd*>> groups;
+    for (FrontEnd *fe : fes) {
+        std::vector<unsigned> addrs = fe->getReadbackRegisters();
+        if (!addrs.empty())
+            groups[addrs].push_back(fe);
+    }
+    unsigned nBad = 0;
+    for (auto &it : groups)
+        nBad += this->compare(it.second, it.first).size();
+    return nBad == 0;
+}
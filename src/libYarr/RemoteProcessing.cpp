@@ -0,0 +1,512 @@
+// #################################
+// # Project: Yarr
+// # Description: Data processing on remote workers
+// # Comment: The readout host streams the raw data over TCP to workers
+// #          running processor, histogrammers and analyses, feedback,
+// #          results and config changes come back the same way
+// ################################
+
+#include "RemoteProcessing.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "FeedbackBase.h"
+#include "Histo1d.h"
+#include "Histo2d.h"
+#include "Histo3d.h"
+#include "MultiController.h"
+#include "StdAdaptiveParameterLoop.h"
+
+namespace {
+    template <typename T> void put(std::string &s, const T &v) {
+        s.append((const char*)&v, sizeof(T));
+    }
+
+    // Reads the payload of a message front to back
+    class Payload {
+        public:
+            Payload(const std::string &arg_s) : s(arg_s), pos(0) {}
+
+            template <typename T> bool get(T &v) {
+                if (pos+sizeof(T) > s.size())
+                    return false;
+                s.copy((char*)&v, sizeof(T), pos);
+                pos += sizeof(T);
+                return true;
+            }
+            std::string rest() {return s.substr(pos);}
+
+        private:
+            const std::string &s;
+            size_t pos;
+    };
+
+    void putStat(std::string &s, const LoopStatus &stat) {
+        put<uint32_t>(s, stat.size());
+        for (unsigned i=0; i<stat.size(); i++)
+            put<uint32_t>(s, stat.get(i));
+    }
+
+    // Only the values make it, which is all processing looks at
+    bool getStat(Payload &p, LoopStatus &stat) {
+        uint32_t n = 0;
+        if (!p.get(n))
+            return false;
+        stat.init(n);
+        for (unsigned i=0; i<n; i++) {
+            uint32_t v = 0;
+            if (!p.get(v))
+                return false;
+            stat.set(i, v);
+        }
+        return true;
+    }
+
+    std::string toBinary(HistogramBase &h) {
+        std::stringstream ss;
+        h.toFileBinary(ss);
+        return ss.str();
+    }
+
+    bool fromBinary(HistogramBase &h, const std::string &s) {
+        std::stringstream ss(s);
+        return h.fromFileBinary(ss);
+    }
+}
+
+RemoteLink::RemoteLink(std::unique_ptr<TcpSocket> arg_sock) {
+    sock = std::move(arg_sock);
+}
+
+bool RemoteLink::send(uint32_t type, const std::string &payload) {
+    uint32_t header[2] = {type, (uint32_t)payload.size()};
+    std::lock_guard<std::mutex> lk(sendMtx);
+    return sock->send(header, sizeof(header)) && sock->send(payload.data(), payload.size());
+}
+
+bool RemoteLink::recv(uint32_t &type, std::string &payload) {
+    uint32_t header[2] = {0, 0};
+    if (!sock->recv(header, sizeof(header)))
+        return false;
+    type = header[0];
+    payload.resize(header[1]);
+    return sock->recv(&payload[0], payload.size());
+}
+
+RemoteHost::RemoteHost(Bookkeeper *arg_keeper, ScanBase *arg_scan) : DataProcessor() {
+    keeper = arg_keeper;
+    scan = arg_scan;
+    input = &keeper->rawData;
+    scanDone = false;
+    nFeedback = 0;
+    sumLatency = 0;
+    maxLatency = 0;
+}
+
+RemoteHost::~RemoteHost() {
+    // Only still running if the scan was aborted
+    for (auto &w : workers)
+        w->link->close();
+    scanDone = true;
+    input->cv.notify_all();
+    this->join();
+}
+
+bool RemoteHost::connectWorkers(const std::vector<std::string> &addrs) {
+    for (const std::string &addr : addrs) {
+        std::size_t colon = addr.find_last_of(':');
+        if (colon == std::string::npos) {
+            std::cerr << "#ERROR# Worker " << addr << " is not given as host:port" << std::endl;
+            return false;
+        }
+        unsigned port = atoi(addr.substr(colon+1).c_str());
+        std::unique_ptr<TcpSocket> sock(new TcpSocket());
+        if (port == 0 || !sock->connect(addr.substr(0, colon), port))
+            return false;
+        std::cout << "-> Connected to worker " << addr << std::endl;
+        workers.emplace_back(new Worker());
+        workers.back()->link.reset(new RemoteLink(std::move(sock)));
+    }
+    return !workers.empty();
+}
+
+bool RemoteHost::setup(json setup) {
+    std::vector<json> chips(workers.size(), json::array());
+    for (FrontEnd *fe : keeper->feList) {
+        if (!fe->isActive())
+            continue;
+        FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(fe);
+        json chip;
+        chip["tx"] = feCfg->getTxChannel();
+        chip["rx"] = feCfg->getRxChannel();
+        feCfg->toFileJson(chip["config"]);
+        chips[MultiController::ctrlOf(feCfg->getRxChannel())%workers.size()].push_back(chip);
+
+        // Adaptive loops only look at the boards which exist when they start
+        for (unsigned n=0; n<scan->size(); n++) {
+            std::shared_ptr<LoopActionBase> l = scan->getLoop(n);
+            if (l->type() == typeid(StdAdaptiveParameterLoop*))
+                std::static_pointer_cast<StdAdaptiveParameterLoop>(l)->summaryBoard(feCfg->getRxChannel());
+        }
+    }
+
+    // Whole controllers are routed, extra workers have nothing to do
+    for (unsigned k=0; k<workers.size(); k++) {
+        if (chips[k].empty())
+            std::cout << "#WARNING# Worker " << k << " gets no FEs, there are fewer controllers than workers" << std::endl;
+    }
+
+    for (unsigned k=0; k<workers.size(); k++) {
+        setup["chips"] = chips[k];
+        if (!workers[k]->link->send(RemoteLink::Setup, setup.dump())) {
+            std::cerr << "#ERROR# Could not send the scan setup to worker " << k << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void RemoteHost::init() {
+    scanDone = false;
+}
+
+void RemoteHost::run() {
+    for (auto &w : workers) {
+        w->lastSent = std::chrono::steady_clock::now();
+        Worker *ptr = w.get();
+        w->receiver = std::thread([this, ptr] () {
+            this->receive(ptr);
+        });
+    }
+    sender = std::thread(&RemoteHost::process, this);
+}
+
+void RemoteHost::join() {
+    if (sender.joinable())
+        sender.join();
+    for (auto &w : workers) {
+        if (w->receiver.joinable())
+            w->receiver.join();
+    }
+}
+
+void RemoteHost::process() {
+    while (true) {
+        std::unique_lock<std::mutex> lk(mtx);
+        input->cv.wait(lk, [&] { return scanDone || !input->empty(); });
+        lk.unlock();
+        // Data can come in before scanDone is changed
+        bool done = scanDone;
+
+        while (!input->empty()) {
+            std::unique_ptr<RawDataContainer> rdc = input->popData();
+            if (rdc == nullptr)
+                continue;
+            std::string payload;
+            put<uint32_t>(payload, rdc->ctrl);
+            putStat(payload, rdc->stat);
+            put<uint32_t>(payload, rdc->size());
+            for (unsigned c=0; c<rdc->size(); c++) {
+                put<uint32_t>(payload, rdc->adr[c]);
+                put<uint32_t>(payload, rdc->words[c]);
+                payload.append((const char*)rdc->buf[c], rdc->words[c]*sizeof(uint32_t));
+            }
+
+            Worker *w = this->route(rdc->ctrl);
+            if (w->lost)
+                continue;
+            if (!w->link->send(RemoteLink::Data, payload)) {
+                std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : lost connection to worker" << std::endl;
+                // Wakes up the receiver, which gives up on the FEs of w
+                w->lost = true;
+                w->link->close();
+                continue;
+            }
+            std::lock_guard<std::mutex> slk(statMtx);
+            w->lastSent = std::chrono::steady_clock::now();
+        }
+
+        if (done)
+            break;
+    }
+    for (auto &w : workers)
+        w->link->send(RemoteLink::Done, "");
+}
+
+void RemoteHost::latency(Worker *w) {
+    std::lock_guard<std::mutex> lk(statMtx);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - w->lastSent).count();
+    nFeedback++;
+    sumLatency += ms;
+    if (ms > maxLatency)
+        maxLatency = ms;
+}
+
+void RemoteHost::receive(Worker *w) {
+    uint32_t type = 0;
+    std::string payload;
+    while (w->link->recv(type, payload)) {
+        Payload p(payload);
+        uint32_t loop = 0;
+        uint32_t algo = 0;
+        uint32_t channel = 0;
+        switch (type) {
+            case RemoteLink::GlobalFeedback: {
+                double sign = 0;
+                uint8_t last = 0;
+                p.get(loop); p.get(algo); p.get(channel); p.get(sign); p.get(last);
+                this->latency(w);
+                GlobalFeedbackBase *fb = loop < scan->size() ? dynamic_cast<GlobalFeedbackBase*>(scan->getLoop(loop).get()) : nullptr;
+                if (fb == nullptr) {
+                    std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : loop " << loop << " takes no global feedback" << std::endl;
+                    break;
+                }
+                fb->apply((GlobalFeedbackBase::Algorithm)algo, channel, sign, last);
+                break;
+            }
+            case RemoteLink::PixelFeedback: {
+                p.get(loop); p.get(algo); p.get(channel);
+                this->latency(w);
+                PixelFeedbackBase *fb = loop < scan->size() ? dynamic_cast<PixelFeedbackBase*>(scan->getLoop(loop).get()) : nullptr;
+                // The loop takes the histogram, as it would from a local analysis
+                Histo2d *h = new Histo2d("feedback", 1, 0, 1, 1, 0, 1, typeid(PixelFeedbackBase*));
+                if (fb == nullptr || !fromBinary(*h, p.rest())) {
+                    std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : bad pixel feedback for loop " << loop << std::endl;
+                    delete h;
+                    break;
+                }
+                fb->apply((PixelFeedbackBase::Algorithm)algo, channel, h);
+                break;
+            }
+            case RemoteLink::Summary: {
+                std::unique_ptr<OccupancySummary> s(new OccupancySummary());
+                p.get(loop); p.get(channel);
+                getStat(p, s->stat);
+                p.get(s->nHit); p.get(s->nHalf); p.get(s->nMax); p.get(s->maxOcc);
+                if (loop < scan->size() && scan->getLoop(loop)->type() == typeid(StdAdaptiveParameterLoop*))
+                    std::static_pointer_cast<StdAdaptiveParameterLoop>(scan->getLoop(loop))->summaryBoard(channel)->pushData(std::move(s));
+                break;
+            }
+            case RemoteLink::Result: {
+                uint8_t dim = 0;
+                p.get(channel); p.get(dim);
+                std::unique_ptr<HistogramBase> h;
+                if (dim == 1) {
+                    h.reset(new Histo1d("result", 1, 0, 1, typeid(HistogramBase*)));
+                } else if (dim == 2) {
+                    h.reset(new Histo2d("result", 1, 0, 1, 1, 0, 1, typeid(HistogramBase*)));
+                } else if (dim == 3) {
+                    h.reset(new Histo3d("result", 1, 0, 1, 1, 0, 1, 1, 0, 1, typeid(HistogramBase*)));
+                }
+                FrontEnd *fe = keeper->getFe(channel);
+                if (h == nullptr || fe == nullptr || !fromBinary(*h, p.rest())) {
+                    std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : bad result for channel " << channel << std::endl;
+                    break;
+                }
+                fe->clipResult->pushData(std::move(h));
+                break;
+            }
+            case RemoteLink::Config: {
+                p.get(channel);
+                FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(keeper->getFe(channel));
+                if (feCfg == nullptr)
+                    break;
+                try {
+                    json patch = json::parse(p.rest());
+                    json cfg;
+                    feCfg->toFileJson(cfg);
+                    cfg = cfg.patch(patch);
+                    feCfg->fromFileJson(cfg);
+                } catch (std::exception &e) {
+                    std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : config changes of channel " << channel
+                        << " could not be applied: " << e.what() << std::endl;
+                }
+                break;
+            }
+            case RemoteLink::Finished:
+                return;
+            default:
+                std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : unknown message " << type << std::endl;
+                break;
+        }
+    }
+    std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : lost connection to worker before it finished" << std::endl;
+    this->abandon(w);
+}
+
+void RemoteHost::abandon(Worker *w) {
+    for (FrontEnd *fe : keeper->feList) {
+        if (!fe->isActive())
+            continue;
+        unsigned channel = dynamic_cast<FrontEndCfg*>(fe)->getRxChannel();
+        if (this->route(MultiController::ctrlOf(channel)) != w)
+            continue;
+        for (unsigned n=0; n<scan->size(); n++) {
+            std::shared_ptr<LoopActionBase> l = scan->getLoop(n);
+            if (GlobalFeedbackBase *fb = dynamic_cast<GlobalFeedbackBase*>(l.get()))
+                fb->abandon(channel);
+            if (PixelFeedbackBase *fb = dynamic_cast<PixelFeedbackBase*>(l.get()))
+                fb->abandon(channel);
+        }
+    }
+}
+
+RemoteWorker::RemoteWorker(std::unique_ptr<TcpSocket> sock) : link(std::move(sock)) {
+    finished = false;
+}
+
+RemoteWorker::~RemoteWorker() {
+    this->finish();
+}
+
+bool RemoteWorker::receiveSetup(json &setup) {
+    uint32_t type = 0;
+    std::string payload;
+    if (!link.recv(type, payload) || type != RemoteLink::Setup)
+        return false;
+    try {
+        setup = json::parse(payload);
+    } catch (std::exception &e) {
+        std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void RemoteWorker::relay(ScanBase *s, const std::vector<unsigned> &channels) {
+    for (unsigned n=0; n<s->size(); n++) {
+        std::shared_ptr<LoopActionBase> l = s->getLoop(n);
+        if (GlobalFeedbackBase *fb = dynamic_cast<GlobalFeedbackBase*>(l.get())) {
+            fb->setRelay([this, n](GlobalFeedbackBase::Algorithm algo, unsigned channel, double sign, bool last) {
+                std::string payload;
+                put<uint32_t>(payload, n);
+                put<uint32_t>(payload, algo);
+                put<uint32_t>(payload, channel);
+                put<double>(payload, sign);
+                put<uint8_t>(payload, last);
+                link.send(RemoteLink::GlobalFeedback, payload);
+            });
+        }
+        if (PixelFeedbackBase *fb = dynamic_cast<PixelFeedbackBase*>(l.get())) {
+            fb->setRelay([this, n](PixelFeedbackBase::Algorithm algo, unsigned channel, Histo2d &h) {
+                std::string payload;
+                put<uint32_t>(payload, n);
+                put<uint32_t>(payload, algo);
+                put<uint32_t>(payload, channel);
+                payload += toBinary(h);
+                link.send(RemoteLink::PixelFeedback, payload);
+            });
+        }
+        if (l->type() != typeid(StdAdaptiveParameterLoop*))
+            continue;
+
+        // One thread per board, they run until finish()
+        for (unsigned channel : channels) {
+            ClipBoard<OccupancySummary> *board = std::static_pointer_cast<StdAdaptiveParameterLoop>(l)->summaryBoard(channel);
+            boards.push_back(board);
+            forwarders.emplace_back([this, n, channel, board] () {
+                while (true) {
+                    bool done = false;
+                    {
+                        // pushData notifies under the board's own mutex, so a
+                        // push between the check and the wait is only caught
+                        // by the timeout
+                        std::unique_lock<std::mutex> lk(mtx);
+                        board->cv.wait_for(lk, std::chrono::milliseconds(10), [&] { return finished || !board->empty(); });
+                        done = finished;
+                    }
+                    while (!board->empty()) {
+                        std::unique_ptr<OccupancySummary> s = board->popData();
+                        if (s == nullptr)
+                            continue;
+                        std::string payload;
+                        put<uint32_t>(payload, n);
+                        put<uint32_t>(payload, channel);
+                        putStat(payload, s->stat);
+                        put<uint32_t>(payload, s->nHit);
+                        put<uint32_t>(payload, s->nHalf);
+                        put<uint32_t>(payload, s->nMax);
+                        put<uint32_t>(payload, s->maxOcc);
+                        link.send(RemoteLink::Summary, payload);
+                    }
+                    if (done)
+                        break;
+                }
+            });
+        }
+    }
+}
+
+bool RemoteWorker::receiveData(ClipBoard<RawDataContainer> &rawData) {
+    uint32_t type = 0;
+    std::string payload;
+    while (link.recv(type, payload)) {
+        if (type == RemoteLink::Done)
+            return true;
+        if (type != RemoteLink::Data) {
+            std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : unexpected message " << type << std::endl;
+            continue;
+        }
+
+        Payload p(payload);
+        std::unique_ptr<RawDataContainer> rdc(new RawDataContainer());
+        uint32_t n = 0;
+        bool ok = p.get(rdc->ctrl) && getStat(p, rdc->stat) && p.get(n);
+        for (unsigned c=0; c<n && ok; c++) {
+            uint32_t adr = 0;
+            uint32_t words = 0;
+            ok = p.get(adr) && p.get(words);
+            if (!ok)
+                break;
+            uint32_t *buf = new uint32_t[words];
+            for (unsigned i=0; i<words && ok; i++)
+                ok = p.get(buf[i]);
+            rdc->add(new RawData(adr, buf, words));
+        }
+        if (!ok) {
+            std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : corrupted data message" << std::endl;
+            continue;
+        }
+        rawData.pushData(std::move(rdc));
+    }
+    return false;
+}
+
+void RemoteWorker::sendResult(unsigned channel, HistogramBase &h) {
+    uint8_t dim = 0;
+    if (dynamic_cast<Histo1d*>(&h)) dim = 1;
+    if (dynamic_cast<Histo2d*>(&h)) dim = 2;
+    if (dynamic_cast<Histo3d*>(&h)) dim = 3;
+    if (dim == 0) {
+        std::cerr << "#ERROR# " << __PRETTY_FUNCTION__ << " : " << h.getName() << " can not be sent" << std::endl;
+        return;
+    }
+    std::string payload;
+    put<uint32_t>(payload, channel);
+    put<uint8_t>(payload, dim);
+    payload += toBinary(h);
+    link.send(RemoteLink::Result, payload);
+}
+
+void RemoteWorker::sendConfig(unsigned channel, const json &patch) {
+    std::string payload;
+    put<uint32_t>(payload, channel);
+    payload += patch.dump();
+    link.send(RemoteLink::Config, payload);
+}
+
+void RemoteWorker::finish() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (finished)
+            return;
+        finished = true;
+    }
+    for (ClipBoard<OccupancySummary> *board : boards)
+        board->cv.notify_all();
+    for (std::thread &t : forwarders)
+        t.join();
+    link.send(RemoteLink::Finished, "");
+}
@@ -18,6 +18,8 @@ ScanBase::ScanBase(Bookkeeper *k) : engine(k) {
 void ScanBase::run() {
     engine.execute();
     engine.end();
+    // All data has to be stored before the scan counts as done
+    LoopActionBase::waitDrained();
 }
 
 std::shared_ptr<LoopActionBase> ScanBase::getLoop(unsigned n) {
@@ -13,6 +13,7 @@
 
 #include "AllStdActions.h"
 #include "ClassRegistry.h"
+#include "TxBroadcaster.h"
 
 ScanFactory::ScanFactory(Bookkeeper *k) : ScanBase(k) {
 }
@@ -34,18 +35,19 @@ void ScanFactory::preScan() {
         FrontEnd &fe = *g_bk->getGlobalFe();
         fe.writeNamedRegister(it.key(), it.value());
     }
-    while(!g_tx->isCmdEmpty()){}
+    g_tx->fence();
 
     if (g_bk->getTargetCharge() > 0) {
+        std::vector<FrontEnd*> active;
         for (auto *fe : g_bk->feList) {
-            if(fe->getActive()) {
-                // Enable single channel
-                g_tx->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
-                // Write parameter
-                fe->setInjCharge(g_bk->getTargetCharge(), true, true); // TODO need sCap/lCap for FEI4
-                while(!g_tx->isCmdEmpty()){}
-            }
+            if(fe->getActive())
+                active.push_back(fe);
         }
+        // FEs with the same calibration share the write
+        TxBroadcaster broadcaster(g_tx);
+        broadcaster.write(active, [&](FrontEnd *fe) {
+            fe->setInjCharge(g_bk->getTargetCharge(), true, true); // TODO need sCap/lCap for FEI4
+        });
         // Reset CMD mask
         g_tx->setCmdEnable(g_bk->getTxMask());
     }
@@ -27,6 +27,17 @@ namespace ScanHelper {
     std::unique_ptr<HwController> loadController(json &ctrlCfg) {
         std::unique_ptr<HwController> hwCtrl = nullptr;
 
+        // Several controllers are driven as one
+        if (ctrlCfg.is_array()) {
+            std::unique_ptr<MultiController> multi(new MultiController());
+            for (unsigned k=0; k<ctrlCfg.size(); k++) {
+                std::cout << "-> Loading controller #" << k << std::endl;
+                multi->addController(loadController(ctrlCfg[k]));
+            }
+            hwCtrl = std::move(multi);
+            return hwCtrl;
+        }
+
         // Open controller config file
         std::string controller = ctrlCfg["ctrlCfg"]["type"];
 
@@ -65,9 +76,26 @@ namespace ScanHelper {
                 if (chip["enable"] == 0) {
                     std::cout << " ... chip not enabled, skipping!" << std::endl;
                 } else {
+                    unsigned tx = chip["tx"];
+                    unsigned rx = chip["rx"];
+                    // Channels of further controllers are counted on from the first
+                    if (!chip["controller"].empty()) {
+                        unsigned ctrl = chip["controller"];
+                        MultiController *multi = dynamic_cast<MultiController*>(hwCtrl);
+                        unsigned nCtrl = multi == nullptr ? 1 : multi->size();
+                        if (ctrl >= nCtrl) {
+                            std::cerr << "#ERROR# Chip #" << i << " is on controller " << ctrl << " but only "
+                                << nCtrl << " controller(s) loaded!" << std::endl;
+                            throw(std::runtime_error("loadChips failure"));
+                        }
+                        if (multi != nullptr) {
+                            tx = MultiController::globalOf(ctrl, tx);
+                            rx = MultiController::globalOf(ctrl, rx);
+                        }
+                    }
                     // TODO should be a shared pointer
-                    bookie.addFe(StdDict::getFrontEnd(chipType).release(), chip["tx"], chip["rx"]);
-                    bookie.getLastFe()->init(hwCtrl, chip["tx"], chip["rx"]);
+                    bookie.addFe(StdDict::getFrontEnd(chipType).release(), tx, rx);
+                    bookie.getLastFe()->init(hwCtrl, tx, rx);
                     FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(bookie.getLastFe());
                     std::ifstream cfgFile(chipConfigPath);
                     if (cfgFile) {
@@ -87,7 +115,7 @@ namespace ScanHelper {
                     } else {
                         std::cout << "Config file not found, using default!" << std::endl;
                         // Rename in case of multiple default configs
-                        feCfg->setName(feCfg->getName() + "_" + std::to_string((int)chip["rx"]));
+                        feCfg->setName(feCfg->getName() + "_" + std::to_string(rx));
                         std::cout << "-> Creating new config of FE " << feCfg->getName() << " to " << chipConfigPath << std::endl;
                         json jTmp;
                         feCfg->toFileJson(jTmp);
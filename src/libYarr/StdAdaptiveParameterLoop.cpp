@@ -0,0 +1,230 @@
+// #################################
+// # Project: Yarr
+// # Description: Named Parameter Loop with adaptive steps
+// ################################
+
+#include "StdAdaptiveParameterLoop.h"
+
+#include <iostream>
+
+StdAdaptiveParameterLoop::StdAdaptiveParameterLoop() {
+    loopType = typeid(this);
+    min = 0;
+    max = 100;
+    step = 1;
+    coarseStep = 4;
+    settle = 3;
+    turnOn = 0.1;
+}
+
+void StdAdaptiveParameterLoop::init() {
+    m_done = false;
+    m_cur = min;
+    m_fine = min;
+    m_refined = false;
+    if (summaries.empty()) {
+        std::cerr << __PRETTY_FUNCTION__ << " --> No occupancy summaries connected, using fixed steps" << std::endl;
+        m_refined = true;
+    }
+    taken.clear();
+    points.clear();
+    lastValue.clear();
+
+    // Summaries of earlier iterations of the outer loops are stale
+    loopIndex = 0;
+    for (unsigned i=0; i<g_stat->size(); i++) {
+        if (g_stat->getPointer(i) == this)
+            loopIndex = i;
+    }
+    outerStat.clear();
+    for (unsigned i=0; i<loopIndex; i++) {
+        outerStat.push_back(g_stat->get(i));
+    }
+
+    this->writePar();
+}
+
+void StdAdaptiveParameterLoop::execPart1() {
+    if (verbose)
+        std::cout << " : AdaptiveParameterLoop at -> " << m_cur << std::endl;
+    g_stat->set(this, m_cur);
+    taken.insert(m_cur);
+}
+
+void StdAdaptiveParameterLoop::execPart2() {
+    this->collect();
+
+    unsigned next;
+    unsigned hit;
+    if (!m_refined && this->turnedOn(hit)) {
+        // Go back to the last point before the turn-on and walk up in fine steps
+        m_refined = true;
+        m_fine = min;
+        for (unsigned v : taken) {
+            if (v < hit)
+                m_fine = v;
+        }
+        if (verbose)
+            std::cout << " : AdaptiveParameterLoop refining from " << m_fine << std::endl;
+    }
+
+    if (m_refined) {
+        if (this->saturated()) {
+            m_done = true;
+            return;
+        }
+        do {
+            m_fine += step;
+        } while (taken.count(m_fine) > 0);
+        next = m_fine;
+    } else {
+        next = m_cur + coarseStep;
+    }
+
+    if ((int)next > max) {
+        m_done = true;
+        return;
+    }
+    m_cur = next;
+    this->writePar();
+}
+
+void StdAdaptiveParameterLoop::end() {
+    std::cout << " : AdaptiveParameterLoop took " << taken.size() << " of "
+        << (max-min)/step+1 << " steps" << std::endl;
+    // Reset to min
+    m_cur = min;
+    this->writePar();
+}
+
+void StdAdaptiveParameterLoop::writePar() {
+    keeper->getGlobalFe()->writeNamedRegister(parName, m_cur);
+
+    g_tx->fence();
+}
+
+// Picks up whatever the histogrammers published so far, without waiting
+void StdAdaptiveParameterLoop::collect() {
+    for (auto &board : summaries) {
+        unsigned ch = board.first;
+        while (!board.second.empty()) {
+            std::unique_ptr<OccupancySummary> s = board.second.popData();
+            if (s == nullptr)
+                continue;
+            bool stale = (s->stat.size() <= loopIndex);
+            for (unsigned i=0; i<outerStat.size() && !stale; i++) {
+                stale = (s->stat.get(i) != outerStat[i]);
+            }
+            if (stale)
+                continue;
+
+            unsigned value = s->stat.get(loopIndex);
+            auto found = points[ch].find(value);
+            if (found == points[ch].end()) {
+                points[ch][value] = {s->nHit, s->nHalf, s->nMax, s->maxOcc};
+            } else {
+                Point &p = found->second;
+                p.nHit += s->nHit;
+                p.nHalf += s->nHalf;
+                if (s->maxOcc > p.maxOcc) {
+                    p.maxOcc = s->maxOcc;
+                    p.nMax = s->nMax;
+                } else if (s->maxOcc == p.maxOcc) {
+                    p.nMax += s->nMax;
+                }
+            }
+            lastValue[ch] = value;
+        }
+    }
+}
+
+// Once half of the responding pixels of an FE are above 50% occupancy,
+// its turn-on is the lowest value at which a 'turnOn' fraction of them
+// was. Single early or noisy pixels do not count. Lowest over all FEs.
+bool StdAdaptiveParameterLoop::turnedOn(unsigned &value) {
+    bool found = false;
+    for (auto &fe : points) {
+        // Only values below the last one seen are complete
+        const Point *bulk = nullptr;
+        for (auto &p : fe.second) {
+            if (p.first >= lastValue[fe.first])
+                break;
+            if (p.second.nHalf > 0 && 2*p.second.nHalf >= p.second.nHit) {
+                bulk = &p.second;
+                break;
+            }
+        }
+        if (bulk == nullptr)
+            continue;
+        for (auto &p : fe.second) {
+            if (p.second.nHalf >= turnOn*bulk->nHit) {
+                if (!found || p.first < value)
+                    value = p.first;
+                found = true;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+// Every FE had all hit pixels at the same, unchanged occupancy for the last
+// 'settle' complete steps
+bool StdAdaptiveParameterLoop::saturated() {
+    if (summaries.empty() || points.size() < summaries.size())
+        return false;
+    for (auto &fe : points) {
+        unsigned cnt = 0;
+        const Point *prev = nullptr;
+        for (auto &p : fe.second) {
+            // Only values below the last one seen are complete
+            if (p.first >= lastValue[fe.first])
+                break;
+            const Point &cur = p.second;
+            bool flat = (cur.nHit > 0 && cur.nHit == cur.nMax);
+            if (flat && prev != nullptr && cur.nHit == prev->nHit && cur.maxOcc == prev->maxOcc) {
+                cnt++;
+            } else {
+                cnt = flat ? 1 : 0;
+            }
+            prev = &cur;
+        }
+        if (cnt < settle)
+            return false;
+    }
+    return true;
+}
+
+void StdAdaptiveParameterLoop::writeConfig(json &j) {
+    j["min"] = min;
+    j["max"] = max;
+    j["step"] = step;
+    j["coarseStep"] = coarseStep;
+    j["settle"] = settle;
+    j["turnOn"] = turnOn;
+    j["parameter"] = parName;
+}
+
+void StdAdaptiveParameterLoop::loadConfig(json &j) {
+    if (!j["min"].empty())
+        min = j["min"];
+    if (!j["max"].empty())
+        max = j["max"];
+    if (!j["step"].empty())
+        step = j["step"];
+    coarseStep = 4*step;
+    if (!j["coarseStep"].empty())
+        coarseStep = j["coarseStep"];
+    // Coarse points have to lie on the fine grid
+    coarseStep -= coarseStep%step;
+    if (coarseStep < step)
+        coarseStep = step;
+    if (!j["settle"].empty())
+        settle = j["settle"];
+    if (!j["turnOn"].empty())
+        turnOn = j["turnOn"];
+    if (!j["parameter"].empty()) {
+        std::cout << "  Linking parameter: " << j["parameter"] <<std::endl;
+        parName = j["parameter"];
+    }
+}
@@ -37,6 +37,8 @@ void StdDataGatherer::end() {
 void StdDataGatherer::execPart1() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
+    // The previous stage may still be read out
+    LoopActionBase::waitDrained();
     if (g_tx->getTrigEnable() == 0)
         std::cerr << "### ERROR ### " << __PRETTY_FUNCTION__ << " : Trigger is not enabled, will get stuck here!" << std::endl;
 
@@ -47,26 +49,37 @@ sig_atomic_t signaled = 0;
 void StdDataGatherer::execPart2() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
-    unsigned count = 0;
-    uint32_t done = 0;
-    uint32_t rate = 0;
-
     signaled = 0;
     signal(SIGINT, [](int signum){signaled = 1;});
     signal(SIGUSR1, [](int signum){signaled = 1;});
 
     std::cout << "### IMPORTANT ### Going into endless loop, interrupt with ^c (SIGINT)!" << std::endl;
 
+    std::vector<Source> src = sources(g_tx, g_rx);
+    forEach(src.size(), [&] (unsigned k) {
+        this->gather(src[k].tx, src[k].rx, k);
+    });
+
+    m_done = true;
+    counter++;
+}
+
+void StdDataGatherer::gather(TxCore *tx, RxCore *rx, unsigned ctrl) {
+    unsigned count = 0;
+    uint32_t done = 0;
+    uint32_t rate = 0;
+
     std::vector<RawData*> tmp_storage;
     RawData *newData = NULL;
     while (done == 0) {
         std::unique_ptr<RawDataContainer> rdc(new RawDataContainer());
-        rate = g_rx->getDataRate();
+        rdc->ctrl = ctrl;
+        rate = rx->getDataRate();
         if (verbose)
             std::cout << " --> Data Rate: " << rate/256.0/1024.0 << " MB/s" << std::endl;
-        done = g_tx->isTrigDone();
+        done = tx->isTrigDone();
         do {
-            newData =  g_rx->readData();
+            newData =  rx->readData();
             if (newData != NULL) {
                 rdc->add(newData);
                 count += newData->words;
@@ -81,13 +94,10 @@ void StdDataGatherer::execPart2() {
         if (signaled == 1 || killswitch) {
             std::cout << "Caught interrupt, stopping data taking!" << std::endl;
             std::cout << "Abort will leave buffers full of data!" << std::endl;
-            g_tx->toggleTrigAbort();
+            tx->toggleTrigAbort();
         }
-        std::this_thread::sleep_for(g_rx->getWaitTime());
+        std::this_thread::sleep_for(rx->getWaitTime());
     }
-
-    m_done = true;
-    counter++;
 }
 
 //void StdDataGatherer::connect(ClipBoard<RawDataContainer> *clipboard) {
@@ -17,6 +17,16 @@ StdDataLoop::StdDataLoop() : LoopActionBase() {
     max = 0;
     step = 1;
     counter = 0;
+    m_pipeline = false;
+}
+
+void StdDataLoop::writeConfig(json &config) {
+    config["pipeline"] = m_pipeline;
+}
+
+void StdDataLoop::loadConfig(json &config) {
+    if (!config["pipeline"].empty())
+        m_pipeline = config["pipeline"];
 }
 
 void StdDataLoop::init() {
@@ -34,6 +44,8 @@ void StdDataLoop::end() {
 void StdDataLoop::execPart1() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
+    // Usually the trigger loop waited already
+    LoopActionBase::waitDrained();
     if (g_tx->getTrigEnable() == 0)
         std::cerr << "### ERROR ### " << __PRETTY_FUNCTION__ << " : Trigger is not enabled, will get stuck here!" << std::endl;
 
@@ -42,51 +54,80 @@ void StdDataLoop::execPart1() {
 void StdDataLoop::execPart2() {
     if (verbose)
         std::cout << __PRETTY_FUNCTION__ << std::endl;
-    unsigned count = 0;
-    uint32_t done = 0;
-    //uint32_t rate = 0;
-    //uint32_t curCnt = 0;
-    unsigned iterations = 0;
-    //uint32_t startAddr = 0;
+    std::vector<Source> src = sources(g_tx, g_rx);
+    std::vector<RawDataContainer*> rdcs(src.size());
+    std::vector<unsigned> counts(src.size(), 0);
+    std::vector<unsigned> iterations(src.size(), 0);
+    forEach(src.size(), [&] (unsigned k) {
+        rdcs[k] = new RawDataContainer();
+        rdcs[k]->ctrl = k;
+        counts[k] = collect(src[k].tx, src[k].rx, *rdcs[k], iterations[k]);
+    });
+    for (RawDataContainer *rdc : rdcs)
+        rdc->stat = *g_stat;
 
+    ClipBoard<RawDataContainer> *out = storage;
+    bool v = verbose;
+    auto finish = [src, rdcs, out, counts, iterations, v] () {
+        std::vector<unsigned> words = counts;
+        std::vector<unsigned> n = iterations;
+        forEach(src.size(), [&] (unsigned k) {
+            words[k] += drain(src[k].rx, *rdcs[k], n[k]);
+        });
+        for (unsigned k=0; k<rdcs.size(); k++) {
+            out->pushData(std::unique_ptr<RawDataContainer>(rdcs[k]));
+            if (v)
+                std::cout << " --> Received " << words[k] << " words! " << n[k] << std::endl;
+        }
+    };
+    if (m_pipeline) {
+        // Triggers are done, so everything still arriving belongs to this
+        // stage. The outer loops configure the next stage meanwhile, its
+        // triggers wait until the tail is read.
+        LoopActionBase::drainInBackground(finish);
+    } else {
+        finish();
+    }
+    m_done = true;
+    counter++;
+}
 
-    std::vector<RawData*> tmp_storage;
+unsigned StdDataLoop::collect(TxCore *tx, RxCore *rx, RawDataContainer &rdc, unsigned &iterations) {
+    unsigned count = 0;
+    uint32_t done = 0;
     RawData *newData = NULL;
-    std::unique_ptr<RawDataContainer> rdc(new RawDataContainer());
     while (done == 0) {
         //rate = g_rx->getDataRate();
         //curCnt = g_rx->getCurCount();
-        done = g_tx->isTrigDone();
+        done = tx->isTrigDone();
         do {
-            newData =  g_rx->readData();
+            newData =  rx->readData();
             iterations++;
             if (newData != NULL) {
                 count += newData->words;
-                rdc->add(newData);
+                rdc.add(newData);
             }
         } while (newData != NULL);
-        //delete newData;
     }
+    return count;
+}
+
+unsigned StdDataLoop::drain(RxCore *rx, RawDataContainer &rdc, unsigned &iterations) {
+    unsigned count = 0;
+    RawData *newData = NULL;
     // Gather rest of data after timeout (defined by controller)
-    std::this_thread::sleep_for(g_rx->getWaitTime());
+    std::this_thread::sleep_for(rx->getWaitTime());
     do {
         //curCnt = g_rx->getCurCount();
-        newData = g_rx->readData();
+        newData = rx->readData();
         iterations++;
         if (newData != NULL) {
             count += newData->words;
-            rdc->add(newData);
+            rdc.add(newData);
         }
-    } while (newData != NULL || g_rx->getCurCount() != 0);
+    } while (newData != NULL || rx->getCurCount() != 0);
     delete newData;
-    
-    rdc->stat = *g_stat;
-    storage->pushData(std::move(rdc));
-        
-    if (verbose)
-        std::cout << " --> Received " << count << " words! " << iterations << std::endl;
-    m_done = true;
-    counter++;
+    return count;
 }
 
 //void StdDataLoop::connect(ClipBoard<RawDataContainer> *clipboard) {
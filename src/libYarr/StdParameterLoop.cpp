@@ -42,7 +42,7 @@ void StdParameterLoop::end() {
 void StdParameterLoop::writePar() {
     keeper->getGlobalFe()->writeNamedRegister(parName, m_cur);
 
-    while(!g_tx->isCmdEmpty());
+    g_tx->fence();
 }
 
 void StdParameterLoop::writeConfig(json &j) {
@@ -0,0 +1,109 @@
+// #################################
+// # Project: Yarr
+// # Description: Model based pixel threshold trim
+// ################################
+
+#include "TdacModel.h"
+
+#include <cmath>
+
+namespace {
+    // Inverse of the normal cdf, P. J. Acklam's rational approximation,
+    // relative error below 1.2e-9
+    double probit(double p) {
+        const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                              1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+        const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                              6.680131188771972e+01, -1.328068155288572e+01};
+        const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                             -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+        const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                              3.754408661907416e+00};
+        const double low = 0.02425;
+        if (p < low) {
+            double q = std::sqrt(-2*std::log(p));
+            return (((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) /
+                ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1);
+        } else if (p > 1-low) {
+            double q = std::sqrt(-2*std::log(1-p));
+            return -(((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) /
+                ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1);
+        }
+        double q = p-0.5;
+        double r = q*q;
+        return (((((a[0]*r+a[1])*r+a[2])*r+a[3])*r+a[4])*r+a[5])*q /
+            (((((b[0]*r+b[1])*r+b[2])*r+b[3])*r+b[4])*r+1);
+    }
+}
+
+double TdacModel::deviation(double occ, unsigned injections) {
+    if (occ <= 0)
+        return saturated;
+    if (occ >= injections)
+        return -saturated;
+    return -probit(occ/(double)injections);
+}
+
+int TdacModel::sign(double dev) {
+    if (dev > window)
+        return 1;
+    if (dev < -window)
+        return -1;
+    return 0;
+}
+
+void TdacModel::init(unsigned nPixels) {
+    lastValue.assign(nPixels, 0);
+    lastDev.assign(nPixels, 0);
+    valid.assign(nPixels, false);
+    slope = 0;
+    slopeSum = 0;
+    slopeCnt = 0;
+}
+
+void TdacModel::update() {
+    if (slopeCnt > 0)
+        slope = slopeSum/slopeCnt;
+    slopeSum = 0;
+    slopeCnt = 0;
+}
+
+int TdacModel::next(unsigned i, int cur, double dev, int dir, int step, int min, int max) {
+    int s = sign(dev);
+    bool sat = std::fabs(dev) >= saturated;
+    // Magnitude of the change of the deviation per unit of the setting
+    double k = 0;
+    if (valid[i] && lastValue[i] != cur) {
+        double pixSlope = (dev - lastDev[i])/(double)(cur - lastValue[i]);
+        bool lastSat = std::fabs(lastDev[i]) >= saturated;
+        // The deviation has to fall when moving along dir
+        if (pixSlope*dir < 0 && !sat && !lastSat) {
+            slopeSum += std::fabs(pixSlope);
+            slopeCnt++;
+        }
+        // A saturated point only bounds the target, extrapolating from it
+        // would jump arbitrarily far
+        bool bracket = (dev > 0) != (lastDev[i] > 0);
+        if (pixSlope*dir < 0 && (bracket || (!sat && !lastSat)))
+            k = std::fabs(pixSlope);
+    }
+    if (k == 0 && !sat)
+        k = slope;
+
+    int v = cur;
+    if (s != 0) {
+        if (k > 0) {
+            v = (int)std::lround(cur + dir*dev/k);
+            if (v == cur)
+                v = cur + s*dir;
+        } else {
+            v = cur + step*s*dir;
+        }
+        if (v < min) v = min;
+        if (v > max) v = max;
+    }
+    lastValue[i] = cur;
+    lastDev[i] = dev;
+    valid[i] = true;
+    return v;
+}
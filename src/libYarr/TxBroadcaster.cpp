@@ -0,0 +1,73 @@
+// #################################
+// # Project: Yarr
+// # Description: Writes the same commands to many FEs at once
+// # Comment: The commands of every FE are recorded first, each distinct
+// #          sequence is then sent once with all its tx channels enabled
+// ################################
+
+#include "TxBroadcaster.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "TxRecorder.h"
+
+TxBroadcaster::TxBroadcaster(TxCore *arg_tx) {
+    tx = arg_tx;
+    nSent = 0;
+    nFe = 0;
+}
+
+void TxBroadcaster::write(const std::vector<FrontEnd*> &fes, std::function<void(FrontEnd*)> write) {
+    struct Group {
+        std::unique_ptr<TxRecorder> rec;
+        std::vector<uint32_t> channels;
+    };
+    std::vector<Group> groups;
+    nSent = 0;
+    nFe = 0;
+
+    auto flush = [&]() {
+        for (Group &g : groups) {
+            if (g.rec->getWords().empty())
+                continue;
+            tx->setCmdEnable(g.channels);
+            g.rec->replay(tx);
+            tx->fence();
+            nSent++;
+        }
+        groups.clear();
+    };
+
+    std::unique_ptr<TxRecorder> rec(new TxRecorder());
+    for (FrontEnd *fe : fes) {
+        unsigned channel = dynamic_cast<FrontEndCfg*>(fe)->getTxChannel();
+        nFe++;
+        TxCore *prev = fe->setCmdCore(rec.get());
+        if (prev == nullptr) {
+            // The FEs before it go out first, as without broadcasting
+            flush();
+            tx->setCmdEnable(channel);
+            write(fe);
+            tx->fence();
+            nSent++;
+            continue;
+        }
+        write(fe);
+        fe->setCmdCore(prev);
+
+        auto it = std::find_if(groups.begin(), groups.end(),
+                [&](Group &g) {return g.rec->sameCommands(*rec);});
+        if (it == groups.end()) {
+            groups.push_back({std::move(rec), {channel}});
+            rec.reset(new TxRecorder());
+        } else {
+            // Two FEs on one channel with the same commands, these go out once anyway
+            if (std::find(it->channels.begin(), it->channels.end(), channel) == it->channels.end())
+                it->channels.push_back(channel);
+            rec->clear();
+        }
+    }
+
+    flush();
+}
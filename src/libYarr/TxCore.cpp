@@ -1,7 +1,40 @@
 #include "TxCore.h"
 
+#include <chrono>
+#include <thread>
+
 TxCore::TxCore() {
+    m_fenceSubmitted = 0;
+    m_fenceDone = 0;
 }
 
 TxCore::~TxCore() {
 }
+
+uint64_t TxCore::submit() {
+    return ++m_fenceSubmitted;
+}
+
+void TxCore::wait(uint64_t token) {
+    unsigned interval = 1;
+    while (m_fenceDone < token) {
+        // An empty fifo covers everything submitted before looking at it
+        uint64_t pending = m_fenceSubmitted;
+        if (this->isCmdEmpty()) {
+            this->fenceDone(pending);
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(interval));
+            if (interval < maxPollInterval)
+                interval *= 2;
+        }
+    }
+}
+
+void TxCore::pause(unsigned us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void TxCore::fenceDone(uint64_t token) {
+    uint64_t done = m_fenceDone;
+    while (done < token && !m_fenceDone.compare_exchange_weak(done, token));
+}
@@ -0,0 +1,54 @@
+// #################################
+// # Project: Yarr
+// # Description: Replays command sequences of loop actions
+// # Comment: A sequence is generated once per loop state and replayed
+// #          afterwards, until the register shadow differs
+// ################################
+
+#include "TxProgramCache.h"
+
+#include <algorithm>
+
+TxProgramCache::TxProgramCache() {
+    nHits = 0;
+    nMisses = 0;
+}
+
+void TxProgramCache::clear() {
+    programs.clear();
+    nHits = 0;
+    nMisses = 0;
+}
+
+void TxProgramCache::run(FrontEnd *fe, TxCore *tx, uint64_t key, std::function<void()> gen) {
+    unsigned length = 0;
+    uint16_t *shadow = fe->getRegShadow(length);
+    if (shadow == nullptr) {
+        gen();
+        return;
+    }
+
+    auto it = programs.find(key);
+    if (it != programs.end() && it->second.before.size() == length && std::equal(shadow, shadow+length, it->second.before.begin())) {
+        it->second.rec.replay(tx);
+        std::copy(it->second.after.begin(), it->second.after.end(), shadow);
+        nHits++;
+        return;
+    }
+
+    Program &p = programs[key];
+    p.rec.clear();
+    p.rec.setKeepWaits(false);
+    p.before.assign(shadow, shadow+length);
+    TxCore *prev = fe->setCmdCore(&p.rec);
+    if (prev == nullptr) {
+        programs.erase(key);
+        gen();
+        return;
+    }
+    gen();
+    fe->setCmdCore(prev);
+    p.after.assign(shadow, shadow+length);
+    p.rec.replay(tx);
+    nMisses++;
+}
@@ -0,0 +1,72 @@
+// #################################
+// # Project: Yarr
+// # Description: Records the commands of a FE instead of sending them
+// # Comment: Releases of the fifo, waits for it to run empty and pauses
+// #          asked for by the FE are kept, so the sequence can be sent
+// #          later the same way
+// ################################
+
+#include "TxRecorder.h"
+
+#include <chrono>
+#include <thread>
+
+TxRecorder::TxRecorder() : TxCore() {
+    keepWaits = true;
+}
+
+TxRecorder::~TxRecorder() {
+}
+
+void TxRecorder::clear() {
+    words.clear();
+    marks.clear();
+}
+
+TxRecorder::Mark& TxRecorder::addMark() {
+    if (marks.empty() || marks.back().pos != words.size())
+        marks.push_back({words.size(), 0, false, 0});
+    return marks.back();
+}
+
+void TxRecorder::writeFifo(uint32_t value) {
+    words.push_back(value);
+}
+
+void TxRecorder::writeFifoBlock(const uint32_t *block, size_t length) {
+    words.insert(words.end(), block, block+length);
+}
+
+void TxRecorder::releaseFifo() {
+    this->addMark().releases++;
+}
+
+bool TxRecorder::isCmdEmpty() {
+    if (keepWaits)
+        this->addMark().wait = true;
+    return true;
+}
+
+void TxRecorder::pause(unsigned us) {
+    Mark &m = this->addMark();
+    if (us > m.pause)
+        m.pause = us;
+}
+
+void TxRecorder::replay(TxCore *tx) const {
+    size_t start = 0;
+    for (const Mark &m : marks) {
+        if (m.pos > start)
+            tx->writeFifoBlock(&words[start], m.pos-start);
+        start = m.pos;
+        // Controllers like Netio only send on release
+        for (unsigned n=0; n<m.releases; n++)
+            tx->releaseFifo();
+        if (m.wait || m.pause > 0)
+            tx->fence();
+        if (m.pause > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(m.pause));
+    }
+    if (start < words.size())
+        tx->writeFifoBlock(&words[start], words.size()-start);
+}
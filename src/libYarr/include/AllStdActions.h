@@ -3,6 +3,7 @@
 #include "StdDataAction.h"
 #include "StdRepeater.h"
 #include "StdParameterLoop.h"
+#include "StdAdaptiveParameterLoop.h"
 
 #ifndef ALLSTDACTIONS_H
 #define ALLSTDACTIONS_H
@@ -68,7 +68,6 @@ class Bookkeeper {
 	    std::map<unsigned, ClipBoard<EventDataBase> > eventMap;
 	    std::map<unsigned, ClipBoard<HistogramBase> > histoMap;
 	    std::map<unsigned, ClipBoard<HistogramBase> > resultMap;
-		std::map<unsigned, std::mutex> mutexMap;	
         
 		std::vector<FrontEnd*> activeFeList;
 
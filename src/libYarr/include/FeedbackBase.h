@@ -6,20 +6,152 @@
 #ifndef FEEDBACKBASE_H
 #define FEEDBACKBASE_H
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+
 #include "Histo2d.h"
 #include "LoopActionBase.h"
 
+// Handshake between the analysis of each FE and the feedback loop. The loop
+// expects one message per FE and iteration and handles every FE as soon as
+// its message arrived, instead of waiting for all of them. Messages which
+// arrive before the loop expects them are kept for the iteration which does.
+class FeedbackChannel {
+    public:
+        // Called by the loop before the data of an iteration is taken
+        void expect(unsigned channel) {
+            std::lock_guard<std::mutex> lk(mtx);
+            waiting.insert(channel);
+        }
+
+        // Called by the analysis once the feedback for channel is stored
+        void post(unsigned channel) {
+            {
+                std::lock_guard<std::mutex> lk(mtx);
+                arrived.push_back(channel);
+            }
+            cv.notify_all();
+        }
+
+        // No more messages will come for channel, it is not waited for
+        // from now on
+        void close(unsigned channel) {
+            {
+                std::lock_guard<std::mutex> lk(mtx);
+                closed.insert(channel);
+            }
+            cv.notify_all();
+        }
+
+        // Blocks until one more expected channel posted, false once all did
+        bool next(unsigned &channel) {
+            std::unique_lock<std::mutex> lk(mtx);
+            while (!waiting.empty()) {
+                for (auto it = arrived.begin(); it != arrived.end(); ++it) {
+                    if (waiting.erase(*it) > 0) {
+                        channel = *it;
+                        arrived.erase(it);
+                        return true;
+                    }
+                }
+                for (unsigned ch : closed)
+                    waiting.erase(ch);
+                if (waiting.empty())
+                    break;
+                cv.wait(lk);
+            }
+            return false;
+        }
+
+    private:
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::set<unsigned> waiting;
+        std::set<unsigned> closed;
+        std::deque<unsigned> arrived;
+};
+
 class GlobalFeedbackBase {
     public:
+        enum Algorithm {StepDown, Binary, Step};
+        typedef std::function<void(Algorithm algo, unsigned channel, double sign, bool last)> Relay;
+
         virtual void feedback(unsigned channel, double sign, bool last) = 0;
         virtual void feedbackBinary(unsigned channel, double sign, bool last) = 0; // TODO Algorithm should be selected in scan
         virtual void feedbackStep(unsigned channel, double sign, bool last) {}
+
+        // Analyses send their feedback through here, a remote processing
+        // worker relays it to the loop on the readout host instead
+        void send(Algorithm algo, unsigned channel, double sign, bool last) {
+            if (relay)
+                relay(algo, channel, sign, last);
+            else
+                this->apply(algo, channel, sign, last);
+        }
+        void apply(Algorithm algo, unsigned channel, double sign, bool last) {
+            switch (algo) {
+                case Binary:
+                    this->feedbackBinary(channel, sign, last);
+                    break;
+                case Step:
+                    this->feedbackStep(channel, sign, last);
+                    break;
+                default:
+                    this->feedback(channel, sign, last);
+                    break;
+            }
+        }
+        void setRelay(Relay arg_relay) {relay = arg_relay;}
+        // The feedback of channel is lost, it stays where it is and is
+        // done from now on
+        void abandon(unsigned channel) {
+            this->feedback(channel, 0, true);
+            fbChannel.close(channel);
+        }
+    protected:
+        FeedbackChannel fbChannel;
+    private:
+        Relay relay;
 };
 
 class PixelFeedbackBase {
     public:
-        virtual void feedback(unsigned channel, Histo2d *h) {};
-        virtual void feedbackStep(unsigned channel, Histo2d *h) {};
+        enum Algorithm {StepDown, Step};
+        typedef std::function<void(Algorithm algo, unsigned channel, Histo2d &h)> Relay;
+
+        // The loop takes h and deletes it once it is used
+        virtual void feedback(unsigned channel, Histo2d *h) {delete h;};
+        virtual void feedbackStep(unsigned channel, Histo2d *h) {delete h;};
+        // Feedback histograms carry TdacModel::deviation instead of the sign
+        virtual bool wantsDeviation() {return false;}
+
+        // Same as for GlobalFeedbackBase, a relayed h is deleted after
+        // it was sent
+        void send(Algorithm algo, unsigned channel, std::unique_ptr<Histo2d> h) {
+            if (relay)
+                relay(algo, channel, *h);
+            else
+                this->apply(algo, channel, h.release());
+        }
+        void apply(Algorithm algo, unsigned channel, Histo2d *h) {
+            if (algo == Step)
+                this->feedbackStep(channel, h);
+            else
+                this->feedback(channel, h);
+        }
+        void setRelay(Relay arg_relay) {relay = arg_relay;}
+        // The feedback of channel is lost, its pixels are left as they are
+        void abandon(unsigned channel) {
+            fbChannel.close(channel);
+        }
+    protected:
+        FeedbackChannel fbChannel;
+    private:
+        Relay relay;
 };
 
 #endif
@@ -9,7 +9,9 @@
 // # Comment: Combined multiple FE 
 // ################################
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "ClipBoard.h"
 #include "HistogramBase.h"
@@ -33,10 +35,33 @@ class FrontEnd {
 		bool isActive();
 		void setActive(bool active);
         virtual void makeGlobal(){};
+        // Commands go to arg_core from now on, returns the previous core
+        // or nullptr if the FE can not be redirected
+        virtual TxCore* setCmdCore(TxCore *arg_core) {return nullptr;}
+        // Global register shadow, lets recorded commands check that they
+        // still apply. nullptr if the FE has none
+        virtual uint16_t* getRegShadow(unsigned &length) {return nullptr;}
        
         virtual void configure()=0;
         virtual int checkCom() {return 1;}
 
+        // Register readback, see RegisterReadback. Global registers which
+        // read back what was written, the first one is used to check the
+        // communication. Empty if the FE can not be read back.
+        virtual std::vector<unsigned> getReadbackRegisters() {return {};}
+        // False if the communication check used to pass without reading
+        // back, a failing read is then only a warning
+        virtual bool needsReadback() {return true;}
+        // Sends the reads of addrs without waiting for the answers
+        virtual void requestRegisters(const std::vector<unsigned> &addrs) {}
+        // Decodes the answers in words from pos on into rx channel ->
+        // address -> value, for the FEs on rxChannels. words holds one
+        // RawData chunk after what was left of the previous one, pos is
+        // left on the first word of an incomplete answer.
+        virtual void decodeRegisters(const std::vector<uint32_t> &words, unsigned &pos,
+                const std::vector<unsigned> &rxChannels,
+                std::map<unsigned, std::map<unsigned, uint16_t>> &values) {pos = words.size();}
+
         /// Write to a register using a string name (most likely from json)
         virtual void writeNamedRegister(std::string name, uint16_t value) = 0;
         
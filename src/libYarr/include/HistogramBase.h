@@ -9,6 +9,8 @@
 // # Comment: 
 // ################################
 
+#include <cstdint>
+#include <fstream>
 #include <string>
 #include <typeinfo>
 #include <typeindex>
@@ -27,6 +29,11 @@ class HistogramBase {
 
         virtual void toFile(std::string basename, std::string dir = "", bool header=true) {}
         virtual void plot(std::string basename, std::string dir = "") {}
+
+        // Binary form including the loop status, used to archive histograms
+        // for a later re-analysis or to send them to a remote host
+        virtual void toFileBinary(std::iostream &handle) {}
+        virtual bool fromFileBinary(std::iostream &handle) {return false;}
         
         void setAxisTitle(std::string x, std::string y="y", std::string z="z");
         void setXaxisTitle(std::string);
@@ -39,6 +46,26 @@ class HistogramBase {
 
         std::type_index getType() {return type;}
     protected:
+        void toFileBinaryBase(std::iostream &handle);
+        bool fromFileBinaryBase(std::iostream &handle);
+
+        template <typename T> static void writeBinary(std::iostream &handle, const T &v) {
+            handle.write((const char*)&v, sizeof(T));
+        }
+        template <typename T> static void readBinary(std::iostream &handle, T &v) {
+            handle.read((char*)&v, sizeof(T));
+        }
+
+        // Histograms read from a stream, possibly from the network, are
+        // limited to this many bins
+        static const uint64_t maxBinaryBins = 1u << 24;
+        // Bytes left to read in handle, -1 if the stream can not tell
+        static std::streamoff bytesLeft(std::iostream &handle);
+        // Checks, before anything is allocated, that nothing was cut short
+        // so far, that nBins is sane and that the nEntries sparse entries of
+        // entrySize bytes each are still in handle
+        static bool checkBinary(std::iostream &handle, uint64_t nBins, uint32_t nEntries, size_t entrySize);
+
         std::string name;
         std::string xAxisTitle;
         std::string yAxisTitle;
@@ -7,6 +7,7 @@
 #ifndef LOOPACTIONBASE_H
 #define LOOPACTIONBASE_H
 
+#include <functional>
 #include <memory>
 #include <typeinfo>
 #include <typeindex>
@@ -45,9 +46,18 @@ class LoopActionBase {
 
         virtual void loadConfig(json &config) {}
         virtual void writeConfig(json &config) {}
+
+        // False if the loop decides on the data how many steps it takes
+        virtual bool hasFixedSteps() {return true;}
 		
         bool checkGlobalDone();
 
+        // A pipelined data loop reads the tail of a stage in the background
+        // while the outer loops already configure the next one. Anything
+        // that starts triggers or ends the scan has to wait for it first.
+        static void drainInBackground(std::function<void()> drain);
+        static void waitDrained();
+
     protected:
         virtual void init() {}
         virtual void end() {}
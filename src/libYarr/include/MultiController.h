@@ -0,0 +1,95 @@
+#ifndef MULTICONTROLLER_H
+#define MULTICONTROLLER_H
+
+// #################################
+// # Project: Yarr
+// # Description: Several controllers driven as one
+// # Comment: Channels are numbered across controllers, channel c of
+// #          controller k is k*channelStride+c
+// ################################
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "HwController.h"
+
+class MultiController : public HwController {
+    public:
+        static constexpr unsigned channelStride = 64;
+        static unsigned ctrlOf(unsigned channel) {return channel/channelStride;}
+        static unsigned localOf(unsigned channel) {return channel%channelStride;}
+        static unsigned globalOf(unsigned ctrl, unsigned channel) {return ctrl*channelStride+channel;}
+
+        MultiController();
+        ~MultiController();
+
+        // Takes a loaded controller, it gets the next controller number
+        void addController(std::unique_ptr<HwController> ctrl);
+        unsigned size() {return ctrls.size();}
+        HwController* getController(unsigned k) {return ctrls.at(k).get();}
+
+        // One config per controller, in the order they were added
+        void loadConfig(json &j) override;
+
+        void setupMode() override;
+        void runMode() override;
+
+        // Commands only go to controllers with an enabled tx channel
+        void writeFifo(uint32_t value) override;
+        void writeFifoBlock(const uint32_t *words, size_t length) override;
+        void releaseFifo() override;
+        void setCmdEnable(uint32_t channel) override;
+        void setCmdEnable(std::vector<uint32_t> channels) override;
+        uint32_t getCmdEnable() override;
+        bool isCmdEmpty() override;
+
+        uint64_t submit() override;
+        void wait(uint64_t token) override;
+
+        // Triggers run in lockstep on all controllers
+        void setTrigEnable(uint32_t value) override;
+        uint32_t getTrigEnable() override;
+        void maskTrigEnable(uint32_t value, uint32_t mask) override;
+        bool isTrigDone() override;
+        void setTrigConfig(enum TRIG_CONF_VALUE cfg) override;
+        void setTrigFreq(double freq) override;
+        void setTrigCnt(uint32_t count) override;
+        void setTrigTime(double time) override;
+        void setTrigWordLength(uint32_t length) override;
+        void setTrigWord(uint32_t *word, uint32_t length) override;
+        void toggleTrigAbort() override;
+
+        void setTriggerLogicMask(uint32_t mask) override;
+        void setTriggerLogicMode(enum TRIG_LOGIC_MODE_VALUE mode) override;
+        void resetTriggerLogic() override;
+        uint32_t getTrigInCount() override;
+
+        void setRxEnable(uint32_t channel) override;
+        void setRxEnable(std::vector<uint32_t> channels) override;
+        // Raw masks only apply to the first controller
+        void maskRxEnable(uint32_t value, uint32_t mask) override;
+
+        // The streams of several controllers can not be told apart, they
+        // have to be read one by one. Throws with more than one controller.
+        RawData* readData() override;
+        void flushBuffer() override;
+
+        uint32_t getDataRate() override;
+        uint32_t getCurCount() override;
+        bool isBridgeEmpty() override;
+
+    private:
+        std::vector<std::unique_ptr<HwController>> ctrls;
+        // Controllers with an enabled tx channel
+        std::vector<bool> cmdActive;
+
+        // Tokens of the controllers for every submitted token
+        std::mutex fenceMtx;
+        std::map<uint64_t, std::vector<uint64_t>> fences;
+
+        std::map<unsigned, std::vector<uint32_t>> split(const std::vector<uint32_t> &channels);
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef OCCUPANCYSUMMARY_H
+#define OCCUPANCYSUMMARY_H
+
+// #################################
+// # Project: Yarr
+// # Description: Occupancy summary
+// # Comment: Condensed content of one occupancy map, published by the
+// #          histogrammer so loops can react to the data on the fly
+// ################################
+
+#include "LoopStatus.h"
+
+struct OccupancySummary {
+    LoopStatus stat;
+    unsigned nHit;      // Pixels with at least one hit
+    unsigned nHalf;     // Pixels with at least half of the injections
+    unsigned nMax;      // Pixels at the highest occupancy of the map
+    unsigned maxOcc;    // Highest occupancy in the map
+};
+
+#endif
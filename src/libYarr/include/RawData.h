@@ -26,7 +26,7 @@ class RawData {
 
 class RawDataContainer {
     public:
-        RawDataContainer(){}
+        RawDataContainer() : ctrl(0) {}
         ~RawDataContainer() {
             for(unsigned int i=0; i<adr.size(); i++)
                 delete[] buf[i];
@@ -47,6 +47,8 @@ class RawDataContainer {
         std::vector<uint32_t*> buf;
         std::vector<unsigned> words;
         LoopStatus stat;
+        // Controller the data was read from
+        unsigned ctrl;
 };
 
 #endif
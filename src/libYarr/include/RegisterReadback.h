@@ -0,0 +1,50 @@
+#ifndef REGISTERREADBACK_H
+#define REGISTERREADBACK_H
+
+// #################################
+// # Project: Yarr
+// # Description: Reads back the global registers of many FEs at once
+// # Comment: Reads are sent back to back in batches, the answers are
+// #          collected from the rx stream and matched by channel and address
+// ################################
+
+#include <map>
+#include <vector>
+
+#include "FrontEnd.h"
+#include "TxCore.h"
+#include "RxCore.h"
+
+class RegisterReadback {
+    public:
+        RegisterReadback(TxCore *arg_tx, RxCore *arg_rx);
+
+        // Milliseconds without new data before missing answers are given up
+        void setTimeout(unsigned ms) {timeout = ms;}
+        // Registers read per FE before their answers are collected, the
+        // answers of a batch have to fit into the rx buffers
+        void setBatchSize(unsigned n) {batch = n > 0 ? n : 1;}
+
+        // Reads addrs of every FE, all of one type. Returns rx channel ->
+        // address -> value, registers which did not answer are missing.
+        // The rx enable mask is left on the FEs.
+        std::map<unsigned, std::map<unsigned, uint16_t>> read(const std::vector<FrontEnd*> &fes, const std::vector<unsigned> &addrs);
+
+        // Compares the first readback register of every FE with its config,
+        // FEs which can not be read back are checked with checkCom(). For
+        // FEs which do not need the readback a failure is only a warning.
+        bool checkCom(const std::vector<FrontEnd*> &fes);
+        // Compares all readback registers of every FE with its config
+        bool verify(const std::vector<FrontEnd*> &fes);
+
+    private:
+        TxCore *tx;
+        RxCore *rx;
+        unsigned timeout;
+        unsigned batch;
+
+        // FEs with a missing or wrong register
+        std::vector<FrontEnd*> compare(const std::vector<FrontEnd*> &fes, const std::vector<unsigned> &addrs);
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef REGISTERTRANSACTION_H
+#define REGISTERTRANSACTION_H
+
+// #################################
+// # Project: Yarr
+// # Description: Global registers to write together
+// # Comment: Only addresses are collected, the values are taken from the
+// #          register shadow when the transaction is committed
+// ################################
+
+#include <algorithm>
+#include <vector>
+
+class RegisterTransaction {
+    public:
+        void add(unsigned addr) {
+            addrs.push_back(addr);
+        }
+
+        bool empty() const {return addrs.empty();}
+        void clear() {addrs.clear();}
+
+        // Every address once, in ascending order
+        std::vector<unsigned> addresses() const {
+            std::vector<unsigned> sorted = addrs;
+            std::sort(sorted.begin(), sorted.end());
+            sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+            return sorted;
+        }
+
+    private:
+        std::vector<unsigned> addrs;
+};
+
+#endif
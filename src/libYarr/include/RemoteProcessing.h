@@ -0,0 +1,139 @@
+#ifndef REMOTEPROCESSING_H
+#define REMOTEPROCESSING_H
+
+// #################################
+// # Project: Yarr
+// # Description: Data processing on remote workers
+// # Comment: The readout host streams the raw data over TCP to workers
+// #          running processor, histogrammers and analyses, feedback,
+// #          results and config changes come back the same way
+// ################################
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bookkeeper.h"
+#include "ClipBoard.h"
+#include "DataProcessor.h"
+#include "HistogramBase.h"
+#include "OccupancySummary.h"
+#include "RawData.h"
+#include "ScanBase.h"
+#include "TcpSocket.h"
+#include "storage.hpp"
+
+// A message is its type and length followed by the payload, everything in
+// the byte order of the sender, workers have to share the architecture
+class RemoteLink {
+    public:
+        enum Type : uint32_t {
+            Setup = 1,      // host -> worker, scan and FE configs as json
+            Data,           // host -> worker, one RawDataContainer
+            Done,           // host -> worker, no more data
+            GlobalFeedback, // worker -> host
+            PixelFeedback,  // worker -> host
+            Summary,        // worker -> host, for adaptive loops
+            Result,         // worker -> host, one result histogram
+            Config,         // worker -> host, json patch of a FE config
+            Finished        // worker -> host, nothing more to send
+        };
+
+        RemoteLink(std::unique_ptr<TcpSocket> arg_sock);
+
+        // Safe to call from several threads
+        bool send(uint32_t type, const std::string &payload);
+        bool recv(uint32_t &type, std::string &payload);
+        void close() {sock->close();}
+
+    private:
+        std::unique_ptr<TcpSocket> sock;
+        std::mutex sendMtx;
+};
+
+// Readout side, takes the place of the data processor
+class RemoteHost : public DataProcessor {
+    public:
+        RemoteHost(Bookkeeper *arg_keeper, ScanBase *arg_scan);
+        ~RemoteHost();
+
+        // Workers are given as host:port, the FEs of controller k are
+        // processed by worker k modulo the number of workers
+        bool connectWorkers(const std::vector<std::string> &addrs);
+        // Sends the scan to the workers, setup has everything but the chips
+        bool setup(json setup);
+
+        // The raw data goes to the workers, events never show up locally
+        void connect(ClipBoard<RawDataContainer> *arg_input, std::map<unsigned, ClipBoard<EventDataBase> > *arg_outMap) override {
+            input = arg_input;
+        }
+        void init() override;
+        void run() override;
+        // Returns once all results and config changes arrived
+        void join() override;
+        void process() override;
+
+        // Time from the last data sent to a worker until its feedback arrived
+        unsigned getNumFeedback() {return nFeedback;}
+        double getMeanLatency() {return nFeedback > 0 ? sumLatency/nFeedback : 0;}
+        double getMaxLatency() {return maxLatency;}
+
+    private:
+        struct Worker {
+            std::unique_ptr<RemoteLink> link;
+            std::thread receiver;
+            std::chrono::steady_clock::time_point lastSent;
+            // Data for it is dropped, only used by the sender
+            bool lost = false;
+        };
+
+        Bookkeeper *keeper;
+        ScanBase *scan;
+        ClipBoard<RawDataContainer> *input;
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::thread sender;
+
+        std::mutex statMtx;
+        unsigned nFeedback;
+        double sumLatency;
+        double maxLatency;
+
+        Worker* route(unsigned ctrl) {return workers[ctrl%workers.size()].get();}
+        void receive(Worker *w);
+        void latency(Worker *w);
+        // Lets the feedback loops go on without the FEs of w
+        void abandon(Worker *w);
+};
+
+// Processing side, the processing chain itself is built by the caller
+class RemoteWorker {
+    public:
+        RemoteWorker(std::unique_ptr<TcpSocket> sock);
+        ~RemoteWorker();
+
+        bool receiveSetup(json &setup);
+        // Sends the feedback of the loops of s, the summaries of adaptive
+        // loops for the given rx channels, to the readout host
+        void relay(ScanBase *s, const std::vector<unsigned> &channels);
+        // Feeds rawData until the readout host is done, false if the
+        // connection broke
+        bool receiveData(ClipBoard<RawDataContainer> &rawData);
+
+        void sendResult(unsigned channel, HistogramBase &h);
+        void sendConfig(unsigned channel, const json &patch);
+        // Stops relaying and tells the host everything was sent
+        void finish();
+
+    private:
+        RemoteLink link;
+
+        std::mutex mtx;
+        bool finished;
+        std::vector<std::thread> forwarders;
+        std::vector<ClipBoard<OccupancySummary>*> boards;
+};
+
+#endif
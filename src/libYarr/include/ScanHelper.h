@@ -15,6 +15,7 @@
 
 #include "Bookkeeper.h"
 #include "HwController.h"
+#include "MultiController.h"
 #include "FrontEnd.h"
 
 #include "AllHwControllers.h"
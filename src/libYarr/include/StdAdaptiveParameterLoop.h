@@ -0,0 +1,75 @@
+#ifndef STD_ADAPTIVE_PARAMETER_LOOP_H
+#define STD_ADAPTIVE_PARAMETER_LOOP_H
+
+// #################################
+// # Project: Yarr
+// # Description: Named Parameter Loop with adaptive steps
+// # Comment: Walks in coarse steps until most responding pixels are
+// #          above 50% occupancy, goes back to where a 'turnOn' fraction
+// #          of them was not yet and refines to the configured step from
+// #          there, and stops when the occupancy stayed saturated for a
+// #          few steps.
+// #          Decisions use the occupancy summaries of the histogrammers
+// #          and lag the data taking by the processing latency.
+// ################################
+
+#include <map>
+#include <set>
+
+#include "LoopActionBase.h"
+#include "ClipBoard.h"
+#include "OccupancySummary.h"
+#include "FrontEnd.h"
+
+class StdAdaptiveParameterLoop : public LoopActionBase {
+    public:
+        StdAdaptiveParameterLoop();
+
+        void writeConfig(json &j) override;
+        void loadConfig(json &j) override;
+        bool hasFixedSteps() override {return false;}
+
+        // Histogrammer of the FE on rxChannel publishes its summaries in here
+        ClipBoard<OccupancySummary>* summaryBoard(unsigned rxChannel) {
+            return &summaries[rxChannel];
+        }
+
+    private:
+        // Summed over all summaries of one parameter value
+        struct Point {
+            unsigned nHit;
+            unsigned nHalf;
+            unsigned nMax;
+            unsigned maxOcc;
+        };
+
+        std::string parName;
+        unsigned coarseStep;
+        unsigned settle;
+        double turnOn;
+
+        std::map<unsigned, ClipBoard<OccupancySummary>> summaries;
+        // Per rx channel and parameter value
+        std::map<unsigned, std::map<unsigned, Point>> points;
+        // Last value seen per rx channel, earlier values are complete
+        std::map<unsigned, unsigned> lastValue;
+        std::set<unsigned> taken;
+        std::vector<unsigned> outerStat;
+        unsigned loopIndex;
+
+        unsigned m_cur;
+        unsigned m_fine;
+        bool m_refined;
+
+        void writePar();
+        void collect();
+        bool turnedOn(unsigned &value);
+        bool saturated();
+
+        void init() override;
+        void end() override;
+        void execPart1() override;
+        void execPart2() override;
+};
+
+#endif
@@ -6,7 +6,12 @@
  * Date: 2018-May-30
  */
 
+#include <functional>
+#include <thread>
+#include <vector>
+
 #include "ClipBoard.h"
+#include "MultiController.h"
 
 class StdDataAction {
     public:
@@ -15,6 +20,33 @@ class StdDataAction {
         }
     protected:
         ClipBoard<RawDataContainer> *storage;
+
+        // Every controller is read by its own thread
+        struct Source {
+            TxCore *tx;
+            RxCore *rx;
+        };
+        static std::vector<Source> sources(TxCore *tx, RxCore *rx) {
+            MultiController *multi = dynamic_cast<MultiController*>(rx);
+            if (multi == nullptr)
+                return {{tx, rx}};
+            std::vector<Source> s;
+            for (unsigned k=0; k<multi->size(); k++)
+                s.push_back({multi->getController(k), multi->getController(k)});
+            return s;
+        }
+        // Calls f for every source, in parallel if there are several
+        static void forEach(unsigned n, std::function<void(unsigned)> f) {
+            if (n == 1) {
+                f(0);
+                return;
+            }
+            std::vector<std::thread> threads;
+            for (unsigned k=0; k<n; k++)
+                threads.emplace_back(f, k);
+            for (std::thread &t : threads)
+                t.join();
+        }
 };
 
 #endif
@@ -26,6 +26,8 @@ class StdDataGatherer: public LoopActionBase, public StdDataAction {
         void end();
         void execPart1();
         void execPart2();
+        // Reads one controller until its triggers are done
+        void gather(TxCore *tx, RxCore *rx, unsigned ctrl);
         bool killswitch;
 };
 
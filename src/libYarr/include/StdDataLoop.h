@@ -15,10 +15,18 @@ class StdDataLoop: public LoopActionBase, public StdDataAction {
     public:
         StdDataLoop();
         //void connect(ClipBoard<RawDataContainer> *clipboard);
+
+        void writeConfig(json &config);
+        void loadConfig(json &config);
         
     private:
         //ClipBoard<RawDataContainer> *storage;
         unsigned counter;
+        // Read the tail of every stage in the background
+        bool m_pipeline;
+        // Reads until the triggers of the controller are done
+        static unsigned collect(TxCore *tx, RxCore *rx, RawDataContainer &rdc, unsigned &iterations);
+        static unsigned drain(RxCore *rx, RawDataContainer &rdc, unsigned &iterations);
         void init();
         void end();
         void execPart1();
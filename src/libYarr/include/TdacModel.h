@@ -0,0 +1,50 @@
+#ifndef TDACMODEL_H
+#define TDACMODEL_H
+
+// #################################
+// # Project: Yarr
+// # Description: Model based pixel threshold trim
+// # Comment: Estimates the threshold vs. trim slope of every pixel from
+// #          the last two iterations and jumps to the predicted target.
+// #          Only verified in simulation so far, not on hardware.
+// ################################
+
+#include <cstdint>
+#include <vector>
+
+class TdacModel {
+    public:
+        // Deviation of a pixel with no or all injections seen
+        static constexpr double saturated = 10.0;
+        // Deviations within +-window count as on target, same as the
+        // 30% to 70% occupancy band of the sign based tuning
+        static constexpr double window = 0.5244;
+
+        // Distance of the threshold from the injected charge in units of
+        // the noise, positive if the threshold has to go down
+        static double deviation(double occ, unsigned injections);
+        // Sign of the deviation outside of the window
+        static int sign(double dev);
+
+        // Forget the history of all pixels
+        void init(unsigned nPixels);
+        // Called after all pixels of an iteration were updated, pixels
+        // without a history of their own use the average slope of the others
+        void update();
+
+        // Next setting of pixel i, currently at cur and measured at dev. A
+        // positive deviation asks for a larger setting if dir is +1 and for a
+        // smaller one if dir is -1. Without a usable history the pixel moves
+        // by step in the direction of the sign.
+        int next(unsigned i, int cur, double dev, int dir, int step, int min, int max);
+
+    private:
+        std::vector<int8_t> lastValue;
+        std::vector<float> lastDev;
+        std::vector<bool> valid;
+        double slope;
+        double slopeSum;
+        unsigned slopeCnt;
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef TXBROADCASTER_H
+#define TXBROADCASTER_H
+
+// #################################
+// # Project: Yarr
+// # Description: Writes the same commands to many FEs at once
+// # Comment: The commands of every FE are recorded first, each distinct
+// #          sequence is then sent once with all its tx channels enabled
+// ################################
+
+#include <functional>
+#include <vector>
+
+#include "FrontEnd.h"
+#include "TxCore.h"
+
+class TxBroadcaster {
+    public:
+        TxBroadcaster(TxCore *arg_tx);
+
+        // Calls write for every FE with its commands recorded and sends them
+        // grouped by sequence. FEs which can not be recorded are written one
+        // by one, after the groups of the FEs before them. The cmd enable
+        // mask is left on the last group.
+        void write(const std::vector<FrontEnd*> &fes, std::function<void(FrontEnd*)> write);
+
+        // Sequences sent by the last write() and FEs they covered
+        unsigned getNumSent() {return nSent;}
+        unsigned getNumFe() {return nFe;}
+
+    private:
+        TxCore *tx;
+        unsigned nSent;
+        unsigned nFe;
+};
+
+#endif
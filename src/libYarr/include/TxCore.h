@@ -9,6 +9,8 @@
 // # Comment: Transmitter Core
 // ################################
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -28,12 +30,30 @@ class TxCore {
     public:
         // Write to FE interface
         virtual void writeFifo(uint32_t) = 0;
+        // Several words of one command in a single call, controllers
+        // which can move them in one transfer should override this
+        virtual void writeFifoBlock(const uint32_t *words, size_t length) {
+            for (size_t i=0; i<length; i++)
+                this->writeFifo(words[i]);
+        }
         virtual void releaseFifo() = 0;
         virtual void setCmdEnable(uint32_t) = 0;
         virtual void setCmdEnable(std::vector<uint32_t>) = 0;
         virtual uint32_t getCmdEnable() = 0;
         virtual bool isCmdEmpty() = 0;
 
+        // Completion fences: submit() returns a token for everything written
+        // so far, wait() blocks until all of it was sent. By default the
+        // fifo is polled at a growing interval, controllers which can be
+        // notified should override wait().
+        virtual uint64_t submit();
+        virtual void wait(uint64_t token);
+        // Blocks until everything written so far was sent
+        void fence() {this->wait(this->submit());}
+        // Time the FE needs after the commands written so far, a recorder
+        // keeps it for the replay instead of sleeping
+        virtual void pause(unsigned us);
+
         // Word repeater TODO: move to seperate class?
         virtual void setTrigEnable(uint32_t value) = 0;
         virtual uint32_t getTrigEnable() = 0;
@@ -63,6 +83,13 @@ class TxCore {
         ~TxCore();
         uint32_t enMask;
         double m_clk_period;
+
+        // Longest sleep between two polls of the fifo in us
+        static constexpr unsigned maxPollInterval = 100;
+        std::atomic<uint64_t> m_fenceSubmitted;
+        std::atomic<uint64_t> m_fenceDone;
+        // All tokens up to this one were sent
+        void fenceDone(uint64_t token);
 };
 
 #endif
@@ -0,0 +1,47 @@
+#ifndef TXPROGRAMCACHE_H
+#define TXPROGRAMCACHE_H
+
+// #################################
+// # Project: Yarr
+// # Description: Replays command sequences of loop actions
+// # Comment: A sequence is generated once per loop state and replayed
+// #          afterwards, until the register shadow differs
+// ################################
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "FrontEnd.h"
+#include "TxCore.h"
+#include "TxRecorder.h"
+
+class TxProgramCache {
+    public:
+        TxProgramCache();
+
+        // The first call for a key runs gen with the commands of fe recorded
+        // and sends them. Later calls replay the words instead, as long as
+        // the register shadow of fe is what it was before the recording,
+        // and set the shadow to what gen left. gen must not change anything
+        // else of fe. Waits for an empty fifo inside gen are dropped, the
+        // fifo is released where gen released it.
+        void run(FrontEnd *fe, TxCore *tx, uint64_t key, std::function<void()> gen);
+        void clear();
+
+        unsigned getHits() {return nHits;}
+        unsigned getMisses() {return nMisses;}
+
+    private:
+        struct Program {
+            TxRecorder rec;
+            std::vector<uint16_t> before;
+            std::vector<uint16_t> after;
+        };
+        std::map<uint64_t, Program> programs;
+        unsigned nHits;
+        unsigned nMisses;
+};
+
+#endif
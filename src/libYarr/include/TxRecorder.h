@@ -0,0 +1,79 @@
+#ifndef TXRECORDER_H
+#define TXRECORDER_H
+
+// #################################
+// # Project: Yarr
+// # Description: Records the commands of a FE instead of sending them
+// # Comment: Releases of the fifo, waits for it to run empty and pauses
+// #          asked for by the FE are kept, so the sequence can be sent
+// #          later the same way
+// ################################
+
+#include <cstdint>
+#include <vector>
+
+#include "TxCore.h"
+
+class TxRecorder : public TxCore {
+    public:
+        // Point in the sequence where the fifo is released, has to run
+        // empty and is followed by a pause in us
+        struct Mark {
+            size_t pos;
+            unsigned releases;
+            bool wait;
+            unsigned pause;
+            bool operator==(const Mark &o) const {
+                return pos == o.pos && releases == o.releases && wait == o.wait && pause == o.pause;
+            }
+        };
+
+        TxRecorder();
+        ~TxRecorder();
+
+        void clear();
+        // Without waits the sequence is only broken up where the fifo is
+        // released or a pause was asked for
+        void setKeepWaits(bool v) {keepWaits = v;}
+        const std::vector<uint32_t>& getWords() const {return words;}
+        const std::vector<Mark>& getMarks() const {return marks;}
+        bool sameCommands(const TxRecorder &other) const {return words == other.words && marks == other.marks;}
+
+        // Sends the recorded sequence to the currently enabled channels of tx
+        void replay(TxCore *tx) const;
+
+        void writeFifo(uint32_t value) override;
+        void writeFifoBlock(const uint32_t *block, size_t length) override;
+        void releaseFifo() override;
+        void setCmdEnable(uint32_t) override {}
+        void setCmdEnable(std::vector<uint32_t>) override {}
+        uint32_t getCmdEnable() override {return 0;}
+        // Nothing is sent, but the caller wanted the fifo to be empty here
+        bool isCmdEmpty() override;
+        void pause(unsigned us) override;
+
+        void setTrigEnable(uint32_t) override {}
+        uint32_t getTrigEnable() override {return 0;}
+        void maskTrigEnable(uint32_t, uint32_t) override {}
+        bool isTrigDone() override {return true;}
+        void setTrigConfig(enum TRIG_CONF_VALUE) override {}
+        void setTrigFreq(double) override {}
+        void setTrigCnt(uint32_t) override {}
+        void setTrigTime(double) override {}
+        void setTrigWordLength(uint32_t) override {}
+        void setTrigWord(uint32_t*, uint32_t) override {}
+        void toggleTrigAbort() override {}
+        void setTriggerLogicMask(uint32_t) override {}
+        void setTriggerLogicMode(enum TRIG_LOGIC_MODE_VALUE) override {}
+        void resetTriggerLogic() override {}
+        uint32_t getTrigInCount() override {return 0;}
+
+    private:
+        bool keepWaits;
+        std::vector<uint32_t> words;
+        std::vector<Mark> marks;
+
+        Mark& addMark();
+};
+
+#endif
@@ -7,6 +7,7 @@
 
 
 #include "Fei4.h"
+#include "RegisterReadback.h"
 
 #include "storage.hpp"
 
@@ -86,35 +87,18 @@ int main(int argc, char *argv[]) {
 
   //----------------------------------------------------------------
   // check Global registers
+  // The answers of each batch of reads are collected before the next one is sent
+  std::vector<unsigned> addrs;
+  for (unsigned i=0; i< fe.numRegs; i++)
+    addrs.push_back(i);
+  RegisterReadback readback(&mySpec, &mySpec);
+  std::map<unsigned, uint16_t> values = readback.read({&fe}, addrs)[fe.getRxChannel()];
   for (unsigned i=0; i< fe.numRegs; i++) {
-    if(verbose)
-      std::cout << "Reading reg: " << i << std::endl;
-    fe.readRegister(i);
-    usleep(1000);
-    while(!mySpec.isCmdEmpty()) {}
     dummy.cfg[i] = 0xDEAD;
-    RawData *data = mySpec.readData();
-    while(!mySpec.isCmdEmpty()) {}
-    while (data != NULL) {
-      if (data != NULL) {
-	uint32_t greg = 99;
-	uint32_t value = 0;
-	for (unsigned j=0; j<data->words;j++) {
-	  if(verbose)
-	    std::cout << "[" << j << "] = 0x" << std::hex << data->buf[j] << std::dec << std::endl;
-	  if ((data->buf[j] & 0x00FF0000) == 0x00ea0000) {
-	    greg = (data->buf[j] & 0x0000FFFF);
-	  }
-	  if ((data->buf[j] & 0x00FF0000) == 0x00ec0000) {
-	    value = (data->buf[j] & 0x0000FFFF);
-	  }
-	  dummy.cfg[greg] = value;
-	}
-      }
-      delete data;
-      data = mySpec.readData();
-      while(!mySpec.isCmdEmpty()) {}
-    }
+    if (values.find(i) != values.end())
+      dummy.cfg[i] = values[i];
+    if(verbose)
+      std::cout << "Reg " << i << " = 0x" << std::hex << dummy.cfg[i] << std::dec << std::endl;
   }
   dummy.toFileJson(replica);
 
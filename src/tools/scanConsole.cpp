@@ -19,6 +19,7 @@
 #include <cctype> //w'space detection
 #include <ctime>
 #include <map>
+#include <algorithm>
 #include <sstream>
 
 #include "ScanHelper.h"
@@ -33,8 +34,12 @@
 #include "Fei4.h"
 #include "ScanBase.h"
 #include "ScanFactory.h"
+#include "TxBroadcaster.h"
+#include "RegisterReadback.h"
+#include "RemoteProcessing.h"
 #include "Fei4DataProcessor.h"
 #include "Fei4Histogrammer.h"
+#include "Fei4EventBuilder.h"
 #include "Fei4Analysis.h"
 
 #include "DBHandler.h"
@@ -64,11 +69,24 @@ std::unique_ptr<ScanBase> buildScan( const std::string& scanType, Bookkeeper& bo
 // In order to build Histogrammer, bookie is not needed --> good sign!
 // Do not want to use the raw pointer ScanBase*
 void buildHistogrammers( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& histogrammers, const std::string& scanType, std::vector<FrontEnd*>& feList, ScanBase* s, std::string outputDir);
+void addHistogrammer(Fei4Histogrammer &histogrammer, const std::string &algo_name, json &algo_cfg, const std::string &prefix);
+
+// Module event builder and its histogrammer, only if the scan config asks for it
+void buildEventBuilder(std::unique_ptr<Fei4EventBuilder> &builder, std::unique_ptr<Fei4Histogrammer> &moduleHistogrammer, std::map<unsigned, ClipBoard<EventDataBase> > &builderInput, ClipBoard<EventDataBase> &moduleData, ClipBoard<HistogramBase> &moduleHisto, const std::string &scanType, Bookkeeper &bookie, std::string outputDir);
+void saveModuleHistos(ClipBoard<HistogramBase> &moduleHisto, const std::string &outputDir, bool doPlots);
 
 // In order to build Analysis, bookie is needed --> deep dependency!
 // Do not want to use the raw pointer ScanBase*
 void buildAnalyses( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& analyses, const std::string& scanType, Bookkeeper& bookie, ScanBase* s, int mask_opt);
 
+// Run the analysis on the histograms archived in a previous run, no hardware needed
+int reanalyse(const std::string &runDir, json &runLog, const std::string &scanType, const std::string &outputDir, bool doPlots, int mask_opt, json &scanLog);
+
+// Process the data of a scan for the readout host at the other end of sock
+int runWorker(std::unique_ptr<TcpSocket> sock, const std::string &dataDir, bool sharedDir);
+// Serve readout hosts, one scan after the other
+int serveWorker(unsigned port, const std::string &dataDir);
+
 
 int main(int argc, char *argv[]) {
     std::cout << "\033[1;31m#####################################\033[0m" << std::endl;
@@ -84,11 +102,15 @@ int main(int argc, char *argv[]) {
     std::string scanType = "";
     std::vector<std::string> cConfigPaths;
     std::string outputDir = "./data/";
-    std::string ctrlCfgPath = "";
+    std::vector<std::string> ctrlCfgPaths;
     bool doPlots = false;
+    bool doVerify = false;
     int target_charge = -1;
     int target_tot = -1;
     int mask_opt = -1;
+    std::string reanaDir = "";
+    std::vector<std::string> workerAddrs;
+    int workerPort = -1;
 
     bool dbUse = false;
     std::string dbDirPath = home+"/.yarr/localdb";
@@ -120,7 +142,7 @@ int main(int argc, char *argv[]) {
     oF.close();
 
     int c;
-    while ((c = getopt(argc, argv, "hks:n:m:g:r:c:t:po:Wd:u:i:")) != -1) {
+    while ((c = getopt(argc, argv, "hks:n:m:g:r:c:t:pvo:Wd:u:i:a:x:l:")) != -1) {
         int count = 0;
         switch (c) {
             case 'h':
@@ -145,11 +167,17 @@ int main(int argc, char *argv[]) {
                 }
                 break;
             case 'r':
-                ctrlCfgPath = std::string(optarg);
+                optind -= 1; // same as -c, one config per controller
+                for(; optind < argc && *argv[optind] != '-'; optind += 1){
+                    ctrlCfgPaths.push_back(std::string(argv[optind]));
+                }
                 break;
             case 'p':
                 doPlots = true;
                 break;
+            case 'v':
+                doVerify = true;
+                break;
             case 'o':
                 outputDir = std::string(optarg);
                 if (outputDir.back() != '/')
@@ -173,6 +201,20 @@ int main(int argc, char *argv[]) {
                     count++;
                 }
                 break;
+            case 'a':
+                reanaDir = std::string(optarg);
+                if (reanaDir.back() != '/')
+                    reanaDir = reanaDir + "/";
+                break;
+            case 'x':
+                optind -= 1; // same as -c, one address per worker
+                for(; optind < argc && *argv[optind] != '-'; optind += 1){
+                    workerAddrs.push_back(std::string(argv[optind]));
+                }
+                break;
+            case 'l':
+                workerPort = atoi(optarg);
+                break;
             case 'W': // Write to DB
                 dbUse = true;
                 break;
@@ -204,7 +246,29 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    if (cConfigPaths.size() == 0) {
+    // Workers get everything else from the readout host
+    if (workerPort >= 0) {
+        return serveWorker(workerPort, outputDir);
+    }
+
+    // Everything else needed for a re-analysis comes from the earlier run
+    json reanaLog;
+    if (!reanaDir.empty()) {
+        try {
+            reanaLog = ScanHelper::openJsonFile(reanaDir + "scanLog.json");
+        } catch (std::runtime_error &e) {
+            std::cerr << "#ERROR# opening scan log of run to re-analyse: " << e.what() << std::endl;
+            return -1;
+        }
+        if (scanType == "")
+            scanType = reanaDir + std::string(reanaLog["testType"]) + ".json";
+        if (target_charge == -1)
+            target_charge = reanaLog["targetCharge"];
+        if (target_tot == -1)
+            target_tot = reanaLog["targetTot"];
+    }
+
+    if (cConfigPaths.size() == 0 && reanaDir.empty()) {
         std::cerr << "Error: no config files given, please specify config file name under -c option, even if file does not exist!" << std::endl;
         return -1;
     }
@@ -278,6 +342,10 @@ int main(int argc, char *argv[]) {
     scanLog["targetTot"] = target_tot;
     scanLog["testType"] = strippedScan;
 
+    if (!reanaDir.empty()) {
+        return reanalyse(reanaDir, reanaLog, scanType, outputDir, doPlots, mask_opt, scanLog);
+    }
+
     // Initial setting local DBHandler
     DBHandler *database = new DBHandler();
     if (dbUse) {
@@ -310,11 +378,19 @@ int main(int argc, char *argv[]) {
     std::cout << "\033[1;31m# Init Hardware #\033[0m" << std::endl;
     std::cout << "\033[1;31m#################\033[0m" << std::endl;
 
-    std::cout << "-> Opening controller config: " << ctrlCfgPath << std::endl;
     std::unique_ptr<HwController> hwCtrl = nullptr;
     json ctrlCfg;
     try {
-        ctrlCfg = ScanHelper::openJsonFile(ctrlCfgPath);
+        if (ctrlCfgPaths.empty())
+            throw std::runtime_error("no controller config given");
+        // Several controllers are loaded from a list of configs
+        for (std::string const& sTmp : ctrlCfgPaths) {
+            std::cout << "-> Opening controller config: " << sTmp << std::endl;
+            if (ctrlCfgPaths.size() == 1)
+                ctrlCfg = ScanHelper::openJsonFile(sTmp);
+            else
+                ctrlCfg.push_back(ScanHelper::openJsonFile(sTmp));
+        }
         hwCtrl = ScanHelper::loadController(ctrlCfg);
     } catch (std::runtime_error &e) {
         std::cerr << "#ERROR# opening or loading controller config: " << e.what() << std::endl;
@@ -395,16 +471,18 @@ int main(int argc, char *argv[]) {
     std::cout << "\033[1;31m#################\033[0m" << std::endl;
     
     std::chrono::steady_clock::time_point cfg_start = std::chrono::steady_clock::now();
-    for ( FrontEnd* fe : bookie.feList ) {
+    // FEs with identical configs are configured together
+    TxBroadcaster broadcaster(hwCtrl.get());
+    broadcaster.write(bookie.feList, [](FrontEnd *fe) {
         std::cout << "-> Configuring " << dynamic_cast<FrontEndCfg*>(fe)->getName() << std::endl;
-        // Select correct channel
-        hwCtrl->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
-        // Configure
         fe->configure();
-        // Wait for fifo to be empty
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
-        while(!hwCtrl->isCmdEmpty());
-    }
+    });
+    // Wait for fifo to be empty
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    hwCtrl->fence();
+    if (broadcaster.getNumSent() < broadcaster.getNumFe())
+        std::cout << "-> " << broadcaster.getNumFe() << " FEs configured with "
+            << broadcaster.getNumSent() << " command sequences" << std::endl;
     std::chrono::steady_clock::time_point cfg_end = std::chrono::steady_clock::now();
     std::cout << "-> All FEs configured in " 
         << std::chrono::duration_cast<std::chrono::milliseconds>(cfg_end-cfg_start).count() << " ms !" << std::endl;
@@ -413,14 +491,18 @@ int main(int argc, char *argv[]) {
     // TODO Check RX sync
     std::this_thread::sleep_for(std::chrono::microseconds(1000));
     hwCtrl->flushBuffer();
-    for ( FrontEnd* fe : bookie.feList ) {
-        std::cout << "-> Checking com " << dynamic_cast<FrontEndCfg*>(fe)->getName() << std::endl;
-        // Select correct channel
-        hwCtrl->setCmdEnable(dynamic_cast<FrontEndCfg*>(fe)->getTxChannel());
-        hwCtrl->setRxEnable(dynamic_cast<FrontEndCfg*>(fe)->getRxChannel());
-        // Configure
-        if (fe->checkCom() != 1) {
-            std::cout << "#ERROR# Can't establish communication, aborting!" << std::endl;
+    // All FEs are read at once
+    RegisterReadback readback(hwCtrl.get(), hwCtrl.get());
+    std::cout << "-> Checking com of " << bookie.feList.size() << " FEs" << std::endl;
+    if (!readback.checkCom(bookie.feList)) {
+        std::cout << "#ERROR# Can't establish communication, aborting!" << std::endl;
+        return -1;
+    }
+    std::cout <<   "... success!" << std::endl;
+    if (doVerify) {
+        std::cout << "-> Verifying global registers" << std::endl;
+        if (!readback.verify(bookie.feList)) {
+            std::cout << "#ERROR# Global registers differ from the configs, aborting!" << std::endl;
             return -1;
         }
         std::cout <<   "... success!" << std::endl;
@@ -470,9 +552,73 @@ int main(int argc, char *argv[]) {
     std::map<FrontEnd*, std::unique_ptr<DataProcessor> > histogrammers;
     std::map<FrontEnd*, std::unique_ptr<DataProcessor> > analyses;
 
-    // TODO not to use the raw pointer!
-    buildHistogrammers( histogrammers, scanType, bookie.feList, s.get(), outputDir);
-    buildAnalyses( analyses, scanType, bookie, s.get(), mask_opt);
+    std::unique_ptr<Fei4EventBuilder> builder;
+    std::unique_ptr<Fei4Histogrammer> moduleHistogrammer;
+    std::map<unsigned, ClipBoard<EventDataBase> > builderInput;
+    ClipBoard<EventDataBase> moduleData;
+    ClipBoard<HistogramBase> moduleHisto;
+
+    // With workers the processing chain runs there, only the raw data
+    // leaves this process
+    std::shared_ptr<RemoteHost> remote;
+    std::thread localWorker;
+    if (!workerAddrs.empty()) {
+        std::cout << "-> Handing the data processing to " << workerAddrs.size() << " worker(s)" << std::endl;
+        TcpSocket listener;
+        for (std::string &addr : workerAddrs) {
+            if (addr != "local")
+                continue;
+            // Analyses share static state, one worker per process
+            if (listener.isOpen() || !listener.listen(0, true)) {
+                std::cerr << "#ERROR# Only one local worker can be started!" << std::endl;
+                return -1;
+            }
+            addr = "127.0.0.1:" + std::to_string(listener.getPort());
+        }
+
+        json setup;
+        setup["chipType"] = chipType;
+        setup["testType"] = strippedScan;
+        setup["runNumber"] = runCounter;
+        setup["outputDir"] = outputDir;
+        setup["targetTot"] = target_tot;
+        setup["targetCharge"] = target_charge;
+        setup["maskOpt"] = mask_opt;
+        try {
+            setup["scan"] = ScanHelper::openJsonFile(scanType);
+        } catch (std::runtime_error &e) {
+            std::cerr << "#ERROR# opening scan config: " << e.what() << std::endl;
+            return -1;
+        }
+
+        remote.reset(new RemoteHost(&bookie, s.get()));
+        bool ok = remote->connectWorkers(workerAddrs);
+        // The connection is already queued, the worker thread owns its end
+        if (ok && listener.isOpen()) {
+            std::unique_ptr<TcpSocket> sock = listener.accept();
+            if (sock) {
+                localWorker = std::thread([outputDir] (std::unique_ptr<TcpSocket> sock) {
+                    runWorker(std::move(sock), outputDir, true);
+                }, std::move(sock));
+            } else {
+                ok = false;
+            }
+        }
+        listener.close();
+        ok = ok && remote->setup(setup);
+        if (!ok) {
+            std::cerr << "#ERROR# Could not set up the workers, aborting!" << std::endl;
+            remote.reset();
+            if (localWorker.joinable())
+                localWorker.join();
+            return -1;
+        }
+    } else {
+        // TODO not to use the raw pointer!
+        buildHistogrammers( histogrammers, scanType, bookie.feList, s.get(), outputDir);
+        buildAnalyses( analyses, scanType, bookie, s.get(), mask_opt);
+        buildEventBuilder(builder, moduleHistogrammer, builderInput, moduleData, moduleHisto, scanType, bookie, outputDir);
+    }
 
     std::cout << "-> Running pre scan!" << std::endl;
     s->init();
@@ -481,7 +627,7 @@ int main(int argc, char *argv[]) {
     // Run from downstream to upstream
     std::cout << "-> Starting histogrammer and analysis threads:" << std::endl;
     for ( FrontEnd* fe : bookie.feList ) {
-        if (fe->isActive()) {
+        if (fe->isActive() && !remote) {
           analyses[fe]->init();
           analyses[fe]->run();
           
@@ -492,9 +638,27 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    std::shared_ptr<DataProcessor> proc = StdDict::getDataProcessor(chipType);
+    // The event builder sits between the processor and the histogrammers
+    if (builder) {
+        moduleHistogrammer->init();
+        moduleHistogrammer->run();
+        builder->init();
+        builder->run();
+        std::cout << "  -> Event builder thread" << std::endl;
+    }
+
+    std::shared_ptr<DataProcessor> proc;
+    if (remote) {
+        proc = remote;
+    } else {
+        proc = StdDict::getDataProcessor(chipType);
+    }
     //Fei4DataProcessor proc(bookie.globalFe<Fei4>()->getValue(&Fei4::HitDiscCnfg));
-    proc->connect( &bookie.rawData, &bookie.eventMap );
+    if (builder) {
+        proc->connect( &bookie.rawData, &builderInput );
+    } else {
+        proc->connect( &bookie.rawData, &bookie.eventMap );
+    }
     proc->init();
     proc->run();
 
@@ -518,8 +682,15 @@ int main(int argc, char *argv[]) {
 
     std::chrono::steady_clock::time_point scan_done = std::chrono::steady_clock::now();
     std::cout << "-> Waiting for processors to finish ..." << std::endl;
-    // Join Fei4DataProcessor
+    // Join Fei4DataProcessor, or wait for the results of the workers
     proc->join();
+    if (localWorker.joinable()) {
+        localWorker.join();
+    }
+    if (builder) {
+        builder->scanDone = true;
+        builder->join();
+    }
     std::chrono::steady_clock::time_point processor_done = std::chrono::steady_clock::now();
     
     std::cout << "-> Processor done, waiting for histogrammer ..." << std::endl;
@@ -533,10 +704,17 @@ int main(int argc, char *argv[]) {
         }
     }
     
+    if (moduleHistogrammer) {
+        moduleData.cv.notify_all();
+    }
+
     // Join histogrammers
     for( auto& histogrammer : histogrammers ) {
       histogrammer.second->join();
     }
+    if (moduleHistogrammer) {
+        moduleHistogrammer->join();
+    }
     
     std::cout << "-> Processor done, waiting for analysis ..." << std::endl;
     
@@ -577,6 +755,13 @@ int main(int argc, char *argv[]) {
     scanLog["stopwatch"]["processing"] = std::chrono::duration_cast<std::chrono::milliseconds>(processor_done-scan_done).count();
     scanLog["stopwatch"]["analysis"] = std::chrono::duration_cast<std::chrono::milliseconds>(all_done-processor_done).count();
 
+    if (remote) {
+        std::cout << "-> Feedback:      " << remote->getNumFeedback() << " messages, " << std::fixed << std::setprecision(2)
+            << remote->getMeanLatency() << " ms mean and " << remote->getMaxLatency() << " ms max after the data" << std::endl;
+        scanLog["stopwatch"]["feedbackMean"] = remote->getMeanLatency();
+        scanLog["stopwatch"]["feedbackMax"] = remote->getMaxLatency();
+    }
+
     std::cout << std::endl;
     std::cout << "\033[1;31m###########\033[0m" << std::endl;
     std::cout << "\033[1;31m# Cleanup #\033[0m" << std::endl;
@@ -643,6 +828,10 @@ int main(int argc, char *argv[]) {
             }
         }
     }
+    // Module histograms are always written, they are not kept anywhere else
+    if (moduleHistogrammer) {
+        saveModuleHistos(moduleHisto, outputDir, doPlots);
+    }
     std::string lsCmd = "ls -1 " + dataDir + "last_scan/*.p*";
     std::cout << "Finishing run: " << runCounter << std::endl;
     if(doPlots && (system(lsCmd.c_str()) < 0)) {
@@ -669,9 +858,10 @@ void printHelp() {
     //std::cout << " -n: Provide SPECboard number." << std::endl;
     //std::cout << " -g <cfg_list.txt>: Provide list of chip configurations." << std::endl;
     std::cout << " -c <connectivity.json> [<cfg2.json> ...]: Provide connectivity configuration, can take multiple arguments." << std::endl;
-    std::cout << " -r <ctrl.json> Provide controller configuration." << std::endl;
+    std::cout << " -r <ctrl.json> [<ctrl2.json> ...]: Provide controller configuration, with several the chips select theirs with \"controller\" in the connectivity." << std::endl;
     std::cout << " -t <target_charge> [<tot_target>] : Set target values for threshold/charge (and tot)." << std::endl;
     std::cout << " -p: Enable plotting of results." << std::endl;
+    std::cout << " -v: Read back the global registers after configuring and compare them with the configs." << std::endl;
     std::cout << " -o <dir> : Output directory. (Default ./data/)" << std::endl;
     std::cout << " -m <int> : 0 = pixel masking disabled, 1 = start with fresh pixel mask, default = pixel masking enabled" << std::endl;
     std::cout << " -k: Report known items (Scans, Hardware etc.)\n";
@@ -679,6 +869,9 @@ void printHelp() {
     std::cout << " -d <database.json> : Provide database configuration. (Default " << dbDirPath << "/" << hostname << "_database.json" << std::endl;
     std::cout << " -i <site.json> : Provide site configuration." << std::endl;
     std::cout << " -u <user.json> : Provide user configuration." << std::endl;
+    std::cout << " -a <run_dir> : Re-analyse the histograms archived (HistogramArchiver) in a previous run, optionally with a modified scan config given by -s." << std::endl;
+    std::cout << " -x <host:port> [<host2:port> ...] : Process the data on workers started with -l, \"local\" starts one in this process." << std::endl;
+    std::cout << " -l <port> : Run as worker processing the data of scans for readout hosts, results go below -o." << std::endl;
 }
 
 void listChips() {
@@ -767,34 +960,46 @@ void buildHistogrammers( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& hi
 
             histogrammer.connect(fe->clipData, fe->clipHisto);
 
-            auto add_histo = [&](std::string algo_name) {
-                if (algo_name == "OccupancyMap") {
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                    histogrammer.addHistogrammer(new OccupancyMap());
-                } else if (algo_name == "TotMap") {
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                    histogrammer.addHistogrammer(new TotMap());
-                } else if (algo_name == "Tot2Map") {
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                    histogrammer.addHistogrammer(new Tot2Map());
-                } else if (algo_name == "L1Dist") {
-                    histogrammer.addHistogrammer(new L1Dist());
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                } else if (algo_name == "HitsPerEvent") {
-                    histogrammer.addHistogrammer(new HitsPerEvent());
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                } else if (algo_name == "DataArchiver") {
-                    histogrammer.addHistogrammer(new DataArchiver((outputDir + dynamic_cast<FrontEndCfg*>(fe)->getName() + "_data.raw")));
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                } else if (algo_name == "Tot3d") {
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                    histogrammer.addHistogrammer(new Tot3d());
-                } else if (algo_name == "L13d") {
-                    std::cout << "  ... adding " << algo_name << std::endl;
-                    histogrammer.addHistogrammer(new L13d());
-                } else {
-                    std::cerr << "#ERROR# Histogrammer \"" << algo_name << "\" unknown, skipping!" << std::endl;
+            // Adaptive loops steer on the occupancy seen by the histogrammer
+            unsigned injections = 0;
+            for (unsigned n=0; n<s->size(); n++) {
+                std::shared_ptr<LoopActionBase> l = s->getLoop(n);
+                if (l->type() == typeid(Fei4TriggerLoop*))
+                    injections = std::static_pointer_cast<Fei4TriggerLoop>(l)->getTrigCnt();
+                if (l->type() == typeid(Fe65p2TriggerLoop*))
+                    injections = std::static_pointer_cast<Fe65p2TriggerLoop>(l)->getTrigCnt();
+                if (l->type() == typeid(Rd53aTriggerLoop*))
+                    injections = std::static_pointer_cast<Rd53aTriggerLoop>(l)->getTrigCnt();
+            }
+            for (unsigned n=0; n<s->size(); n++) {
+                std::shared_ptr<LoopActionBase> l = s->getLoop(n);
+                if (l->type() == typeid(StdAdaptiveParameterLoop*)) {
+                    unsigned rx = dynamic_cast<FrontEndCfg*>(fe)->getRxChannel();
+                    histogrammer.connectSummary(std::static_pointer_cast<StdAdaptiveParameterLoop>(l)->summaryBoard(rx), injections);
                 }
+            }
+
+            // Long running scans write intermediate maps
+            json liveCfg = scanCfg["scan"]["live"];
+            if (!liveCfg.empty()) {
+                unsigned interval = 60;
+                unsigned window = 10;
+                if (!liveCfg["interval"].empty())
+                    interval = liveCfg["interval"];
+                if (!liveCfg["window"].empty())
+                    window = liveCfg["window"];
+                std::unique_ptr<LiveHistogrammer> live(new LiveHistogrammer(dynamic_cast<FrontEndCfg*>(fe)->getName(), outputDir, interval, window));
+                if (!liveCfg["keep"].empty())
+                    live->setKeep(liveCfg["keep"]);
+                if (!liveCfg["plot"].empty())
+                    live->setPlot(liveCfg["plot"]);
+                std::cout << "  ... writing live maps every " << interval << " s over " << window << " intervals" << std::endl;
+                histogrammer.live(std::move(live));
+            }
+
+            std::string prefix = outputDir + dynamic_cast<FrontEndCfg*>(fe)->getName();
+            auto add_histo = [&](std::string algo_name, json &algo_cfg) {
+                addHistogrammer(histogrammer, algo_name, algo_cfg, prefix);
             };
 
             try {
@@ -802,13 +1007,13 @@ void buildHistogrammers( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& hi
 
                 for (int j=0; j<nHistos; j++) {
                     std::string algo_name = histoCfg[std::to_string(j)]["algorithm"];
-                    add_histo(algo_name);
+                    add_histo(algo_name, histoCfg[std::to_string(j)]);
                 }
             } catch(json::type_error &te) {
                 int nHistos = histoCfg.size();
                 for (int j=0; j<nHistos; j++) {
                     std::string algo_name = histoCfg[j]["algorithm"];
-                    add_histo(algo_name);
+                    add_histo(algo_name, histoCfg[j]);
                 }
             }
             histogrammer.setMapSize(fe->geo.nCol, fe->geo.nRow);
@@ -817,6 +1022,136 @@ void buildHistogrammers( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& hi
 }
 
 
+void addHistogrammer(Fei4Histogrammer &histogrammer, const std::string &algo_name, json &algo_cfg, const std::string &prefix) {
+    if (algo_name == "OccupancyMap") {
+        std::cout << "  ... adding " << algo_name << std::endl;
+        histogrammer.addHistogrammer(new OccupancyMap());
+    } else if (algo_name == "TotMap") {
+        std::cout << "  ... adding " << algo_name << std::endl;
+        histogrammer.addHistogrammer(new TotMap());
+    } else if (algo_name == "Tot2Map") {
+        std::cout << "  ... adding " << algo_name << std::endl;
+        histogrammer.addHistogrammer(new Tot2Map());
+    } else if (algo_name == "L1Dist") {
+        histogrammer.addHistogrammer(new L1Dist());
+        std::cout << "  ... adding " << algo_name << std::endl;
+    } else if (algo_name == "HitsPerEvent") {
+        histogrammer.addHistogrammer(new HitsPerEvent());
+        std::cout << "  ... adding " << algo_name << std::endl;
+    } else if (algo_name == "DataArchiver") {
+        histogrammer.addHistogrammer(new DataArchiver((prefix + "_data.raw")));
+        std::cout << "  ... adding " << algo_name << std::endl;
+    } else if (algo_name == "HistogramArchiver") {
+        histogrammer.archive(prefix + "_histos.bin");
+        std::cout << "  ... adding " << algo_name << std::endl;
+    } else if (algo_name == "Tot3d") {
+        std::cout << "  ... adding " << algo_name << std::endl;
+        histogrammer.addHistogrammer(new Tot3d());
+    } else if (algo_name == "L13d") {
+        std::cout << "  ... adding " << algo_name << std::endl;
+        histogrammer.addHistogrammer(new L13d());
+    } else if (algo_name == "ClusterSizeMap") {
+        std::cout << "  ... adding " << algo_name << std::endl;
+        ClusterSizeMap *algo = new ClusterSizeMap();
+        if (!algo_cfg["gap"].empty())
+            algo->setGap(algo_cfg["gap"]);
+        histogrammer.addHistogrammer(algo);
+    } else if (algo_name == "ClusterShapeMap") {
+        std::cout << "  ... adding " << algo_name << std::endl;
+        ClusterShapeMap *algo = new ClusterShapeMap();
+        if (!algo_cfg["gap"].empty())
+            algo->setGap(algo_cfg["gap"]);
+        histogrammer.addHistogrammer(algo);
+    } else {
+        std::cerr << "#ERROR# Histogrammer \"" << algo_name << "\" unknown, skipping!" << std::endl;
+    }
+}
+
+void buildEventBuilder(std::unique_ptr<Fei4EventBuilder> &builder, std::unique_ptr<Fei4Histogrammer> &moduleHistogrammer, std::map<unsigned, ClipBoard<EventDataBase> > &builderInput, ClipBoard<EventDataBase> &moduleData, ClipBoard<HistogramBase> &moduleHisto, const std::string &scanType, Bookkeeper &bookie, std::string outputDir) {
+    json scanCfg;
+    try {
+        scanCfg = ScanHelper::openJsonFile(scanType);
+    } catch (std::runtime_error &e) {
+        std::cerr << "#ERROR# opening scan config: " << e.what() << std::endl;
+        throw("buildEventBuilder failure");
+    }
+    json builderCfg = scanCfg["scan"]["eventbuilder"];
+    if (builderCfg.empty())
+        return;
+
+    std::cout << "-> Found event builder config, merging FE events into module events ..." << std::endl;
+    builder.reset(new Fei4EventBuilder());
+    if (!builderCfg["window"].empty())
+        builder->setWindow(builderCfg["window"]);
+
+    // The processor fills one input per channel, same as the event map
+    for (auto &ch : bookie.eventMap)
+        builderInput[ch.first];
+    builder->connect(&builderInput, &bookie.eventMap, &moduleData);
+
+    // Chips are placed side by side along the columns unless a layout with
+    // the column and row offset of every active FE is given
+    unsigned nCol = 0;
+    unsigned nRow = 0;
+    unsigned n = 0;
+    for (FrontEnd *fe : bookie.feList) {
+        if (!fe->isActive())
+            continue;
+        unsigned colOffset = n*fe->geo.nCol;
+        unsigned rowOffset = 0;
+        if (!builderCfg["layout"].empty() && n < builderCfg["layout"].size()) {
+            colOffset = builderCfg["layout"][n][0];
+            rowOffset = builderCfg["layout"][n][1];
+        }
+        builder->addChannel(dynamic_cast<FrontEndCfg*>(fe)->getRxChannel(), colOffset, rowOffset);
+        nCol = std::max(nCol, colOffset + fe->geo.nCol);
+        nRow = std::max(nRow, rowOffset + fe->geo.nRow);
+        n++;
+    }
+
+    std::cout << "-> Loading module histogrammer ..." << std::endl;
+    moduleHistogrammer.reset(new Fei4Histogrammer());
+    moduleHistogrammer->connect(&moduleData, &moduleHisto);
+    for (unsigned j=0; j<builderCfg["histogrammer"].size(); j++) {
+        std::string algo_name = builderCfg["histogrammer"][j]["algorithm"];
+        addHistogrammer(*moduleHistogrammer, algo_name, builderCfg["histogrammer"][j], outputDir + "module");
+    }
+    moduleHistogrammer->setMapSize(nCol, nRow);
+}
+
+void saveModuleHistos(ClipBoard<HistogramBase> &moduleHisto, const std::string &outputDir, bool doPlots) {
+    // One histogram per data container, sum them up per name
+    std::vector<std::unique_ptr<HistogramBase>> sums;
+    while (!moduleHisto.empty()) {
+        std::unique_ptr<HistogramBase> h = moduleHisto.popData();
+        if (h == nullptr)
+            continue;
+        bool added = false;
+        for (auto &sum : sums) {
+            if (sum->getName() != h->getName())
+                continue;
+            if (Histo1d *h1 = dynamic_cast<Histo1d*>(sum.get())) {
+                h1->add(*dynamic_cast<Histo1d*>(h.get()));
+            } else if (Histo2d *h2 = dynamic_cast<Histo2d*>(sum.get())) {
+                h2->add(*dynamic_cast<Histo2d*>(h.get()));
+            } else if (Histo3d *h3 = dynamic_cast<Histo3d*>(sum.get())) {
+                h3->add(*dynamic_cast<Histo3d*>(h.get()));
+            }
+            added = true;
+            break;
+        }
+        if (!added)
+            sums.push_back(std::move(h));
+    }
+
+    std::cout << "-> Saving " << sums.size() << " module histograms" << std::endl;
+    for (auto &sum : sums) {
+        if (doPlots)
+            sum->plot("module", outputDir);
+        sum->toFile("module", outputDir);
+    }
+}
+
 void buildAnalyses( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& analyses, const std::string& scanType, Bookkeeper& bookie, ScanBase* s, int mask_opt) {
     if (scanType.find("json") != std::string::npos) {
         std::cout << "-> Found Scan config, loading analysis ..." << std::endl;
@@ -857,6 +1192,9 @@ void buildAnalyses( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& analyse
                      } else if (algo_name == "ScurveFitter") {
                         std::cout << "  ... adding " << algo_name << std::endl;
                         ana.addAlgorithm(new ScurveFitter());
+                     } else if (algo_name == "ScurveMoments") {
+                        std::cout << "  ... adding " << algo_name << std::endl;
+                        ana.addAlgorithm(new ScurveMoments());
                      } else if (algo_name == "OccGlobalThresholdTune") {
                         std::cout << "  ... adding " << algo_name << std::endl;
                         ana.addAlgorithm(new OccGlobalThresholdTune());
@@ -896,3 +1234,295 @@ void buildAnalyses( std::map<FrontEnd*, std::unique_ptr<DataProcessor>>& analyse
         }
     } 
 }
+
+int reanalyse(const std::string &runDir, json &runLog, const std::string &scanType, const std::string &outputDir, bool doPlots, int mask_opt, json &scanLog) {
+    std::cout << std::endl;
+    std::cout << "\033[1;31m##############\033[0m" << std::endl;
+    std::cout << "\033[1;31m# Re-analyse #\033[0m" << std::endl;
+    std::cout << "\033[1;31m##############\033[0m" << std::endl;
+    std::cout << "-> Re-analysing run in " << runDir << std::endl;
+
+    Bookkeeper bookie(nullptr, nullptr);
+    bookie.setTargetTot(scanLog["targetTot"]);
+    bookie.setTargetCharge(scanLog["targetCharge"]);
+
+    // Chips as they were configured at the start of the run
+    std::string chipType;
+    for (auto &config : runLog["connectivity"]) {
+        chipType = config["chipType"];
+        for (auto &chip : config["chips"]) {
+            if (chip["enable"] == 0)
+                continue;
+            bookie.addFe(StdDict::getFrontEnd(chipType).release(), chip["tx"], chip["rx"]);
+            FrontEnd *fe = bookie.getLastFe();
+            fe->setActive(true);
+            FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(fe);
+            std::string chipConfigPath = chip["config"];
+            std::string configFile = chipConfigPath.substr(chipConfigPath.find_last_of("/"));
+            std::string cfgPath = runDir + configFile + ".before";
+            json cfg;
+            try {
+                cfg = ScanHelper::openJsonFile(cfgPath);
+            } catch (std::runtime_error &e) {
+                std::cerr << "#ERROR# opening chip config " << cfgPath << ": " << e.what() << std::endl;
+                return -1;
+            }
+            feCfg->fromFileJson(cfg);
+            feCfg->setConfigFile(configFile);
+            std::cout << "-> Loaded " << feCfg->getName() << " from " << cfgPath << std::endl;
+        }
+    }
+    if (bookie.feList.empty()) {
+        std::cerr << "#ERROR# No chips found in the scan log of " << runDir << std::endl;
+        return -1;
+    }
+    bookie.initGlobalFe(StdDict::getFrontEnd(chipType).release());
+
+    // Keep the scan config used, it may differ from the original one
+    std::ifstream cfgFile(scanType);
+    std::ofstream backupCfgFile(outputDir + std::string(scanLog["testType"]) + ".json");
+    backupCfgFile << cfgFile.rdbuf();
+    backupCfgFile.close();
+    cfgFile.close();
+
+    std::unique_ptr<ScanBase> s;
+    try {
+        s = buildScan(scanType, bookie);
+    } catch (const char *msg) {
+        std::cout << " -> Warning! No scan to re-analyse, exiting with msg: " << msg << std::endl;
+        return 0;
+    }
+    std::map<FrontEnd*, std::unique_ptr<DataProcessor> > analyses;
+    buildAnalyses(analyses, scanType, bookie, s.get(), mask_opt);
+
+    // All FEs in parallel, each thread drives the analysis of its FE
+    std::chrono::steady_clock::time_point ana_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> feeders;
+    for (FrontEnd *fe : bookie.feList) {
+        feeders.emplace_back([&analyses, &runDir, fe] () {
+            std::string name = dynamic_cast<FrontEndCfg*>(fe)->getName();
+            auto &ana = static_cast<Fei4Analysis&>(*analyses.at(fe));
+            std::fstream archive(runDir + name + "_histos.bin", std::fstream::in | std::fstream::binary);
+            if (!archive) {
+                std::cerr << "#ERROR# No histogram archive for " << name << " in " << runDir << std::endl;
+                return;
+            }
+            ana.init();
+            unsigned cnt = 0;
+            while (true) {
+                std::unique_ptr<HistogramBase> h = Fei4Histogrammer::fromArchive(archive);
+                if (h == nullptr)
+                    break;
+                fe->clipHisto->pushData(std::move(h));
+                // Bound the memory held by unprocessed histograms
+                if (++cnt % 64 == 0)
+                    ana.process_core();
+            }
+            ana.process_core();
+            ana.end();
+            std::cout << "-> Re-analysed " << cnt << " histograms of " << name << std::endl;
+        });
+    }
+    for (auto &feeder : feeders) {
+        feeder.join();
+    }
+    std::chrono::steady_clock::time_point ana_done = std::chrono::steady_clock::now();
+    std::cout << "-> Analysis: " << std::chrono::duration_cast<std::chrono::milliseconds>(ana_done-ana_start).count() << " ms" << std::endl;
+    scanLog["stopwatch"]["analysis"] = std::chrono::duration_cast<std::chrono::milliseconds>(ana_done-ana_start).count();
+    scanLog["reanalysis"] = runDir;
+    scanLog["connectivity"] = runLog["connectivity"];
+    scanLog["finishTime"] = (int)std::time(NULL);
+    std::ofstream scanLogFile(outputDir + "scanLog.json");
+    scanLogFile << std::setw(4) << scanLog;
+    scanLogFile.close();
+
+    if (doPlots && system("mkdir -p /tmp/$USER") < 0) {
+        std::cerr << "#ERROR# Problem creating /tmp/$USER folder. Plots might work." << std::endl;
+    }
+
+    // The chip configs of the original run are left alone, changes made by
+    // the analysis (e.g. masks) only go to the output directory
+    for (FrontEnd *fe : bookie.feList) {
+        FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(fe);
+        std::ofstream afterCfgFile(outputDir + feCfg->getConfigFile() + ".after");
+        json afterCfg;
+        feCfg->toFileJson(afterCfg);
+        afterCfgFile << std::setw(4) << afterCfg;
+        afterCfgFile.close();
+
+        auto &output = *fe->clipResult;
+        std::string name = feCfg->getName();
+        while (!output.empty()) {
+            std::unique_ptr<HistogramBase> histo = output.popData();
+            if (doPlots)
+                histo->plot(name, outputDir);
+            histo->toFile(name, outputDir);
+        }
+    }
+    std::cout << "Results in: " << outputDir << std::endl;
+    return 0;
+}
+
+int runWorker(std::unique_ptr<TcpSocket> sock, const std::string &dataDir, bool sharedDir) {
+    RemoteWorker worker(std::move(sock));
+    json setup;
+    if (!worker.receiveSetup(setup)) {
+        std::cerr << "#ERROR# No scan setup from the readout host" << std::endl;
+        return -1;
+    }
+    std::string chipType = setup["chipType"];
+    std::string testType = setup["testType"];
+    int mask_opt = setup["maskOpt"];
+
+    // A local worker writes next to the readout host
+    std::string outputDir = setup["outputDir"];
+    if (!sharedDir) {
+        outputDir = dataDir + toString(setup["runNumber"], 6) + "_" + testType + "/";
+        std::string cmdStr = "mkdir -p " + outputDir;
+        if (system(cmdStr.c_str()) != 0) {
+            std::cerr << "Error creating output directory - histograms might not be saved!" << std::endl;
+        }
+    }
+    std::cout << "-> Processing run " << setup["runNumber"] << " (" << testType << ") in " << outputDir << std::endl;
+
+    Bookkeeper bookie(nullptr, nullptr);
+    bookie.setTargetTot(setup["targetTot"]);
+    bookie.setTargetCharge(setup["targetCharge"]);
+
+    // Changes made by the analyses go back as patches of these
+    std::map<FrontEnd*, json> before;
+    for (auto &chip : setup["chips"]) {
+        bookie.addFe(StdDict::getFrontEnd(chipType).release(), chip["tx"], chip["rx"]);
+        FrontEnd *fe = bookie.getLastFe();
+        fe->setActive(true);
+        FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(fe);
+        feCfg->fromFileJson(chip["config"]);
+        feCfg->toFileJson(before[fe]);
+        std::cout << "-> Processing " << feCfg->getName() << " on channel " << feCfg->getRxChannel() << std::endl;
+    }
+    bookie.initGlobalFe(StdDict::getFrontEnd(chipType).release());
+
+    // The builders read the scan config from a file
+    std::string scanType = outputDir + testType + ".json";
+    std::ofstream scanCfgFile(scanType);
+    scanCfgFile << std::setw(4) << setup["scan"];
+    scanCfgFile.close();
+
+    std::unique_ptr<ScanBase> s;
+    try {
+        s = buildScan(scanType, bookie);
+    } catch (const char *msg) {
+        std::cout << " -> Warning! No scan to process, exiting with msg: " << msg << std::endl;
+        return -1;
+    }
+    std::vector<unsigned> channels;
+    for (FrontEnd *fe : bookie.feList)
+        channels.push_back(dynamic_cast<FrontEndCfg*>(fe)->getRxChannel());
+    worker.relay(s.get(), channels);
+
+    std::map<FrontEnd*, std::unique_ptr<DataProcessor> > histogrammers;
+    std::map<FrontEnd*, std::unique_ptr<DataProcessor> > analyses;
+    buildHistogrammers(histogrammers, scanType, bookie.feList, s.get(), outputDir);
+    buildAnalyses(analyses, scanType, bookie, s.get(), mask_opt);
+
+    // Module histograms only see the FEs of this worker
+    std::unique_ptr<Fei4EventBuilder> builder;
+    std::unique_ptr<Fei4Histogrammer> moduleHistogrammer;
+    std::map<unsigned, ClipBoard<EventDataBase> > builderInput;
+    ClipBoard<EventDataBase> moduleData;
+    ClipBoard<HistogramBase> moduleHisto;
+    buildEventBuilder(builder, moduleHistogrammer, builderInput, moduleData, moduleHisto, scanType, bookie, outputDir);
+
+    for (FrontEnd *fe : bookie.feList) {
+        analyses[fe]->init();
+        analyses[fe]->run();
+        histogrammers[fe]->init();
+        histogrammers[fe]->run();
+    }
+    if (builder) {
+        moduleHistogrammer->init();
+        moduleHistogrammer->run();
+        builder->init();
+        builder->run();
+    }
+    std::shared_ptr<DataProcessor> proc = StdDict::getDataProcessor(chipType);
+    if (builder) {
+        proc->connect(&bookie.rawData, &builderInput);
+    } else {
+        proc->connect(&bookie.rawData, &bookie.eventMap);
+    }
+    proc->init();
+    proc->run();
+
+    bool ok = worker.receiveData(bookie.rawData);
+    if (!ok) {
+        std::cerr << "#ERROR# Lost connection to the readout host, processing what arrived" << std::endl;
+    }
+
+    // Join from upstream to downstream, same as a local scan
+    proc->scanDone = true;
+    bookie.rawData.cv.notify_all();
+    proc->join();
+    if (builder) {
+        builder->scanDone = true;
+        builder->join();
+    }
+    Fei4Histogrammer::processorDone = true;
+    for (FrontEnd *fe : bookie.feList) {
+        fe->clipData->cv.notify_all();
+    }
+    if (moduleHistogrammer) {
+        moduleData.cv.notify_all();
+    }
+    for (auto &histogrammer : histogrammers) {
+        histogrammer.second->join();
+    }
+    if (moduleHistogrammer) {
+        moduleHistogrammer->join();
+    }
+    Fei4Analysis::histogrammerDone = true;
+    for (FrontEnd *fe : bookie.feList) {
+        fe->clipHisto->cv.notify_all();
+    }
+    for (auto &ana : analyses) {
+        ana.second->join();
+    }
+
+    for (FrontEnd *fe : bookie.feList) {
+        FrontEndCfg *feCfg = dynamic_cast<FrontEndCfg*>(fe);
+        auto &output = *fe->clipResult;
+        while (!output.empty()) {
+            std::unique_ptr<HistogramBase> histo = output.popData();
+            worker.sendResult(feCfg->getRxChannel(), *histo);
+        }
+        json after;
+        feCfg->toFileJson(after);
+        json patch = json::diff(before[fe], after);
+        if (!patch.empty())
+            worker.sendConfig(feCfg->getRxChannel(), patch);
+    }
+    if (moduleHistogrammer) {
+        saveModuleHistos(moduleHisto, outputDir, false);
+    }
+    worker.finish();
+    std::cout << "-> Done with run " << setup["runNumber"] << std::endl;
+    return ok ? 0 : -1;
+}
+
+int serveWorker(unsigned port, const std::string &dataDir) {
+    TcpSocket listener;
+    if (!listener.listen(port)) {
+        return -1;
+    }
+    std::cout << "-> Waiting for readout hosts on port " << listener.getPort() << std::endl;
+    while (true) {
+        std::unique_ptr<TcpSocket> sock = listener.accept();
+        if (!sock) {
+            std::cerr << "#ERROR# Could not accept a readout host" << std::endl;
+            return -1;
+        }
+        std::cout << "-> Readout host connected" << std::endl;
+        runWorker(std::move(sock), dataDir, false);
+    }
+    return 0;
+}
@@ -2,9 +2,12 @@
 
 #include <iostream>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <string>
 #include "lmcurve.h"
 #include "Gauss.h"
+#include "ScurveFit.h"
 
 // Errorfunction
 // par[0] = Mean
@@ -15,6 +18,43 @@ double scurve(double x, const double *par) {
     return 0.5*(2-erfc((x-par[0])/(par[1]*SQRT2)))*par[2];
 }
 
+// Accumulates bias and pull of threshold and noise for one fitter
+struct Closure {
+    std::string name;
+    double time = 0;
+    unsigned n = 0;
+    double sum_thr = 0, sum_noise = 0, sum_inj = 0;
+    double sum_bias_thr = 0, sum_bias_noise = 0;
+    double sum_pull_thr = 0, sum_pull2_thr = 0;
+    double sum_pull_noise = 0, sum_pull2_noise = 0;
+
+    void add(const double *par, const double *err, double threshold, double noise) {
+        n++;
+        sum_thr += par[0];
+        sum_noise += par[1];
+        sum_inj += par[2];
+        sum_bias_thr += par[0]-threshold;
+        sum_bias_noise += par[1]-noise;
+        double pull_thr = (par[0]-threshold)/err[0];
+        double pull_noise = (par[1]-noise)/err[1];
+        sum_pull_thr += pull_thr;
+        sum_pull2_thr += pull_thr*pull_thr;
+        sum_pull_noise += pull_noise;
+        sum_pull2_noise += pull_noise*pull_noise;
+    }
+
+    void print() {
+        double mean_pull_thr = sum_pull_thr/n;
+        double mean_pull_noise = sum_pull_noise/n;
+        std::cout << name << ":" << std::endl;
+        std::cout << "  Final mean afer [" << n << "] samples: \t" << sum_thr/n << "\t" << sum_noise/n << "\t" << sum_inj/n << std::endl;
+        std::cout << "  Time per fit [us]: " << time/n << std::endl;
+        std::cout << "  Bias threshold: " << sum_bias_thr/n << "\t noise: " << sum_bias_noise/n << std::endl;
+        std::cout << "  Pull threshold: " << mean_pull_thr << " +- " << sqrt(sum_pull2_thr/n - mean_pull_thr*mean_pull_thr)
+            << "\t noise: " << mean_pull_noise << " +- " << sqrt(sum_pull2_noise/n - mean_pull_noise*mean_pull_noise) << std::endl;
+    }
+};
+
 int main(int argc, char* argv[]) {
 
     // Generate samples
@@ -27,8 +67,8 @@ int main(int argc, char* argv[]) {
             sample[i][j] = 0;
         }
     }
-    
-    
+
+
     std::array<double, steps> x;
     for (unsigned i=0; i<steps; i++) {
         x[i] = i*step_size;
@@ -56,10 +96,9 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    // Loop over samples and fit distribution
-    double sum_thr = 0;
-    double sum_noise = 0;
-    double sum_inj = 0;
+    // Loop over samples and fit distribution with lmmin
+    Closure lm;
+    lm.name = "lmcurve (numeric Jacobian)";
     for (unsigned i=0; i<n_samples; i++) {
         // Prepare fitting
         lm_status_struct status;
@@ -67,16 +106,75 @@ int main(int argc, char* argv[]) {
         control = lm_control_float;
         control.verbosity = 0;
         double par[3] = {100, 5, 50};
+        double err[3];
         // Do fit
+        auto start = std::chrono::high_resolution_clock::now();
         lmcurve(3, par, steps, &x[0], &sample[i][0], scurve, &control, &status);
+        auto end = std::chrono::high_resolution_clock::now();
+        lm.time += std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count()/1000.0;
         //std::cout << par[0] << " " << par[1] << " " << par[2] << std::endl;
-        sum_thr += par[0];
-        sum_noise += par[1];
-        sum_inj += par[2];
+        ScurveFit::errors(steps, &x[0], par, err);
+        lm.add(par, err, threshold, noise);
         if (i%10==0 && i>0) {
-            std::cout << "Mean afer [" << i+1 << "] samples: \t" << sum_thr/(double)(i+1) << "\t" << sum_noise/(double)(i+1) << "\t" << sum_inj/(double)(i+1) << std::endl;
+            std::cout << "Mean afer [" << i+1 << "] samples: \t" << lm.sum_thr/(double)(i+1) << "\t" << lm.sum_noise/(double)(i+1) << "\t" << lm.sum_inj/(double)(i+1) << std::endl;
+        }
+    }
+
+    // Same samples with the dedicated fitter, one by one and batched
+    Closure sf;
+    sf.name = "ScurveFit (analytic Jacobian)";
+    for (unsigned i=0; i<n_samples; i++) {
+        ScurveFit::Status status;
+        double par[3];
+        double err[3];
+        auto start = std::chrono::high_resolution_clock::now();
+        ScurveFit::guess(steps, &x[0], &sample[i][0], n_injections, par);
+        ScurveFit::fit(steps, &x[0], &sample[i][0], par, ScurveFit::defaultControl, status);
+        auto end = std::chrono::high_resolution_clock::now();
+        sf.time += std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count()/1000.0;
+        ScurveFit::errors(steps, &x[0], par, err);
+        sf.add(par, err, threshold, noise);
+    }
+
+    Closure sfFix;
+    sfFix.name = "ScurveFit (fixed normalisation)";
+    ScurveFit::Control fixControl = ScurveFit::defaultControl;
+    fixControl.fixNorm = true;
+    for (unsigned i=0; i<n_samples; i++) {
+        ScurveFit::Status status;
+        double par[3];
+        double err[3];
+        auto start = std::chrono::high_resolution_clock::now();
+        ScurveFit::guess(steps, &x[0], &sample[i][0], n_injections, par);
+        ScurveFit::fit(steps, &x[0], &sample[i][0], par, fixControl, status);
+        auto end = std::chrono::high_resolution_clock::now();
+        sfFix.time += std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count()/1000.0;
+        ScurveFit::errors(steps, &x[0], par, err);
+        sfFix.add(par, err, threshold, noise);
+    }
+
+    Closure sfBatch;
+    sfBatch.name = "ScurveFit (batched)";
+    {
+        std::array<double, 3*n_samples> par;
+        std::array<ScurveFit::Status, n_samples> status;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (unsigned i=0; i<n_samples; i++) {
+            ScurveFit::guess(steps, &x[0], &sample[i][0], n_injections, &par[3*i]);
+        }
+        ScurveFit::fitBatch(n_samples, steps, &x[0], &sample[0][0], &par[0], ScurveFit::defaultControl, &status[0]);
+        auto end = std::chrono::high_resolution_clock::now();
+        sfBatch.time = std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count()/1000.0;
+        for (unsigned i=0; i<n_samples; i++) {
+            double err[3];
+            ScurveFit::errors(steps, &x[0], &par[3*i], err);
+            sfBatch.add(&par[3*i], err, threshold, noise);
         }
     }
-    std::cout << "Final mean afer [" << n_samples << "] samples: \t" << sum_thr/(double)n_samples << "\t" << sum_noise/(double)n_samples << "\t" << sum_inj/(double)n_samples << std::endl;
+
+    lm.print();
+    sf.print();
+    sfFix.print();
+    sfBatch.print();
     return 0;
 }